@@ -0,0 +1,33 @@
+#include "benchmark.h"
+
+#include <pangolin/plot/datalog.h>
+
+using namespace pangolin;
+
+PANGOLIN_BENCHMARK(DataLog_Log_4)
+{
+    DataLog log;
+    float v[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+
+    b.SetBytesPerIteration(sizeof(v));
+    while(b.KeepRunning()) {
+        log.Log(4, v);
+        v[0] += 1.0f;
+    }
+}
+
+PANGOLIN_BENCHMARK(DataLog_Sample)
+{
+    const size_t samples = 1000000;
+    DataLog log;
+    for(size_t i=0; i < samples; ++i) {
+        log.Log((float)i, (float)i, (float)i, (float)i);
+    }
+
+    // Deterministic scattered access pattern
+    size_t n = 0;
+    while(b.KeepRunning()) {
+        n = (n + 7919) % samples;
+        DoNotOptimize(log.Sample((int)n));
+    }
+}
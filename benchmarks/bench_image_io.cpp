@@ -0,0 +1,116 @@
+#include "benchmark.h"
+
+#include <pangolin/image/image_io.h>
+
+#include <cstdio>
+
+#ifdef BENCHMARK_HAVE_JPEG
+extern "C" {
+#include <jpeglib.h>
+}
+#endif
+
+using namespace pangolin;
+
+const size_t bench_image_w = 640;
+const size_t bench_image_h = 480;
+
+// Smooth gradient with some noise, so codecs see something camera-like
+TypedImage MakeSyntheticRgb(size_t w, size_t h)
+{
+    TypedImage img;
+    img.Alloc(w, h, VideoFormatFromString("RGB24"));
+    std::vector<unsigned char> noise(img.pitch * h);
+    FillSynthetic(&noise[0], noise.size());
+    for(size_t y=0; y < h; ++y) {
+        unsigned char* row = img.RowPtr(y);
+        for(size_t x=0; x < w; ++x) {
+            row[3*x+0] = (unsigned char)(x + (noise[y*img.pitch + 3*x+0] & 7));
+            row[3*x+1] = (unsigned char)(y + (noise[y*img.pitch + 3*x+1] & 7));
+            row[3*x+2] = (unsigned char)(x + y + (noise[y*img.pitch + 3*x+2] & 7));
+        }
+    }
+    return img;
+}
+
+PANGOLIN_BENCHMARK(SavePng_640x480_RGB24)
+{
+    BenchmarkTempFile tmp("savepng");
+    TypedImage img = MakeSyntheticRgb(bench_image_w, bench_image_h);
+
+    b.SetBytesPerIteration(img.SizeBytes());
+    try {
+        while(b.KeepRunning()) {
+            SavePng(img, img.fmt, tmp.filename);
+        }
+    }catch(...) {
+        img.Dealloc();
+        throw;
+    }
+    img.Dealloc();
+}
+
+PANGOLIN_BENCHMARK(LoadPng_640x480_RGB24)
+{
+    BenchmarkTempFile tmp("loadpng");
+    TypedImage img = MakeSyntheticRgb(bench_image_w, bench_image_h);
+    try {
+        SavePng(img, img.fmt, tmp.filename);
+    }catch(...) {
+        img.Dealloc();
+        throw;
+    }
+
+    b.SetBytesPerIteration(img.SizeBytes());
+    img.Dealloc();
+
+    while(b.KeepRunning()) {
+        TypedImage loaded = LoadPng(tmp.filename);
+        loaded.Dealloc();
+    }
+}
+
+#ifdef BENCHMARK_HAVE_JPEG
+void WriteJpg(const TypedImage& img, const std::string& filename, int quality)
+{
+    FILE* file = fopen(filename.c_str(), "wb");
+    if(!file) {
+        throw std::runtime_error("Unable to open '" + filename + "' for writing");
+    }
+
+    jpeg_compress_struct cinfo;
+    jpeg_error_mgr jerr;
+    cinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_compress(&cinfo);
+    jpeg_stdio_dest(&cinfo, file);
+    cinfo.image_width = (JDIMENSION)img.w;
+    cinfo.image_height = (JDIMENSION)img.h;
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, quality, TRUE);
+    jpeg_start_compress(&cinfo, TRUE);
+    while(cinfo.next_scanline < cinfo.image_height) {
+        JSAMPROW row = (JSAMPROW)(img.ptr + cinfo.next_scanline * img.pitch);
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+    fclose(file);
+}
+
+PANGOLIN_BENCHMARK(LoadJpg_640x480_RGB24)
+{
+    BenchmarkTempFile tmp("loadjpg");
+    TypedImage img = MakeSyntheticRgb(bench_image_w, bench_image_h);
+    WriteJpg(img, tmp.filename, 90);
+
+    b.SetBytesPerIteration(img.SizeBytes());
+    img.Dealloc();
+
+    while(b.KeepRunning()) {
+        TypedImage loaded = LoadJpg(tmp.filename);
+        loaded.Dealloc();
+    }
+}
+#endif // BENCHMARK_HAVE_JPEG
@@ -0,0 +1,101 @@
+#include "benchmark.h"
+
+#include <pangolin/log/packetstream.h>
+#include <pangolin/utils/threadedfilebuf.h>
+
+using namespace pangolin;
+
+const unsigned int bench_buffer_bytes = 10000000;
+
+void BenchThreadedFileBuf(Benchmark& b, size_t write_bytes)
+{
+    BenchmarkTempFile tmp("threadedfilebuf");
+    std::vector<char> data(write_bytes);
+    FillSynthetic((unsigned char*)&data[0], data.size());
+
+    threadedfilebuf buf(tmp.filename, bench_buffer_bytes);
+    std::ostream os(&buf);
+
+    b.SetBytesPerIteration(write_bytes);
+    while(b.KeepRunning()) {
+        os.write(&data[0], data.size());
+    }
+}
+
+PANGOLIN_BENCHMARK(threadedfilebuf_write_16B)
+{
+    BenchThreadedFileBuf(b, 16);
+}
+
+PANGOLIN_BENCHMARK(threadedfilebuf_write_1MB)
+{
+    BenchThreadedFileBuf(b, 1 << 20);
+}
+
+void BenchPacketWriter(Benchmark& b, size_t packet_bytes, bool fixed_size)
+{
+    BenchmarkTempFile tmp("packetwriter");
+    std::vector<char> data(packet_bytes);
+    FillSynthetic((unsigned char*)&data[0], data.size());
+
+    PacketStreamWriter writer(tmp.filename, bench_buffer_bytes);
+    const PacketStreamSourceId id = writer.AddSource("bench", "bench://", json::value(), fixed_size ? packet_bytes : 0);
+
+    b.SetBytesPerIteration(packet_bytes);
+    while(b.KeepRunning()) {
+        writer.WriteSourcePacket(id, &data[0], data.size());
+    }
+}
+
+PANGOLIN_BENCHMARK(PacketStreamWriter_WriteSourcePacket_64B)
+{
+    BenchPacketWriter(b, 64, true);
+}
+
+PANGOLIN_BENCHMARK(PacketStreamWriter_WriteSourcePacket_64B_var)
+{
+    BenchPacketWriter(b, 64, false);
+}
+
+PANGOLIN_BENCHMARK(PacketStreamWriter_WriteSourcePacket_1MB)
+{
+    BenchPacketWriter(b, 1 << 20, true);
+}
+
+void BenchPacketReader(Benchmark& b, size_t packet_bytes, size_t num_packets)
+{
+    BenchmarkTempFile tmp("packetreader");
+    std::vector<char> data(packet_bytes);
+    FillSynthetic((unsigned char*)&data[0], data.size());
+
+    {
+        PacketStreamWriter writer(tmp.filename, bench_buffer_bytes);
+        const PacketStreamSourceId id = writer.AddSource("bench", "bench://", json::value(), packet_bytes);
+        for(size_t i=0; i < num_packets; ++i) {
+            writer.WriteSourcePacket(id, &data[0], data.size());
+        }
+    }
+
+    PacketStreamReader reader(tmp.filename, false);
+
+    b.SetBytesPerIteration(packet_bytes);
+    while(b.KeepRunning()) {
+        if(!reader.ReadToSourcePacketAndLock(0)) {
+            // Start again from beginning of log
+            reader.Open(tmp.filename, false);
+            reader.ReadToSourcePacketAndLock(0);
+        }
+        reader.Read(&data[0], data.size());
+        reader.ReleaseSourcePacketLock(0);
+    }
+}
+
+PANGOLIN_BENCHMARK(PacketStreamReader_Read_64B)
+{
+    BenchPacketReader(b, 64, 100000);
+}
+
+PANGOLIN_BENCHMARK(PacketStreamReader_Read_1MB)
+{
+    BenchPacketReader(b, 1 << 20, 64);
+}
@@ -0,0 +1,95 @@
+#include "benchmark.h"
+
+#include <pangolin/image/image_common.h>
+
+// Library internal kernels, exported for benchmarking
+#include <image/image_convert_kernels.h>
+#include <video/drivers/driver_kernels.h>
+
+using namespace pangolin;
+
+// Typical machine vision sensor resolution
+const size_t bench_w = 1280;
+const size_t bench_h = 1024;
+
+PANGOLIN_BENCHMARK(DownsampleDebayer)
+{
+    std::vector<unsigned char> in(bench_w*bench_h), out(bench_w*bench_h*3/4);
+    FillSynthetic(&in[0], in.size());
+    Image<unsigned char> img_in(bench_w, bench_h, bench_w, &in[0]);
+    Image<unsigned char> img_out(bench_w/2, bench_h/2, 3*bench_w/2, &out[0]);
+
+    b.SetBytesPerIteration(in.size());
+    while(b.KeepRunning()) {
+        DownsampleDebayer(img_out, img_in);
+        DoNotOptimize(out[0]);
+    }
+}
+
+template<typename T, size_t bits>
+void BenchUnpack(Benchmark& b)
+{
+    const size_t pitch_in = bench_w * bits / 8;
+    std::vector<unsigned char> in(pitch_in*bench_h), out(bench_w*bench_h*sizeof(T));
+    FillSynthetic(&in[0], in.size());
+    Image<unsigned char> img_in(bench_w, bench_h, pitch_in, &in[0]);
+    Image<unsigned char> img_out(bench_w, bench_h, bench_w*sizeof(T), &out[0]);
+
+    b.SetBytesPerIteration(in.size());
+    while(b.KeepRunning()) {
+        if(bits == 10) {
+            ConvertFrom10bit<T>(img_out, img_in);
+        }else{
+            ConvertFrom12bit<T>(img_out, img_in);
+        }
+        DoNotOptimize(out[0]);
+    }
+}
+
+PANGOLIN_BENCHMARK(ConvertFrom10bit_uint16)
+{
+    BenchUnpack<uint16_t,10>(b);
+}
+
+PANGOLIN_BENCHMARK(ConvertFrom10bit_float)
+{
+    BenchUnpack<float,10>(b);
+}
+
+PANGOLIN_BENCHMARK(ConvertFrom12bit_uint16)
+{
+    BenchUnpack<uint16_t,12>(b);
+}
+
+PANGOLIN_BENCHMARK(ConvertFrom12bit_float)
+{
+    BenchUnpack<float,12>(b);
+}
+
+PANGOLIN_BENCHMARK(DoShift16to8)
+{
+    std::vector<unsigned char> in(bench_w*bench_h*2), out(bench_w*bench_h);
+    FillSynthetic(&in[0], in.size());
+    Image<unsigned char> img_in(bench_w, bench_h, bench_w*2, &in[0]);
+    Image<unsigned char> img_out(bench_w, bench_h, bench_w, &out[0]);
+
+    b.SetBytesPerIteration(in.size());
+    while(b.KeepRunning()) {
+        DoShift16to8(img_out, img_in, 4, 0xffff);
+        DoNotOptimize(out[0]);
+    }
+}
+
+PANGOLIN_BENCHMARK(VideoFormatFromString_first)
+{
+    while(b.KeepRunning()) {
+        DoNotOptimize(VideoFormatFromString("GRAY8"));
+    }
+}
+
+PANGOLIN_BENCHMARK(VideoFormatFromString_last)
+{
+    while(b.KeepRunning()) {
+        DoNotOptimize(VideoFormatFromString("RGB96F"));
+    }
+}
@@ -0,0 +1,114 @@
+#ifndef PANGOLIN_BENCHMARK_H
+#define PANGOLIN_BENCHMARK_H
+
+#include <pangolin/platform.h>
+#include <pangolin/utils/timer.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace pangolin
+{
+
+//! Timing state passed to each benchmark. Work before the first call to
+//! KeepRunning() is setup and isn't timed.
+//!
+//!   while(b.KeepRunning()) { ... }
+class Benchmark
+{
+public:
+    Benchmark(size_t iterations)
+        : iterations(iterations), count(0), bytes_per_iteration(0), elapsed_us(0)
+    {
+    }
+
+    inline bool KeepRunning()
+    {
+        if(count == 0) {
+            start = TimeNow();
+        }
+        if(count == iterations) {
+            elapsed_us = TimeDiff_us(start, TimeNow());
+            return false;
+        }
+        ++count;
+        return true;
+    }
+
+    //! Bytes processed each iteration, used to report throughput
+    void SetBytesPerIteration(size_t bytes) { bytes_per_iteration = bytes; }
+
+    size_t Iterations() const { return iterations; }
+    size_t BytesPerIteration() const { return bytes_per_iteration; }
+    int64_t Elapsed_us() const { return elapsed_us; }
+
+protected:
+    size_t iterations;
+    size_t count;
+    size_t bytes_per_iteration;
+    basetime start;
+    int64_t elapsed_us;
+};
+
+typedef void (*BenchmarkFunction)(Benchmark&);
+
+struct BenchmarkEntry
+{
+    std::string name;
+    BenchmarkFunction func;
+};
+
+inline std::vector<BenchmarkEntry>& Benchmarks()
+{
+    static std::vector<BenchmarkEntry> benchmarks;
+    return benchmarks;
+}
+
+struct BenchmarkRegistrar
+{
+    BenchmarkRegistrar(const std::string& name, BenchmarkFunction func)
+    {
+        BenchmarkEntry e = {name, func};
+        Benchmarks().push_back(e);
+    }
+};
+
+//! Repeatable pseudo-random bytes (xorshift)
+inline void FillSynthetic(unsigned char* data, size_t n, uint64_t seed = 0x2545F4914F6CDD1Dull)
+{
+    uint64_t x = seed;
+    for(size_t i=0; i < n; ++i) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        data[i] = (unsigned char)x;
+    }
+}
+
+//! Temporary file in working directory, removed on destruction
+struct BenchmarkTempFile
+{
+    BenchmarkTempFile(const std::string& name) : filename("pangolin_bench_" + name + ".tmp") {}
+    ~BenchmarkTempFile() { std::remove(filename.c_str()); }
+    std::string filename;
+};
+
+// Prevent compiler from eliding computation of value
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(_GCC_) || defined(_CLANG_)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    volatile const T* p = &value; (void)p;
+#endif
+}
+
+}
+
+#define PANGOLIN_BENCHMARK(name) \
+    static void name(pangolin::Benchmark&); \
+    static pangolin::BenchmarkRegistrar name##_registrar(#name, name); \
+    static void name(pangolin::Benchmark& b)
+
+#endif // PANGOLIN_BENCHMARK_H
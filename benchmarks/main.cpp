@@ -0,0 +1,58 @@
+#include "benchmark.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+// Run each benchmark until it has taken at least this long
+const int64_t min_time_us = 200000;
+
+void RunBenchmark(const pangolin::BenchmarkEntry& e)
+{
+    size_t iterations = 1;
+    while(true) {
+        pangolin::Benchmark b(iterations);
+        e.func(b);
+
+        const int64_t us = std::max(b.Elapsed_us(), (int64_t)1);
+        if(us >= min_time_us || iterations >= 1000000000) {
+            const double ns_per_op = 1000.0 * us / iterations;
+            std::cout << std::left << std::setw(48) << e.name << std::right
+                      << std::setw(12) << iterations
+                      << std::setw(14) << std::fixed << std::setprecision(1) << ns_per_op << " ns/op";
+            if(b.BytesPerIteration()) {
+                const double gbps = (double)b.BytesPerIteration() * iterations / (us * 1000.0);
+                std::cout << std::setw(10) << std::setprecision(3) << gbps << " GB/s";
+            }
+            std::cout << std::endl;
+            return;
+        }
+
+        // Grow towards target time, without overshooting wildly
+        const double scale = std::min(10.0, std::max(2.0, 1.4 * min_time_us / us));
+        iterations = (size_t)(iterations * scale);
+    }
+}
+
+int main( int argc, char* argv[] )
+{
+    // Optional arguments select benchmarks whose name contains them
+    std::vector<pangolin::BenchmarkEntry>& benchmarks = pangolin::Benchmarks();
+
+    for(size_t i=0; i < benchmarks.size(); ++i) {
+        bool selected = (argc <= 1);
+        for(int a=1; a < argc; ++a) {
+            selected |= benchmarks[i].name.find(argv[a]) != std::string::npos;
+        }
+        if(selected) {
+            try {
+                RunBenchmark(benchmarks[i]);
+            }catch(const std::exception& e) {
+                std::cout << std::left << std::setw(48) << benchmarks[i].name << "skipped: " << e.what() << std::endl;
+            }
+        }
+    }
+
+    return 0;
+}
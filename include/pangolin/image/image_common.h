@@ -34,6 +34,7 @@
 #include <exception>
 #include <string>
 #include <map>
+#include <stdint.h>
 
 namespace pangolin
 {
@@ -78,11 +79,71 @@ struct PANGOLIN_EXPORT ImageRoi
     size_t w; size_t h;
 };
 
+//! Identifies each entry of the supported pixel format table, so that
+//! code can switch on or index by format instead of comparing strings.
+//! Order must match SupportedVideoPixelFormats in image_common.cpp.
+enum PixelFormatId
+{
+    PixelFormatGray8 = 0,
+    PixelFormatGray10,
+    PixelFormatGray12,
+    PixelFormatGray16LE,
+    PixelFormatY400A,
+    PixelFormatRgb24,
+    PixelFormatBgr24,
+    PixelFormatYuyv422,
+    PixelFormatRgba,
+    PixelFormatGray32F,
+    PixelFormatRgb96F,
+    PixelFormatCount,
+    PixelFormatUnknown = PixelFormatCount
+};
+
+//! Compile-time properties of pixel format F, matching its VideoPixelFormat.
+//! channel_type is the unpacked type of a single channel.
+template<PixelFormatId F>
+struct PixelFormatTraits;
+
+#define PANGOLIN_PIXEL_FORMAT_TRAITS(id, name, nchannels, nbpp, T) \
+    template<> struct PixelFormatTraits<id> { \
+        typedef T channel_type; \
+        static const unsigned int channels = nchannels; \
+        static const unsigned int bpp = nbpp; \
+        static const bool packed = (nbpp % (8*nchannels)) != 0; \
+        static const char* Name() { return name; } \
+    };
+
+PANGOLIN_PIXEL_FORMAT_TRAITS(PixelFormatGray8,    "GRAY8",    1,  8, uint8_t)
+PANGOLIN_PIXEL_FORMAT_TRAITS(PixelFormatGray10,   "GRAY10",   1, 10, uint16_t)
+PANGOLIN_PIXEL_FORMAT_TRAITS(PixelFormatGray12,   "GRAY12",   1, 12, uint16_t)
+PANGOLIN_PIXEL_FORMAT_TRAITS(PixelFormatGray16LE, "GRAY16LE", 1, 16, uint16_t)
+PANGOLIN_PIXEL_FORMAT_TRAITS(PixelFormatY400A,    "Y400A",    2, 16, uint8_t)
+PANGOLIN_PIXEL_FORMAT_TRAITS(PixelFormatRgb24,    "RGB24",    3, 24, uint8_t)
+PANGOLIN_PIXEL_FORMAT_TRAITS(PixelFormatBgr24,    "BGR24",    3, 24, uint8_t)
+PANGOLIN_PIXEL_FORMAT_TRAITS(PixelFormatYuyv422,  "YUYV422",  3, 16, uint8_t)
+PANGOLIN_PIXEL_FORMAT_TRAITS(PixelFormatRgba,     "RGBA",     4, 32, uint8_t)
+PANGOLIN_PIXEL_FORMAT_TRAITS(PixelFormatGray32F,  "GRAY32F",  1, 32, float)
+PANGOLIN_PIXEL_FORMAT_TRAITS(PixelFormatRgb96F,   "RGB96F",   3, 96, float)
+
+#undef PANGOLIN_PIXEL_FORMAT_TRAITS
+
 //! Return Pixel Format properties given string specification in
 //! FFMPEG notation.
 PANGOLIN_EXPORT
 VideoPixelFormat VideoFormatFromString(const std::string& format);
 
+//! Return PixelFormatId for string specification, or PixelFormatUnknown.
+PANGOLIN_EXPORT
+PixelFormatId PixelFormatIdFromString(const std::string& format);
+
+//! Return PixelFormatId of fmt, or PixelFormatUnknown.
+PANGOLIN_EXPORT
+PixelFormatId PixelFormatIdFromFormat(const VideoPixelFormat& fmt);
+
+//! Return Pixel Format properties of table entry id.
+PANGOLIN_EXPORT
+const VideoPixelFormat& VideoFormatFromId(PixelFormatId id);
+
 }
 
 #endif // PANGOLIN_IMAGE_COMMON_H
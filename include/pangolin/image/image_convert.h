@@ -0,0 +1,59 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef PANGOLIN_IMAGE_CONVERT_H
+#define PANGOLIN_IMAGE_CONVERT_H
+
+#include <pangolin/platform.h>
+#include <pangolin/image/image.h>
+#include <pangolin/image/image_common.h>
+
+namespace pangolin
+{
+
+//! Convert pixels of in into out. Both images have the same width and
+//! height; formats are implied by the table entry the kernel is registered at.
+typedef void (*PixelConvertFunc)(Image<unsigned char>& out, const Image<unsigned char>& in);
+
+//! Register (or replace) the kernel converting src pixels into dst pixels.
+//! Pass func = 0 to remove a conversion. Thread safe.
+PANGOLIN_EXPORT
+void RegisterPixelConversion(PixelFormatId src, PixelFormatId dst, PixelConvertFunc func);
+
+//! Return kernel converting src pixels into dst pixels, or 0 if there is none.
+//! Intended to be resolved once, when a pipeline is constructed, rather than per frame.
+PANGOLIN_EXPORT
+PixelConvertFunc FindPixelConversion(PixelFormatId src, PixelFormatId dst);
+
+//! As above, for table formats given by VideoPixelFormat.
+PANGOLIN_EXPORT
+PixelConvertFunc FindPixelConversion(const VideoPixelFormat& src, const VideoPixelFormat& dst);
+
+}
+
+#endif // PANGOLIN_IMAGE_CONVERT_H
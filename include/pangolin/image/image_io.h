@@ -31,6 +31,8 @@
 #include <pangolin/image/image.h>
 #include <pangolin/image/image_common.h>
 #include <pangolin/utils/file_extension.h>
+#include <iosfwd>
+#include <vector>
 
 namespace pangolin {
 
@@ -61,18 +63,175 @@ struct TypedImage : public Image<unsigned char>
     VideoPixelFormat fmt;
 };
 
+//! Options for decoders which can trade quality or resolution for speed
+struct PANGOLIN_EXPORT ImageLoadOptions
+{
+    ImageLoadOptions()
+        : scale_num(1), scale_denom(1), fast_dct(false)
+    {
+    }
+
+    //! Decode JPEG at scale_num/scale_denom of full size within the IDCT.
+    //! libjpeg supports 1/1, 1/2, 1/4 and 1/8 (libjpeg-turbo any N/8).
+    //! Other formats are always loaded at full size.
+    unsigned int scale_num;
+    unsigned int scale_denom;
+
+    //! Use fast, less accurate integer IDCT and upsampling for JPEG
+    bool fast_dct;
+};
+
+PANGOLIN_EXPORT
+TypedImage LoadTga(const std::string& filename);
+
+PANGOLIN_EXPORT
+TypedImage LoadPng(const std::string& filename);
+
+PANGOLIN_EXPORT
+TypedImage LoadPng(std::istream& in);
+
+//! Decode PNG into existing image dst, which must match in size and format.
+//! Rows are written using dst.pitch.
+PANGOLIN_EXPORT
+void LoadPng(std::istream& in, Image<unsigned char>& dst, const VideoPixelFormat& fmt);
+
+PANGOLIN_EXPORT
+TypedImage LoadJpg(const std::string& filename);
+
+PANGOLIN_EXPORT
+TypedImage LoadJpg(std::istream& in);
+
+PANGOLIN_EXPORT
+TypedImage LoadJpg(std::istream& in, const ImageLoadOptions& options);
+
+//! Decode JPEG into existing image dst, which must match in size and format.
+PANGOLIN_EXPORT
+void LoadJpg(std::istream& in, Image<unsigned char>& dst, const VideoPixelFormat& fmt);
+
+//! Load binary PGM (8 or 16 bit), PPM or PFM (float) image
+PANGOLIN_EXPORT
+TypedImage LoadPpm(const std::string& filename);
+
+PANGOLIN_EXPORT
+TypedImage LoadPpm(std::istream& in);
+
+//! Strips or tiles are decoded in parallel on DefaultThreadPool()
+PANGOLIN_EXPORT
+TypedImage LoadTiff(const std::string& filename);
+
+//! Loads float EXR channels as GRAY32F or RGB96F
+PANGOLIN_EXPORT
+TypedImage LoadExr(const std::string& filename);
+
+PANGOLIN_EXPORT
+TypedImage LoadExr(std::istream& in);
+
+PANGOLIN_EXPORT
+void SavePng(const Image<unsigned char>& image, const pangolin::VideoPixelFormat& fmt, const std::string& filename, bool top_line_first = true);
+
+//! Row filters the PNG encoder may choose between (values match libpng's
+//! PNG_FILTER_* flags). Fewer filters encode faster but compress less.
+enum PngFilter
+{
+    PngFilterNone  = 0x08,
+    PngFilterSub   = 0x10,
+    PngFilterUp    = 0x20,
+    PngFilterAvg   = 0x40,
+    PngFilterPaeth = 0x80,
+    PngFilterAll   = 0xF8
+};
+
+//! zlib_compression_level in [0,9], or -1 for libpng default
+//! png_filters is a combination of PngFilter flags, or -1 for libpng default
+PANGOLIN_EXPORT
+void SavePng(const Image<unsigned char>& image, const pangolin::VideoPixelFormat& fmt, std::ostream& out, bool top_line_first = true, int zlib_compression_level = -1, int png_filters = -1);
+
+//! Save GRAY8 or RGB24 image with quality in [0,100]
+PANGOLIN_EXPORT
+void SaveJpg(const Image<unsigned char>& image, const pangolin::VideoPixelFormat& fmt, const std::string& filename, int quality = 90, bool top_line_first = true);
+
+PANGOLIN_EXPORT
+void SaveJpg(const Image<unsigned char>& image, const pangolin::VideoPixelFormat& fmt, std::ostream& out, int quality = 90, bool top_line_first = true);
+
+//! Save GRAY8, GRAY16LE or RGB24 image as binary PGM / PPM, or
+//! GRAY32F / RGB96F image as PFM
+PANGOLIN_EXPORT
+void SavePpm(const Image<unsigned char>& image, const pangolin::VideoPixelFormat& fmt, const std::string& filename, bool top_line_first = true);
+
+PANGOLIN_EXPORT
+void SavePpm(const Image<unsigned char>& image, const pangolin::VideoPixelFormat& fmt, std::ostream& out, bool top_line_first = true);
+
+PANGOLIN_EXPORT
+void SaveExr(const Image<unsigned char>& image, const pangolin::VideoPixelFormat& fmt, const std::string& filename, bool top_line_first = true);
+
+//! Save GRAY8, GRAY16LE, Y400A, RGB24, RGBA, GRAY32F or RGB96F image
+PANGOLIN_EXPORT
+void SaveTiff(const Image<unsigned char>& image, const pangolin::VideoPixelFormat& fmt, const std::string& filename, bool top_line_first = true);
+
+//! out must be seekable
+PANGOLIN_EXPORT
+void SaveExr(const Image<unsigned char>& image, const pangolin::VideoPixelFormat& fmt, std::ostream& out, bool top_line_first = true);
+
 PANGOLIN_EXPORT
 TypedImage LoadImage(const std::string& filename, ImageFileType file_type);
 
 PANGOLIN_EXPORT
 TypedImage LoadImage(const std::string& filename);
 
+//! Decode image file into existing image dst without allocating.
+//! dst must match the file in size and format, throws otherwise.
+PANGOLIN_EXPORT
+void LoadImage(const std::string& filename, Image<unsigned char>& dst, const VideoPixelFormat& fmt, ImageFileType file_type);
+
+PANGOLIN_EXPORT
+void LoadImage(const std::string& filename, Image<unsigned char>& dst, const VideoPixelFormat& fmt);
+
+//! Read only the header of image file. Returned image has null ptr
+//! and a pitch equal to its packed row size.
+PANGOLIN_EXPORT
+TypedImage ProbeImage(const std::string& filename, ImageFileType file_type);
+
+PANGOLIN_EXPORT
+TypedImage ProbeImage(const std::string& filename);
+
+//! Variants which pass options to the decoder, e.g. to load JPEG previews
+//! at reduced resolution. Probe with the same options to get the size.
+PANGOLIN_EXPORT
+TypedImage LoadImage(const std::string& filename, const ImageLoadOptions& options);
+
+PANGOLIN_EXPORT
+void LoadImage(const std::string& filename, Image<unsigned char>& dst, const VideoPixelFormat& fmt, const ImageLoadOptions& options);
+
+PANGOLIN_EXPORT
+TypedImage ProbeImage(const std::string& filename, const ImageLoadOptions& options);
+
+//! Decode image held in memory, e.g. a packet payload or mmapped file.
+PANGOLIN_EXPORT
+TypedImage LoadImage(const unsigned char* data, size_t size_bytes, ImageFileType file_type);
+
+//! Decode image held in memory, detecting its type from magic bytes.
+PANGOLIN_EXPORT
+TypedImage LoadImage(const unsigned char* data, size_t size_bytes);
+
+PANGOLIN_EXPORT
+void LoadImage(const unsigned char* data, size_t size_bytes, Image<unsigned char>& dst, const VideoPixelFormat& fmt);
+
+PANGOLIN_EXPORT
+void SaveImage(const Image<unsigned char>& image, const pangolin::VideoPixelFormat& fmt, const std::string& filename, ImageFileType file_type, bool top_line_first = true);
+
 PANGOLIN_EXPORT
 void SaveImage(const Image<unsigned char>& image, const pangolin::VideoPixelFormat& fmt, const std::string& filename, bool top_line_first = true);
 
 PANGOLIN_EXPORT
 void SaveImage(const TypedImage& image, const std::string& filename, bool top_line_first = true);
 
+//! Encode image, appending it to out.
+PANGOLIN_EXPORT
+void SaveImage(const Image<unsigned char>& image, const pangolin::VideoPixelFormat& fmt, std::vector<unsigned char>& out, ImageFileType file_type, bool top_line_first = true);
+
+PANGOLIN_EXPORT
+void SaveImage(const TypedImage& image, std::vector<unsigned char>& out, ImageFileType file_type, bool top_line_first = true);
+
 PANGOLIN_EXPORT
 void FreeImage(TypedImage& img);
 
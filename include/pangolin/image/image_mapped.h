@@ -0,0 +1,83 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef PANGOLIN_IMAGE_MAPPED_H
+#define PANGOLIN_IMAGE_MAPPED_H
+
+#include <pangolin/image/image_io.h>
+
+#include <string>
+
+namespace pangolin
+{
+
+//! Read-only image whose pixels point straight into a memory mapped raw
+//! binary PGM, PPM or PFM file, so no copy is made. This is only possible
+//! when the data is stored in host byte order and the header length leaves
+//! it aligned for its type. Otherwise, which includes all 16 bit PGM on
+//! little endian hosts, pixels are read into memory as by LoadImage, with
+//! no benefit from mapping. Pixels are always aligned for their type.
+//!   MappedImage depth("depth_0001.pfm");
+//!   Image<float> d = depth.Reinterpret<float>();
+class PANGOLIN_EXPORT MappedImage : public TypedImage
+{
+public:
+    MappedImage();
+
+    //! Throws std::runtime_error if file can't be mapped.
+    MappedImage(const std::string& filename);
+
+    ~MappedImage();
+
+    void Open(const std::string& filename);
+
+    //! Unmap file, invalidating pixel pointer.
+    void Close();
+
+    bool IsOpen() const;
+
+    //! True if pixels point into the mapped file, rather than a copy.
+    bool IsMapped() const;
+
+    //! PFM files are stored bottom line first, so row 0 is the bottom
+    //! of the image when this is false.
+    bool top_line_first;
+
+protected:
+    // Not copyable, the mapping is owned
+    MappedImage(const MappedImage&);
+    MappedImage& operator=(const MappedImage&);
+
+    unsigned char* mapping;
+    size_t mapping_bytes;
+    bool mapped;
+};
+
+}
+
+#endif // PANGOLIN_IMAGE_MAPPED_H
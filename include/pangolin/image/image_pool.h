@@ -0,0 +1,90 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef PANGOLIN_IMAGE_POOL_H
+#define PANGOLIN_IMAGE_POOL_H
+
+#include <pangolin/platform.h>
+#include <pangolin/compat/mutex.h>
+
+#include <map>
+#include <vector>
+
+namespace pangolin
+{
+
+//! Alignment of buffers from AlignedAlloc and image rows of ManagedImage
+const size_t ImageAlignmentBytes = 64;
+
+//! Allocate bytes aligned to ImageAlignmentBytes, throwing std::bad_alloc on failure
+PANGOLIN_EXPORT
+unsigned char* AlignedAlloc(size_t bytes);
+
+//! Free buffer from AlignedAlloc
+PANGOLIN_EXPORT
+void AlignedFree(unsigned char* ptr);
+
+//! Keeps freed image buffers, bucketed by size, for reuse so that
+//! pipelines which repeatedly allocate same sized images stop hitting
+//! the heap once warmed up. Thread safe.
+class PANGOLIN_EXPORT ImageBufferPool
+{
+public:
+    //! At most max_cached_bytes of free buffers are kept
+    ImageBufferPool(size_t max_cached_bytes = 256*1024*1024);
+
+    ~ImageBufferPool();
+
+    //! Aligned buffer of at least bytes
+    unsigned char* Allocate(size_t bytes);
+
+    //! Return buffer from Allocate(bytes) to the pool
+    void Free(unsigned char* ptr, size_t bytes);
+
+    //! Free all cached buffers
+    void Clear();
+
+    size_t CachedBytes() const;
+
+    //! Buffers are allocated with sizes rounded up to quarter powers of two
+    static size_t BucketSize(size_t bytes);
+
+protected:
+    mutable boostd::mutex mutex;
+    std::map<size_t, std::vector<unsigned char*> > free_buffers;
+    size_t cached_bytes;
+    size_t max_cached_bytes;
+};
+
+//! Process-wide pool, created on first use
+PANGOLIN_EXPORT
+ImageBufferPool& DefaultImageBufferPool();
+
+}
+
+#endif // PANGOLIN_IMAGE_POOL_H
@@ -0,0 +1,94 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef PANGOLIN_IMAGE_STATS_H
+#define PANGOLIN_IMAGE_STATS_H
+
+#include <pangolin/platform.h>
+#include <pangolin/image/image.h>
+#include <pangolin/image/image_common.h>
+
+#include <utility>
+#include <vector>
+
+namespace pangolin
+{
+
+//! Summary of single channel pixel values.
+struct PANGOLIN_EXPORT ImageStats
+{
+    ImageStats() : count(0), min(0), max(0), mean(0), variance(0) {}
+
+    //! Number of pixels which contributed
+    size_t count;
+    double min;
+    double max;
+    double mean;
+    double variance;
+};
+
+//! Counts of single channel pixel values over [min, max] in equal width bins.
+//! Values outside of the range are counted in the first or last bin.
+struct PANGOLIN_EXPORT ImageHistogram
+{
+    ImageHistogram() : min(0), max(0), count(0) {}
+
+    double BinWidth() const;
+
+    //! Value below which fraction p in [0,1] of counted pixels lie,
+    //! interpolated within the containing bin.
+    double Percentile(double p) const;
+
+    double min;
+    double max;
+    size_t count;
+    std::vector<size_t> bins;
+};
+
+// The functions below are instantiated for T = uint8_t, uint16_t and float.
+// roi selects pixels to consider, or the whole image if it is empty. Non-finite
+// (NaN or infinite) pixels are always skipped, and zero pixels (often invalid
+// depth) if ignore_zero.
+// Large images are processed in blocks of rows across DefaultThreadPool().
+
+//! Min, max, mean and variance of pixels in roi of img.
+template<typename T> PANGOLIN_EXPORT
+ImageStats GetImageStats(const Image<T>& img, const ImageRoi& roi = ImageRoi(), bool ignore_zero = false);
+
+//! Fill hist with num_bins bins over [min, max] from pixels in roi of img.
+template<typename T> PANGOLIN_EXPORT
+void GetImageHistogram(ImageHistogram& hist, const Image<T>& img, double min, double max, size_t num_bins = 256, const ImageRoi& roi = ImageRoi(), bool ignore_zero = false);
+
+//! Values at fractions lo and hi through the sorted pixels in roi of img,
+//! e.g. (0.01, 0.99) for a range robust to outliers when auto-scaling.
+template<typename T> PANGOLIN_EXPORT
+std::pair<double,double> GetImagePercentiles(const Image<T>& img, double lo, double hi, const ImageRoi& roi = ImageRoi(), bool ignore_zero = false);
+
+}
+
+#endif // PANGOLIN_IMAGE_STATS_H
@@ -0,0 +1,113 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef PANGOLIN_IMAGE_WRITER_H
+#define PANGOLIN_IMAGE_WRITER_H
+
+#include <pangolin/image/image_io.h>
+#include <pangolin/compat/function.h>
+#include <pangolin/compat/mutex.h>
+#include <pangolin/compat/condition_variable.h>
+
+#include <string>
+
+namespace pangolin
+{
+
+struct ImageWriteJob;
+
+struct PANGOLIN_EXPORT ImageWriteOptions
+{
+    ImageWriteOptions()
+        : png_compression_level(-1), png_filters(-1), jpeg_quality(90)
+    {
+    }
+
+    //! zlib level in [0,9], or -1 for libpng default
+    int png_compression_level;
+
+    //! Combination of PngFilter flags, or -1 for libpng default
+    int png_filters;
+
+    //! JPEG quality in [0,100]
+    int jpeg_quality;
+};
+
+//! Encodes and saves images on worker threads of DefaultThreadPool(), so
+//! that callers such as the render loop aren't held up by compression.
+class PANGOLIN_EXPORT ImageWriter
+{
+public:
+    //! Called from a worker thread once a save has finished.
+    //! error is empty on success.
+    typedef boostd::function<void(const std::string& filename, const std::string& error)> Callback;
+
+    //! Save() blocks while max_pending images are waiting to be written.
+    ImageWriter(size_t max_pending = 16, const ImageWriteOptions& options = ImageWriteOptions());
+
+    //! Waits for outstanding saves to complete.
+    ~ImageWriter();
+
+    void SetOptions(const ImageWriteOptions& options);
+
+    ImageWriteOptions Options() const;
+
+    //! Queue image for saving to filename, format chosen by extension.
+    //! Takes ownership of image's buffer, which must have been allocated with
+    //! Alloc(), and sets image.ptr to 0. Errors are passed to done when
+    //! given, and printed otherwise.
+    void Save(Image<unsigned char>& image, const VideoPixelFormat& fmt, const std::string& filename, bool top_line_first = true, const Callback& done = Callback());
+
+    void Save(TypedImage& image, const std::string& filename, bool top_line_first = true, const Callback& done = Callback());
+
+    //! Number of images queued or being written
+    size_t NumPending() const;
+
+    //! Block until all queued images have been written
+    void Wait();
+
+protected:
+    friend struct ImageWriteJob;
+
+    //! Called by worker once an image is written
+    void Finished();
+
+    ImageWriteOptions options;
+    size_t max_pending;
+    size_t pending;
+    mutable boostd::mutex pending_mutex;
+    boostd::condition_variable cond_finished;
+};
+
+//! Process-wide writer used for screenshots, created on first use.
+PANGOLIN_EXPORT
+ImageWriter& DefaultImageWriter();
+
+}
+
+#endif // PANGOLIN_IMAGE_WRITER_H
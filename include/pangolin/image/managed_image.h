@@ -0,0 +1,163 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef PANGOLIN_MANAGED_IMAGE_H
+#define PANGOLIN_MANAGED_IMAGE_H
+
+#include <pangolin/image/image.h>
+#include <pangolin/image/image_pool.h>
+
+#include <algorithm>
+
+namespace pangolin
+{
+
+//! Image which owns its memory, freeing it on destruction. Rows are
+//! aligned to ImageAlignmentBytes, with pitch padded to a multiple of it.
+//! Buffers come from the heap, or from pool if one is given.
+//! Not copyable: transfer with Swap(), or move when available.
+template<typename T>
+class ManagedImage : public Image<T>
+{
+public:
+    inline ManagedImage()
+        : pool(0)
+    {
+    }
+
+    inline ManagedImage(size_t w, size_t h, ImageBufferPool* pool = 0)
+        : pool(0)
+    {
+        Reinitialise(w, h, pool);
+    }
+
+#ifdef CALLEE_HAS_RVALREF
+    //! Move Constructor
+    inline ManagedImage(ManagedImage&& img)
+        : Image<T>(img.w, img.h, img.pitch, img.ptr), pool(img.pool)
+    {
+        img.Release();
+    }
+
+    //! Move Assignment
+    inline ManagedImage& operator=(ManagedImage&& img)
+    {
+        if(this != &img) {
+            Deallocate();
+            Swap(img);
+        }
+        return *this;
+    }
+#endif
+
+    inline ~ManagedImage()
+    {
+        Deallocate();
+    }
+
+    //! Pitch in bytes for image of width w
+    static inline size_t AlignedPitch(size_t w)
+    {
+        const size_t row_bytes = w * sizeof(T);
+        return ((row_bytes + ImageAlignmentBytes - 1) / ImageAlignmentBytes) * ImageAlignmentBytes;
+    }
+
+    //! Resize image. Existing buffer is kept if the size is unchanged.
+    inline void Reinitialise(size_t w, size_t h, ImageBufferPool* pool = 0)
+    {
+        if(this->ptr && this->w == w && this->h == h && this->pool == pool) {
+            return;
+        }
+
+        Deallocate();
+        this->w = w;
+        this->h = h;
+        this->pitch = AlignedPitch(w);
+        this->pool = pool;
+        unsigned char* buffer = pool ? pool->Allocate(this->SizeBytes()) : AlignedAlloc(this->SizeBytes());
+        this->ptr = (T*)buffer;
+    }
+
+    //! Free memory, or return it to its pool
+    inline void Deallocate()
+    {
+        if(this->ptr) {
+            if(pool) {
+                pool->Free((unsigned char*)this->ptr, this->SizeBytes());
+            }else{
+                AlignedFree((unsigned char*)this->ptr);
+            }
+        }
+        Release();
+    }
+
+    inline void Swap(ManagedImage& img)
+    {
+        std::swap(this->w, img.w);
+        std::swap(this->h, img.h);
+        std::swap(this->pitch, img.pitch);
+        std::swap(this->ptr, img.ptr);
+        std::swap(pool, img.pool);
+    }
+
+    inline bool IsValid() const
+    {
+        return this->ptr != 0;
+    }
+
+    //! Non-owning view of this image
+    inline Image<T> View() const
+    {
+        return Image<T>(this->w, this->h, this->pitch, this->ptr);
+    }
+
+protected:
+    // Forget buffer without freeing it
+    inline void Release()
+    {
+        this->ptr = 0;
+        this->w = 0;
+        this->h = 0;
+        this->pitch = 0;
+        pool = 0;
+    }
+
+    // Not copyable
+    ManagedImage(const ManagedImage&);
+    ManagedImage& operator=(const ManagedImage&);
+
+    // Memory is managed, so hide unmanaged methods of Image
+    void Alloc(size_t w, size_t h, size_t pitch);
+    void Dealloc();
+
+    ImageBufferPool* pool;
+};
+
+}
+
+#endif // PANGOLIN_MANAGED_IMAGE_H
@@ -34,7 +34,10 @@
 #include <pangolin/compat/mutex.h>
 #include <pangolin/compat/condition_variable.h>
 #include <pangolin/utils/picojson.h>
+#include <pangolin/log/packettype.h>
 #include <stdint.h>
+#include <queue>
+#include <vector>
 
 
 namespace pangolin
@@ -75,6 +78,11 @@ int64_t PlaybackTime_us();
 PANGOLIN_EXPORT
 void SetCurrentPlaybackTime_us(int64_t time_us = 0);
 
+//! Writes sources and their packets to a pango log.
+//! Packets and packet meta data may be written concurrently from many
+//! threads. Each is staged in its own buffer without locking, and then
+//! committed to the file atomically. Packets are written in timestamp order
+//! amongst those committed within the reorder window of each other.
 class PANGOLIN_EXPORT PacketStreamWriter
 {
 public:
@@ -85,38 +93,99 @@ public:
 
     ~PacketStreamWriter();
 
+    //! Register a new source. Packets of size 0 are variable size.
+    //! Packet payloads are padded to start at a multiple of
+    //! packet_alignment_bytes from the start of the file.
     PacketStreamSourceId AddSource(
         const std::string& source_driver,
         const std::string& source_uri,
         const json::value& json_header = json::value(),
         const size_t       packet_size_bytes = 0,
-        const std::string& packet_definitions = ""
+        const std::string& packet_definitions = "",
+        const size_t       packet_alignment_bytes = 1
     );
 
+    //! Register a source of plain-old-data struct T, described by
+    //! PacketTraits<T>. Its definitions are checked when read with ReadAs<T>.
+    template<typename T>
+    PacketStreamSourceId AddSource(
+        const std::string& source_driver,
+        const std::string& source_uri,
+        const json::value& json_header = json::value()
+    ) {
+        return AddSource(source_driver, source_uri, json_header, sizeof(T), PacketDefinitions<T>());
+    }
+
+    //! Write packet to source registered with AddSource<T>
+    template<typename T>
+    void Write(PacketStreamSourceId src, const T& packet)
+    {
+        WriteSourcePacket(src, reinterpret_cast<const char*>(&packet), sizeof(T));
+    }
+
     void WriteSourcePacketMeta(PacketStreamSourceId src, const json::value& json);
 
     void WriteSourcePacket(PacketStreamSourceId src, const char* data, size_t n);
 
+    // Write single packet formed from header followed by data
+    void WriteSourcePacket(PacketStreamSourceId src, const char* header, size_t header_n, const char* data, size_t n);
+
     void WritePangoHeader();
 
     void WriteStats();
 
     void WriteSync();
 
+    //! Hold committed packets until those up to window_us newer have been
+    //! committed, so that packets from concurrent producers are written in
+    //! timestamp order. 0 (default) writes packets as soon as possible.
+    void SetReorderWindow_us(int64_t window_us);
+
+    //! Write all committed packets, irrespective of reorder window
+    void Flush();
+
 protected:
-    inline void WriteCompressedUnsignedInt(size_t n)
+    struct StagedPacket
+    {
+        int64_t time_us;
+        uint64_t sequence;
+        size_t alignment_bytes;
+        size_t prefix_bytes;      // tag, timestamp, source and size
+        std::vector<char> bytes;  // prefix, followed by payload
+        size_t payload_bytes;
+    };
+
+    // Orders staged packets oldest first, then by commit
+    struct StagedPacketLater
+    {
+        bool operator()(const StagedPacket* a, const StagedPacket* b) const
+        {
+            return a->time_us > b->time_us || (a->time_us == b->time_us && a->sequence > b->sequence);
+        }
+    };
+
+    // Write packet straight to file, bypassing staging, if there is no
+    // reorder window and the writer is free. Returns false otherwise.
+    bool WriteSourcePacketDirect(PacketStreamSourceId src, int64_t time_us, size_t packet_size, size_t alignment_bytes, const char* header, size_t header_n, const char* data, size_t n);
+
+    StagedPacket* StagePacket(int64_t time_us);
+    void CommitPacket(StagedPacket* packet);
+    void WritePending(bool all);
+    void WriteStaged(const StagedPacket& packet);
+    void RecyclePacket(StagedPacket* packet);
+
+    static inline void AppendCompressedUnsignedInt(std::vector<char>& out, size_t n)
     {
         while(n >= 0x80) {
-            writer.put( 0x80 | (n & 0x7F) );
+            out.push_back( (char)(0x80 | (n & 0x7F)) );
             n >>= 7;
         }
-        writer.put( (unsigned char)n );
+        out.push_back( (char)n );
     }
 
-    inline void WriteTimestamp()
+    static inline void AppendTag(std::vector<char>& out, const uint32_t tag)
     {
-        const int64_t time_us = PlaybackTime_us();
-        writer.write((char*)&time_us, sizeof(int64_t));
+        out.insert(out.end(), (const char*)&tag, (const char*)&tag + TAG_LENGTH);
     }
 
     inline void WriteTag(const uint32_t tag)
@@ -124,11 +193,25 @@ protected:
         writer.write((char*)&tag, TAG_LENGTH);
     }
 
+    void WritePadding(size_t alignment_bytes);
+
     std::vector<PacketStreamSource> sources;
     threadedfilebuf buffer;
     std::ostream writer;
 
     unsigned int bytes_written;
+
+    // Guards sources, and staged packet queues. Held only briefly.
+    boostd::mutex queue_mutex;
+    std::priority_queue<StagedPacket*, std::vector<StagedPacket*>, StagedPacketLater> pending;
+    std::vector<StagedPacket*> free_packets;
+    uint64_t next_sequence;
+    int64_t newest_time_us;
+    int64_t reorder_window_us;
+
+    // Guards writer. Held by whichever thread is writing pending packets.
+    boostd::mutex write_mutex;
+    std::vector<char> direct_prefix;
 };
 
 class PANGOLIN_EXPORT PacketStreamReader
@@ -148,6 +231,13 @@ public:
 
     bool ReadToSourcePacketAndLock(PacketStreamSourceId src_id);
 
+    //! Size of packet found by last successful ReadToSourcePacketAndLock.
+    //! Sources with variable packet sizes store this per packet.
+    inline size_t PacketSizeBytes() const
+    {
+        return packet_size_bytes;
+    }
+
     void ReleaseSourcePacketLock(PacketStreamSourceId src_id);
 
     // Should only read once lock is aquired
@@ -156,6 +246,32 @@ public:
         return reader.read(s,n);
     }
 
+    // Should only skip once lock is aquired
+    inline std::basic_istream<char>& Skip(size_t n)
+    {
+        return reader.ignore(n);
+    }
+
+    //! Read packet found by ReadToSourcePacketAndLock as struct T. The packet
+    //! is copied into an internal buffer aligned for T and used as is, without
+    //! per-field conversion. The result is valid until the next ReadAs.
+    //! Throws if the source wasn't written as T, leaving the packet unread.
+    template<typename T>
+    const T* ReadAs()
+    {
+        static const std::string definitions = PacketDefinitions<T>();
+        const PacketStreamSource& src = sources[locked_src_id];
+        if(packet_size_bytes != sizeof(T) || src.data_definitions != definitions) {
+            throw std::runtime_error("Packet source '" + src.driver + "' has definitions '" + src.data_definitions + "', not '" + definitions + "'.");
+        }
+        // Allocated storage is suitably aligned for any plain-old-data type
+        packet_buffer.resize(sizeof(T));
+        if(!reader.read(&packet_buffer[0], sizeof(T))) {
+            throw std::runtime_error("Unexpected end of packet data.");
+        }
+        return reinterpret_cast<const T*>(&packet_buffer[0]);
+    }
+
 protected:
     inline int64_t ReadTimestamp()
     {
@@ -164,16 +280,19 @@ protected:
         return time_us;
     }
 
+    // Inverse of PacketStreamWriter::AppendCompressedUnsignedInt,
+    // least significant 7 bits first.
     inline size_t ReadCompressedUnsignedInt()
     {
         size_t n = 0;
+        size_t shift = 0;
         size_t v = reader.get();
         while( v & 0x80 ) {
-            n |= v & 0x7F;
-            n <<= 7;
+            n |= (v & 0x7F) << shift;
+            shift += 7;
             v = reader.get();
         }
-        return n|v;
+        return n | (v << shift);
     }
 
     void ProcessMessage();
@@ -185,6 +304,7 @@ protected:
     void ReadNewSourcePacket();
     void ReadStatsPacket();
     void ReadOverSourcePacket(PacketStreamSourceId src_id);
+    void ReadOverPadding(const PacketStreamSource& src);
     uint32_t next_tag;
 
     std::vector<PacketStreamSource> sources;
@@ -193,6 +313,9 @@ protected:
     boostd::mutex read_mutex;
 
     int packets;
+    size_t packet_size_bytes;
+    PacketStreamSourceId locked_src_id;
+    std::vector<char> packet_buffer;
     bool realtime;
 };
 
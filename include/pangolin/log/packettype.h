@@ -0,0 +1,166 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef PANGOLIN_PACKETTYPE_H
+#define PANGOLIN_PACKETTYPE_H
+
+#include <pangolin/platform.h>
+#include <stdint.h>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+
+namespace pangolin
+{
+
+//! Name used within packet definitions for each supported field type.
+//! Fixed size arrays of these are also supported.
+template<typename M> struct PacketFieldType;
+
+#define PANGOLIN_PACKET_FIELD_TYPE(type, name) \
+    template<> struct PacketFieldType<type> { \
+        typedef type Element; static const size_t count = 1; \
+        static const char* Name() { return name; } \
+    };
+PANGOLIN_PACKET_FIELD_TYPE(int8_t,   "int8")
+PANGOLIN_PACKET_FIELD_TYPE(int16_t,  "int16")
+PANGOLIN_PACKET_FIELD_TYPE(int32_t,  "int32")
+PANGOLIN_PACKET_FIELD_TYPE(int64_t,  "int64")
+PANGOLIN_PACKET_FIELD_TYPE(uint8_t,  "uint8")
+PANGOLIN_PACKET_FIELD_TYPE(uint16_t, "uint16")
+PANGOLIN_PACKET_FIELD_TYPE(uint32_t, "uint32")
+PANGOLIN_PACKET_FIELD_TYPE(uint64_t, "uint64")
+PANGOLIN_PACKET_FIELD_TYPE(char,     "char")
+PANGOLIN_PACKET_FIELD_TYPE(bool,     "bool")
+PANGOLIN_PACKET_FIELD_TYPE(float,    "float32")
+PANGOLIN_PACKET_FIELD_TYPE(double,   "float64")
+#undef PANGOLIN_PACKET_FIELD_TYPE
+
+template<typename M, size_t N>
+struct PacketFieldType<M[N]>
+{
+    typedef typename PacketFieldType<M>::Element Element;
+    static const size_t count = N * PacketFieldType<M>::count;
+    static const char* Name() { return PacketFieldType<M>::Name(); }
+};
+
+//! Builds the packet definitions string for plain-old-data struct T from
+//! its fields, including any padding, so that the string describes the
+//! exact byte layout of T.
+template<typename T>
+class PacketFieldList
+{
+public:
+    PacketFieldList()
+        : offset(0), num_padding(0)
+    {
+    }
+
+    //! Describe member of T. Members must be given in declaration order.
+    template<typename M>
+    PacketFieldList& Field(const std::string& name, M T::*member)
+    {
+        const size_t field_offset = MemberOffset(member);
+        if(field_offset < offset) {
+            throw std::runtime_error("Packet field '" + name + "' described out of order or overlapping.");
+        }
+        Padding(field_offset - offset);
+        AddField(PacketFieldType<M>::Name(), name, PacketFieldType<M>::count);
+        offset = field_offset + sizeof(M);
+        return *this;
+    }
+
+    std::string Definitions(const std::string& type_name)
+    {
+        Padding(sizeof(T) - offset);
+        offset = sizeof(T);
+        return "struct " + type_name + "{" + fields.str() + "};";
+    }
+
+protected:
+    template<typename M>
+    static size_t MemberOffset(M T::*member)
+    {
+        // As offsetof, without requiring the member name
+        const char* base = reinterpret_cast<const char*>(&dummy);
+        return reinterpret_cast<const char*>(&(reinterpret_cast<const T*>(base)->*member)) - base;
+    }
+
+    void AddField(const char* type, const std::string& name, size_t count)
+    {
+        fields << " " << type << " " << name;
+        if(count > 1) fields << "[" << count << "]";
+        fields << ";";
+    }
+
+    void Padding(size_t bytes)
+    {
+        if(bytes) {
+            std::ostringstream name;
+            name << "_padding" << num_padding++;
+            AddField("uint8", name.str(), bytes);
+        }
+    }
+
+    static union Storage { char c[sizeof(T)]; double d; int64_t i; void* p; } dummy;
+
+    size_t offset;
+    size_t num_padding;
+    std::ostringstream fields;
+};
+
+template<typename T>
+typename PacketFieldList<T>::Storage PacketFieldList<T>::dummy;
+
+//! Specialise for each plain-old-data struct T to be logged with the typed
+//! PacketStreamWriter / PacketStreamReader interface, e.g.
+//!
+//!   struct ImuSample { int64_t time_us; float accel[3]; float gyro[3]; };
+//!
+//!   template<> struct PacketTraits<ImuSample> {
+//!       static const char* Name() { return "ImuSample"; }
+//!       static void Describe(PacketFieldList<ImuSample>& f) {
+//!           f.Field("time_us", &ImuSample::time_us)
+//!            .Field("accel", &ImuSample::accel)
+//!            .Field("gyro", &ImuSample::gyro);
+//!       }
+//!   };
+template<typename T> struct PacketTraits;
+
+//! Definitions string for T, as stored with its packet source
+template<typename T>
+std::string PacketDefinitions()
+{
+    PacketFieldList<T> fields;
+    PacketTraits<T>::Describe(fields);
+    return fields.Definitions(PacketTraits<T>::Name());
+}
+
+}
+
+#endif // PANGOLIN_PACKETTYPE_H
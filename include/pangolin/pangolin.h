@@ -62,6 +62,11 @@
 #endif // BUILD_PANGOLIN_VIDEO
 
 #include <pangolin/image/image_io.h>
+#include <pangolin/image/image_writer.h>
+#include <pangolin/image/image_mapped.h>
+#include <pangolin/image/managed_image.h>
+#include <pangolin/image/image_convert.h>
+#include <pangolin/image/image_stats.h>
 
 // Let other libraries headers know about Pangolin
 #define HAVE_PANGOLIN
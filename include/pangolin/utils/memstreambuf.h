@@ -0,0 +1,129 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef PANGOLIN_MEMSTREAMBUF_H
+#define PANGOLIN_MEMSTREAMBUF_H
+
+#include <pangolin/platform.h>
+
+#include <algorithm>
+#include <streambuf>
+#include <vector>
+
+namespace pangolin
+{
+
+//! Read-only std::streambuf over existing memory, so that stream based
+//! decoders can read from a buffer without first copying it.
+//!   memstreambuf buf(data, n);
+//!   std::istream is(&buf);
+class PANGOLIN_EXPORT memstreambuf : public std::streambuf
+{
+public:
+    memstreambuf(const unsigned char* data, size_t size_bytes)
+    {
+        char* p = const_cast<char*>((const char*)data);
+        setg(p, p, p + size_bytes);
+    }
+
+protected:
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which = std::ios_base::in)
+    {
+        char* p = (dir == std::ios_base::beg) ? eback() :
+                  (dir == std::ios_base::cur) ? gptr() : egptr();
+        p += off;
+        if(!(which & std::ios_base::in) || p < eback() || p > egptr()) {
+            return pos_type(off_type(-1));
+        }
+        setg(eback(), p, egptr());
+        return pos_type(p - eback());
+    }
+
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which = std::ios_base::in)
+    {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+};
+
+//! Write-only std::streambuf appending to a std::vector. Stream positions
+//! are relative to the vector's size on construction, and seeking back
+//! overwrites previously written bytes (needed by e.g. OpenEXR).
+//!   vectorstreambuf buf(bytes);
+//!   std::ostream os(&buf);
+class PANGOLIN_EXPORT vectorstreambuf : public std::streambuf
+{
+public:
+    vectorstreambuf(std::vector<unsigned char>& out)
+        : out(out), begin(out.size()), pos(out.size())
+    {
+    }
+
+protected:
+    std::streamsize xsputn(const char* s, std::streamsize n)
+    {
+        const size_t overwrite = std::min((size_t)n, out.size() - pos);
+        std::copy(s, s + overwrite, out.begin() + pos);
+        out.insert(out.end(), (const unsigned char*)s + overwrite, (const unsigned char*)s + n);
+        pos += n;
+        return n;
+    }
+
+    int_type overflow(int_type c)
+    {
+        if(c != traits_type::eof()) {
+            const char ch = traits_type::to_char_type(c);
+            xsputn(&ch, 1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which = std::ios_base::out)
+    {
+        const off_type base = (dir == std::ios_base::beg) ? 0 :
+                              (dir == std::ios_base::cur) ? off_type(pos - begin) : off_type(out.size() - begin);
+        const off_type p = base + off;
+        if(!(which & std::ios_base::out) || p < 0 || p > off_type(out.size() - begin)) {
+            return pos_type(off_type(-1));
+        }
+        pos = begin + (size_t)p;
+        return pos_type(p);
+    }
+
+    pos_type seekpos(pos_type p, std::ios_base::openmode which = std::ios_base::out)
+    {
+        return seekoff(off_type(p), std::ios_base::beg, which);
+    }
+
+    std::vector<unsigned char>& out;
+    size_t begin;
+    size_t pos;
+};
+
+}
+
+#endif // PANGOLIN_MEMSTREAMBUF_H
@@ -0,0 +1,89 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef PANGOLIN_THREAD_POOL_H
+#define PANGOLIN_THREAD_POOL_H
+
+#include <pangolin/platform.h>
+#include <pangolin/compat/function.h>
+#include <pangolin/compat/thread.h>
+#include <pangolin/compat/mutex.h>
+#include <pangolin/compat/condition_variable.h>
+
+#include <deque>
+#include <vector>
+
+namespace pangolin
+{
+
+//! Fixed set of worker threads executing queued tasks in order.
+class PANGOLIN_EXPORT ThreadPool
+{
+public:
+    typedef boostd::function<void()> Task;
+
+    //! Start num_threads workers, or one per hardware thread if 0.
+    ThreadPool(size_t num_threads = 0);
+
+    //! Completes queued tasks before returning.
+    ~ThreadPool();
+
+    size_t NumThreads() const;
+
+    //! Queue task for execution on a worker thread. Tasks should not throw;
+    //! any exception is reported and otherwise ignored.
+    void Enqueue(const Task& task);
+
+    //! Block until all queued tasks have finished.
+    void Wait();
+
+    //! Call f(i) for i in [0,n), using the workers and the calling thread,
+    //! returning once all calls have completed. The first exception thrown
+    //! is rethrown as std::runtime_error. Safe to call from within a task.
+    void ParallelFor(size_t n, const boostd::function<void(size_t)>& f);
+
+    //! Worker thread body
+    void operator()();
+
+protected:
+    std::vector<boostd::thread*> threads;
+    std::deque<Task> tasks;
+    boostd::mutex tasks_mutex;
+    boostd::condition_variable cond_queued;
+    boostd::condition_variable cond_done;
+    size_t active;
+    bool should_run;
+};
+
+//! Process-wide pool with one thread per hardware thread, created on first use.
+PANGOLIN_EXPORT
+ThreadPool& DefaultThreadPool();
+
+}
+
+#endif // PANGOLIN_THREAD_POOL_H
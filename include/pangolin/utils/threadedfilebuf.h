@@ -57,6 +57,9 @@ protected:
 
     //! Override streambuf::overflow for asynchronous write
     int overflow(int c);
+
+    //! Override streambuf::seekoff to report bytes written (tellp) only
+    std::streampos seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode which = std::ios_base::in | std::ios_base::out);
     
     std::filebuf file;
     char* mem_buffer;
@@ -64,6 +67,7 @@ protected:
     std::streamsize mem_max_size;
     std::streamsize mem_start;
     std::streamsize mem_end;
+    std::streamsize input_pos;
     
     boostd::mutex update_mutex;
     boostd::condition_variable cond_queued;
@@ -55,7 +55,7 @@ typedef enum {
 } color_filter_t;
 
 // Video class that debayers its video input using the given method.
-class PANGOLIN_EXPORT DebayerVideo : public VideoInterface, public VideoFilterInterface
+class PANGOLIN_EXPORT DebayerVideo : public VideoInterface, public VideoFilterInterface, public VideoFrameInfoInterface
 {
 public:
     DebayerVideo(VideoInterface* videoin, color_filter_t tile, bayer_method_t method);
@@ -81,10 +81,14 @@ public:
 
     std::vector<VideoInterface*>& InputStreams();
 
+    //! Implement VideoFrameInfoInterface::FrameInfo()
+    const VideoFrameInfo& FrameInfo() const;
+
 protected:
     std::vector<VideoInterface*> videoin;
     std::vector<StreamInfo> streams;
     size_t size_bytes;
+    VideoFrameInfo frame_info;
     unsigned char* buffer;
 
     color_filter_t tile;
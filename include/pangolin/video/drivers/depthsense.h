@@ -49,7 +49,7 @@ enum DepthSenseSensorType
 
 // Video class that outputs test video signal.
 class PANGOLIN_EXPORT DepthSenseVideo :
-        public VideoInterface, public VideoPropertiesInterface
+        public VideoInterface, public VideoPropertiesInterface, public VideoFrameInfoInterface
 {
 public:
     DepthSenseVideo(DepthSense::Device device, DepthSenseSensorType s1, DepthSenseSensorType s2, ImageDim dim1, ImageDim dim2, unsigned int fps1, unsigned int fps2, const Uri& uri);
@@ -82,6 +82,11 @@ public:
     const json::value& FrameProperties() const {
         return frame_properties;
     }
+
+    //! Implement VideoFrameInfoInterface::FrameInfo()
+    const VideoFrameInfo& FrameInfo() const {
+        return frame_info;
+    }
 protected:
     void onNewColorSample(DepthSense::ColorNode node, DepthSense::ColorNode::NewSampleReceivedData data);
     void onNewDepthSample(DepthSense::DepthNode node, DepthSense::DepthNode::NewSampleReceivedData data);
@@ -104,7 +109,7 @@ protected:
     json::value device_properties;
     json::value frame_properties;
     json::value* streams_properties;
-
+    VideoFrameInfo frame_info;
 
     DepthSense::Device device;
     DepthSense::DepthNode g_dnode;
@@ -0,0 +1,115 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef PANGOLIN_EVENT_VIDEO_OUTPUT_H
+#define PANGOLIN_EVENT_VIDEO_OUTPUT_H
+
+#include <pangolin/video/video_output.h>
+#include <pangolin/video/motion_detector.h>
+#include <pangolin/compat/mutex.h>
+
+#include <deque>
+
+namespace pangolin
+{
+
+//! Event triggered recording. Frames are kept in an in-memory pre-roll ring
+//! covering the last preroll_s seconds. When motion is detected in the first
+//! stream, or Trigger() is called, the ring and all subsequent frames are
+//! written to the underlying output until nothing further has happened for
+//! postroll_s seconds. The underlying output is only opened on first event.
+class PANGOLIN_EXPORT EventVideoOutput : public VideoOutputInterface
+{
+public:
+    EventVideoOutput(const Uri& output_uri, double preroll_s = 5.0, double postroll_s = 2.0, bool detect_motion = true, const MotionDetector& detector = MotionDetector());
+    ~EventVideoOutput();
+
+    const std::vector<StreamInfo>& Streams() const PANGOLIN_OVERRIDE;
+    void SetStreams(const std::vector<StreamInfo>& streams, const std::string& uri, const json::value& device_properties) PANGOLIN_OVERRIDE;
+    int WriteStreams(unsigned char* data, const json::value& frame_properties) PANGOLIN_OVERRIDE;
+    int WriteStreams(unsigned char* data, const json::value& frame_properties, const VideoFrameInfo& frame_info) PANGOLIN_OVERRIDE;
+
+    //! Signal an external event. Safe to call from any thread; takes effect
+    //! on the next written frame.
+    void Trigger();
+
+    //! True whilst frames are being written through to the output
+    bool IsCommitting() const;
+
+    //! Number of events which have started committing frames
+    size_t Events() const;
+
+    //! Frames written to the underlying output
+    size_t FramesCommitted() const;
+
+    //! Frames which aged out of the pre-roll ring without being written
+    size_t FramesDiscarded() const;
+
+protected:
+    struct BufferedFrame
+    {
+        std::vector<unsigned char> data;
+        json::value frame_properties;
+        VideoFrameInfo frame_info;
+        int64_t time_us;
+    };
+
+    void BeginEvent();
+    void Buffer(unsigned char* data, const json::value& frame_properties, const VideoFrameInfo& frame_info, int64_t time_us);
+    void Recycle(BufferedFrame* frame);
+
+    Uri output_uri;
+    VideoOutputInterface* output;
+
+    std::vector<StreamInfo> streams;
+    std::string input_uri;
+    json::value device_properties;
+    size_t frame_size_bytes;
+
+    int64_t preroll_us;
+    int64_t postroll_us;
+    bool detect_motion;
+    MotionDetector detector;
+
+    std::deque<BufferedFrame*> ring;
+    std::vector<BufferedFrame*> pool;
+
+    boostd::mutex trigger_mutex;
+    bool trigger_pending;
+
+    bool committing;
+    int64_t last_activity_us;
+
+    size_t events;
+    size_t frames_committed;
+    size_t frames_discarded;
+};
+
+}
+
+#endif // PANGOLIN_EVENT_VIDEO_OUTPUT_H
@@ -49,7 +49,7 @@ extern "C"
 namespace pangolin
 {
 
-class PANGOLIN_EXPORT FfmpegVideo : public VideoInterface
+class PANGOLIN_EXPORT FfmpegVideo : public VideoInterface, public VideoFrameInfoInterface
 {
 public:
     FfmpegVideo(const std::string filename, const std::string fmtout = "RGB24", const std::string codec_hint = "", bool dump_info = false, int user_video_stream = -1);
@@ -73,6 +73,9 @@ public:
     //! Implement VideoInput::GrabNewest()
     bool GrabNewest( unsigned char* image, bool wait = true );
     
+    //! Implement VideoFrameInfoInterface::FrameInfo()
+    const VideoFrameInfo& FrameInfo() const;
+    
 protected:
     void InitUrl(const std::string filename, const std::string fmtout = "RGB24", const std::string codec_hint = "", bool dump_info = false , int user_video_stream = -1);
     
@@ -92,6 +95,7 @@ protected:
     int             numBytesOut;
     uint8_t         *buffer;
     PixelFormat     fmtout;
+    VideoFrameInfo  frame_info;
 };
 
 enum FfmpegMethod
@@ -109,7 +113,7 @@ enum FfmpegMethod
     FFMPEG_SPLINE        =0x400
 };
 
-class PANGOLIN_EXPORT FfmpegConverter : public VideoInterface
+class PANGOLIN_EXPORT FfmpegConverter : public VideoInterface, public VideoFrameInfoInterface
 {
 public:
     FfmpegConverter(VideoInterface* videoin, const std::string pixelfmtout = "RGB24", FfmpegMethod method = FFMPEG_POINT);
@@ -133,6 +137,9 @@ public:
     //! Implement VideoInput::GrabNewest()
     bool GrabNewest( unsigned char* image, bool wait = true );
     
+    //! Implement VideoFrameInfoInterface::FrameInfo()
+    const VideoFrameInfo& FrameInfo() const;
+    
 protected:
     std::vector<StreamInfo> streams;
     
@@ -148,6 +155,7 @@ protected:
     int             numbytessrc;
     int             numbytesdst;
     unsigned        w,h;
+    VideoFrameInfo  frame_info;
 };
 
 #if (LIBAVFORMAT_VERSION_MAJOR > 55) || ((LIBAVFORMAT_VERSION_MAJOR == 55) && (LIBAVFORMAT_VERSION_MINOR >= 7))
@@ -74,7 +74,7 @@ struct PANGOLIN_EXPORT Guid
     uint64_t guid;
 };
 
-class PANGOLIN_EXPORT FirewireVideo : public VideoInterface
+class PANGOLIN_EXPORT FirewireVideo : public VideoInterface, public VideoFrameInfoInterface
 {
 public:
     const static int MAX_FR = -1;
@@ -140,6 +140,9 @@ public:
     //! Implement VideoInput::GrabNewest()
     bool GrabNewest( unsigned char* image, bool wait = true );
 
+    //! Implement VideoFrameInfoInterface::FrameInfo()
+    const VideoFrameInfo& FrameInfo() const { return frame_info; }
+
     //! (deprecated: use Streams[i].Width())
     //! Return image width
     unsigned Width() const { return width; }
@@ -249,6 +252,7 @@ protected:
     dc1394_t * d;
     dc1394camera_list_t * list;
     mutable dc1394error_t err;
+    VideoFrameInfo frame_info;
     
 };
 
@@ -35,7 +35,7 @@ namespace pangolin
 {
 
 class PANGOLIN_EXPORT FirewireDeinterlace
-    : public VideoInterface
+    : public VideoInterface, public VideoFrameInfoInterface
 {
 public:
     FirewireDeinterlace(VideoInterface* videoin);
@@ -53,10 +53,13 @@ public:
     
     bool GrabNewest( unsigned char* image, bool wait = true );    
     
+    const VideoFrameInfo& FrameInfo() const;
+
 protected:
     VideoInterface* videoin;
     std::vector<StreamInfo> streams;
     unsigned char* buffer;
+    VideoFrameInfo frame_info;
 };
 
 
@@ -32,17 +32,16 @@
 #include <pangolin/video/video.h>
 #include <pangolin/image/image_io.h>
 
-#include <deque>
 #include <vector>
 
 namespace pangolin
 {
 
 // Video class that outputs test video signal.
-class PANGOLIN_EXPORT ImagesVideo : public VideoInterface
+class PANGOLIN_EXPORT ImagesVideo : public VideoInterface, public VideoFrameInfoInterface
 {
 public:
-    ImagesVideo(const std::string& wildcard_path);
+    ImagesVideo(const std::string& wildcard_path, const ImageLoadOptions& load_options = ImageLoadOptions());
     ~ImagesVideo();
     
     //! Implement VideoInput::Start()
@@ -62,26 +61,26 @@ public:
     
     //! Implement VideoInput::GrabNewest()
     bool GrabNewest( unsigned char* image, bool wait = true );
+
+    //! Implement VideoFrameInfoInterface::FrameInfo()
+    const VideoFrameInfo& FrameInfo() const;
     
 protected:
-    typedef std::vector<TypedImage> Frame;
-    
     const std::string& Filename(size_t frameNum, size_t channelNum) {
         return filenames[channelNum][frameNum];
     }
     
-    bool QueueFrame();
-    
     std::vector<StreamInfo> streams;
     size_t size_bytes;
+    VideoFrameInfo frame_info;
     
     
     int num_files;
     size_t num_channels;
     std::vector<std::vector<std::string> > filenames;
     
-    int num_loaded;
-    std::deque<Frame> loaded;
+    int next_frame;
+    ImageLoadOptions load_options;
 };
 
 }
@@ -0,0 +1,86 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef PANGOLIN_IMAGES_VIDEO_OUTPUT_H
+#define PANGOLIN_IMAGES_VIDEO_OUTPUT_H
+
+#include <pangolin/video/video_output.h>
+#include <pangolin/image/image_writer.h>
+#include <pangolin/compat/mutex.h>
+
+namespace pangolin
+{
+
+//! Write each stream to a sequence of numbered image files, encoded on the
+//! threads of an ImageWriter. filename_pattern holds one printf style integer
+//! conversion for the frame number, e.g. dir/frame_%06d.png, and may use
+//! [a,b] expansion to give one pattern per stream, e.g. dir/[left,right]_%06d.png.
+//! File type is chosen by extension. Frame properties are not stored.
+class PANGOLIN_EXPORT ImagesVideoOutput : public VideoOutputInterface
+{
+public:
+    //! At most max_pending frames are queued for encoding before WriteStreams blocks.
+    ImagesVideoOutput(const std::string& filename_pattern, size_t first_frame = 0, size_t max_pending = 16, const ImageWriteOptions& options = ImageWriteOptions());
+
+    //! Waits for queued frames to be written.
+    ~ImagesVideoOutput();
+
+    const std::vector<StreamInfo>& Streams() const PANGOLIN_OVERRIDE;
+    void SetStreams(const std::vector<StreamInfo>& streams, const std::string& uri, const json::value& device_properties) PANGOLIN_OVERRIDE;
+    int WriteStreams(unsigned char* data, const json::value& frame_properties) PANGOLIN_OVERRIDE;
+
+    //! Block until all queued frames have been written, throwing if any failed.
+    void Flush();
+
+    //! Number of the next frame to be written
+    size_t NextFrame() const;
+
+    //! Called from writer threads once each image is written
+    void ImageWritten(const std::string& filename, const std::string& error);
+
+protected:
+    void ThrowIfFailed();
+
+    // Initialised before writer, which is sized by the number of patterns
+    std::vector<std::string> patterns;
+    std::vector<StreamInfo> streams;
+    size_t next_frame;
+    boostd::mutex error_mutex;
+    std::string error;
+    bool error_thrown;
+    ImageWriter writer;
+};
+
+//! Format filename_pattern, containing one printf style integer conversion
+//! such as %d or %06d, with frame. Throws VideoException for other patterns.
+PANGOLIN_EXPORT
+std::string FormatFrameFilename(const std::string& filename_pattern, size_t frame);
+
+}
+
+#endif // PANGOLIN_IMAGES_VIDEO_OUTPUT_H
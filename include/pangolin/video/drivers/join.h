@@ -34,7 +34,7 @@ namespace pangolin
 {
 
 class PANGOLIN_EXPORT VideoJoiner
-    : public VideoInterface, public VideoFilterInterface
+    : public VideoInterface, public VideoFilterInterface, public VideoFrameInfoInterface
 {
 public:
     VideoJoiner(const std::vector<VideoInterface *> &src);
@@ -55,9 +55,12 @@ public:
 
     std::vector<VideoInterface*>& InputStreams();
 
+    const VideoFrameInfo& FrameInfo() const;
+
 protected:
     std::vector<VideoInterface*> src;
     std::vector<StreamInfo> streams;
+    VideoFrameInfo frame_info;
     size_t size_bytes;
 };
 
@@ -23,7 +23,7 @@ namespace pangolin
 {
 
 //! Interface to video capture sources
-struct PANGOLIN_EXPORT OpenNiVideo : public VideoInterface
+struct PANGOLIN_EXPORT OpenNiVideo : public VideoInterface, public VideoFrameInfoInterface
 {
 public:
     OpenNiVideo(OpenNiSensorType s1, OpenNiSensorType s2, ImageDim dim = ImageDim(640,480), int fps = 30);
@@ -47,6 +47,11 @@ public:
     //! Implement VideoInput::GrabNewest()
     bool GrabNewest( unsigned char* image, bool wait = true );
 
+    //! Implement VideoFrameInfoInterface::FrameInfo()
+    const VideoFrameInfo& FrameInfo() const {
+        return frame_info;
+    }
+
     void SetAutoExposure(bool enabled)
     {
 #if XN_MINOR_VERSION > 5 || (XN_MINOR_VERSION == 5 && XN_BUILD_VERSION >= 7)
@@ -68,6 +73,7 @@ protected:
     xn::IRGenerator irNode;
     
     size_t sizeBytes;
+    VideoFrameInfo frame_info;
 };
 
 }
@@ -41,7 +41,7 @@ namespace pangolin
 const int MAX_OPENNI2_STREAMS = 2 * ONI_MAX_SENSORS;
 
 //! Interface to video capture sources
-struct OpenNiVideo2 : public VideoInterface, public VideoPropertiesInterface, public VideoPlaybackInterface
+struct OpenNiVideo2 : public VideoInterface, public VideoPropertiesInterface, public VideoPlaybackInterface, public VideoFrameInfoInterface
 {
 public:
 
@@ -99,6 +99,11 @@ public:
         return frame_properties;
     }
 
+    //! Implement VideoFrameInfoInterface::FrameInfo()
+    const VideoFrameInfo& FrameInfo() const {
+        return frame_info;
+    }
+
     //! Implement VideoPlaybackInterface::GetCurrentFrameId
     int GetCurrentFrameId() const;
 
@@ -133,6 +138,7 @@ protected:
     json::value device_properties;
     json::value frame_properties;
     json::value* streams_properties;
+    VideoFrameInfo frame_info;
 
     bool use_depth;
     bool use_ir;
@@ -29,13 +29,14 @@
 #define PANGOLIN_PANGO_VIDEO_H
 
 #include <pangolin/video/video.h>
+#include <pangolin/video/drivers/pango_video_codec.h>
 #include <pangolin/log/packetstream.h>
 
 namespace pangolin
 {
 
 class PANGOLIN_EXPORT PangoVideo
-    : public VideoInterface, public VideoPropertiesInterface, public VideoPlaybackInterface
+    : public VideoInterface, public VideoPropertiesInterface, public VideoPlaybackInterface, public VideoFrameInfoInterface
 {
 public:
     PangoVideo(const std::string& filename, bool realtime = true);
@@ -61,6 +62,9 @@ public:
 
     const json::value& FrameProperties() const PANGOLIN_OVERRIDE;
 
+    // Implement VideoFrameInfoInterface
+
+    const VideoFrameInfo& FrameInfo() const PANGOLIN_OVERRIDE;
 
     // Implement VideoPlaybackInterface
 
@@ -72,12 +76,22 @@ public:
 
 protected:
     int FindSource();
+    void ReadEncodedPacket(unsigned char* image);
 
     PacketStreamReader reader;
     size_t size_bytes;
     std::vector<StreamInfo> streams;
     json::value device_properties;
     json::value frame_properties;
+    VideoFrameInfo frame_info;
+    bool has_frame_info;
+    size_t frame_info_bytes;
+
+    // Per stream codec, or 0 for raw. Packets are variable size if any are set.
+    std::vector<PangoVideoCodec*> codecs;
+    bool variable_packets;
+    std::vector<unsigned char> packet;
+
     int src_id;
     int frame_id;
 };
@@ -0,0 +1,150 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef PANGOLIN_PANGO_VIDEO_CODEC_H
+#define PANGOLIN_PANGO_VIDEO_CODEC_H
+
+#include <pangolin/video/video.h>
+#include <pangolin/utils/params.h>
+
+#include <vector>
+
+namespace pangolin
+{
+
+//! Optional per-stream encoding of image data within pango video logs.
+//! The codec name is recorded as the stream's "codec" in the log header.
+//! Encode and Decode may be called concurrently for different frames,
+//! unless the codec is InterFrame.
+class PANGOLIN_EXPORT PangoVideoCodec
+{
+public:
+    virtual ~PangoVideoCodec() {}
+
+    //! Name stored in the stream header, used to recreate the codec for reading
+    virtual std::string Name() const = 0;
+
+    //! Append encoding of img to out
+    virtual void Encode(std::vector<unsigned char>& out, const Image<unsigned char>& img) = 0;
+
+    //! Decode n bytes of encoded data into img, which has the stream's dimensions
+    virtual void Decode(Image<unsigned char>& img, const unsigned char* data, size_t n) = 0;
+
+    //! True if frames depend on those before them, in which case Encode
+    //! and Decode must be called once per frame, in order.
+    virtual bool InterFrame() const { return false; }
+};
+
+//! Lossless codec for 16 bit single channel (depth) images.
+//! Each row is predicted from its left neighbour, residuals are zigzag
+//! mapped and bit packed in blocks of 16, with runs of zero blocks
+//! collapsed. Bands of rows are coded independently, in parallel.
+class PANGOLIN_EXPORT PangoDepthCodec : public PangoVideoCodec
+{
+public:
+    PangoDepthCodec(size_t band_rows = 32);
+
+    std::string Name() const PANGOLIN_OVERRIDE;
+    void Encode(std::vector<unsigned char>& out, const Image<unsigned char>& img) PANGOLIN_OVERRIDE;
+    void Decode(Image<unsigned char>& img, const unsigned char* data, size_t n) PANGOLIN_OVERRIDE;
+
+protected:
+    size_t band_rows;
+};
+
+//! Lossless inter-frame codec for slowly changing streams. The image is
+//! split into tiles, and only tiles which differ from the previous frame
+//! are stored, as their XOR with it. A complete keyframe is stored every
+//! keyframe_interval frames (0 for only the first), bounding the number
+//! of frames that must be decoded to reach any point in the log.
+class PANGOLIN_EXPORT PangoDeltaCodec : public PangoVideoCodec
+{
+public:
+    PangoDeltaCodec(const VideoPixelFormat& fmt, size_t keyframe_interval = 30, size_t tile_pixels = 16);
+
+    std::string Name() const PANGOLIN_OVERRIDE;
+    void Encode(std::vector<unsigned char>& out, const Image<unsigned char>& img) PANGOLIN_OVERRIDE;
+    void Decode(Image<unsigned char>& img, const unsigned char* data, size_t n) PANGOLIN_OVERRIDE;
+    bool InterFrame() const PANGOLIN_OVERRIDE;
+
+protected:
+    VideoPixelFormat fmt;
+    size_t keyframe_interval;
+    size_t tile_pixels;
+    size_t frames_since_keyframe;
+
+    // Last frame encoded or decoded, as packed rows
+    bool has_previous;
+    std::vector<unsigned char> previous;
+};
+
+//! Lossless PNG compression of 8 or 16 bit per channel images.
+class PANGOLIN_EXPORT PangoPngCodec : public PangoVideoCodec
+{
+public:
+    //! zlib_level in [0,9], favouring speed by default
+    PangoPngCodec(const VideoPixelFormat& fmt, int zlib_level = 1);
+
+    std::string Name() const PANGOLIN_OVERRIDE;
+    void Encode(std::vector<unsigned char>& out, const Image<unsigned char>& img) PANGOLIN_OVERRIDE;
+    void Decode(Image<unsigned char>& img, const unsigned char* data, size_t n) PANGOLIN_OVERRIDE;
+
+protected:
+    VideoPixelFormat fmt;
+    int zlib_level;
+};
+
+//! Lossy JPEG compression of GRAY8 or RGB24 images.
+class PANGOLIN_EXPORT PangoJpegCodec : public PangoVideoCodec
+{
+public:
+    //! quality in [0,100]
+    PangoJpegCodec(const VideoPixelFormat& fmt, int quality = 90);
+
+    std::string Name() const PANGOLIN_OVERRIDE;
+    void Encode(std::vector<unsigned char>& out, const Image<unsigned char>& img) PANGOLIN_OVERRIDE;
+    void Decode(Image<unsigned char>& img, const unsigned char* data, size_t n) PANGOLIN_OVERRIDE;
+
+protected:
+    VideoPixelFormat fmt;
+    int quality;
+};
+
+//! Create codec by name for stream, or return 0 for "raw" / "".
+//! Encoder settings are taken from options where relevant:
+//!   quality  : JPEG quality in [0,100] (default 90)
+//!   level    : PNG zlib compression level in [0,9] (default 1)
+//!   keyframe : delta codec keyframe interval in frames (default 30)
+//!   tile     : delta codec tile size in pixels (default 16)
+//! Throws VideoException if the codec is unknown or can't encode stream.
+PANGOLIN_EXPORT
+PangoVideoCodec* CreatePangoVideoCodec(const std::string& name, const StreamInfo& stream, const Params& options = Params());
+
+}
+
+#endif // PANGOLIN_PANGO_VIDEO_CODEC_H
@@ -29,23 +29,40 @@
 #define PANGOLIN_PANGO_VIDEO_OUTPUT_H
 
 #include <pangolin/video/video_output.h>
+#include <pangolin/video/drivers/pango_video_codec.h>
 #include <pangolin/log/packetstream.h>
+#include <pangolin/compat/memory.h>
+
+#include <deque>
+#include <map>
 
 namespace pangolin
 {
 
+struct PangoEncodeJob;
+
+//! Record streams to pango log. Streams are stored raw unless a codec
+//! (see CreatePangoVideoCodec) is given for them, by stream index in
+//! stream_codecs, or for all other streams through default_codec.
+//! Encoded frames are compressed concurrently on the DefaultThreadPool
+//! and written in order. With data_alignment_bytes > 1, frame packets start
+//! on that boundary within the file, and the frame information before raw
+//! image data is padded so that the image data does too.
 class PANGOLIN_EXPORT PangoVideoOutput : public VideoOutputInterface
 {
 public:
-    PangoVideoOutput(const std::string& filename);
+    PangoVideoOutput(const std::string& filename, const std::string& default_codec = "", const std::map<size_t,std::string>& stream_codecs = std::map<size_t,std::string>(), const Params& codec_options = Params(), size_t data_alignment_bytes = 1);
     ~PangoVideoOutput();
 
     const std::vector<StreamInfo>& Streams() const PANGOLIN_OVERRIDE;
     void SetStreams(const std::vector<StreamInfo>& streams, const std::string& uri, const json::value& device_properties) PANGOLIN_OVERRIDE;
     int WriteStreams(unsigned char* data, const json::value& frame_properties) PANGOLIN_OVERRIDE;
+    int WriteStreams(unsigned char* data, const json::value& frame_properties, const VideoFrameInfo& frame_info) PANGOLIN_OVERRIDE;
 
 protected:
     void WriteHeader();
+    void QueueEncodedFrame(unsigned char* data, const json::value& frame_properties, const int64_t* info);
+    void WriteEncodedFrames(bool wait);
 
     std::vector<StreamInfo> streams;
     std::string input_uri;
@@ -54,6 +71,25 @@ protected:
     PacketStreamWriter packetstream;
     int packetstreamsrcid;
     size_t total_frame_size;
+    VideoFrameInfo local_frame_info;
+
+    std::string default_codec;
+    std::map<size_t,std::string> stream_codecs;
+    Params codec_options;
+    size_t data_alignment_bytes;
+    size_t frame_info_bytes;
+    std::vector<char> frame_header;
+
+    // Per stream codec, or 0 for raw. Packets are variable size if any are set.
+    std::vector<PangoVideoCodec*> codecs;
+    bool variable_packets;
+    size_t frame_size_bytes;
+
+    // Frames being encoded in capture order, and those available for reuse
+    std::deque<boostd::shared_ptr<PangoEncodeJob> > jobs;
+    std::vector<boostd::shared_ptr<PangoEncodeJob> > free_jobs;
+    size_t max_jobs;
+    std::vector<char> packet;
 };
 
 }
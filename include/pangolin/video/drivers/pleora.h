@@ -49,7 +49,7 @@ namespace pangolin
 
 typedef std::list<PvBuffer *> BufferList;
 
-class PANGOLIN_EXPORT PleoraVideo : public VideoInterface
+class PANGOLIN_EXPORT PleoraVideo : public VideoInterface, public VideoFrameInfoInterface
 {
 public:
 
@@ -69,6 +69,8 @@ public:
 
     bool GrabNewest( unsigned char* image, bool wait = true );
 
+    const VideoFrameInfo& FrameInfo() const;
+
 protected:
     template<typename T>
     T DeviceParam(const char* name);
@@ -78,6 +80,7 @@ protected:
 
     std::vector<StreamInfo> streams;
     size_t size_bytes;
+    VideoFrameInfo frame_info;
 
     // Pleora handles
     PvSystem* lPvSystem;
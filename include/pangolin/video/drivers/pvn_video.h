@@ -37,7 +37,7 @@
 namespace pangolin
 {
 
-class PANGOLIN_EXPORT PvnVideo : public VideoInterface
+class PANGOLIN_EXPORT PvnVideo : public VideoInterface, public VideoFrameInfoInterface
 {
 public:
     PvnVideo(const std::string& filename, bool realtime = false);
@@ -60,6 +60,9 @@ public:
     
     //! Implement VideoInput::GrabNewest()
     bool GrabNewest( unsigned char* image, bool wait = true );
+
+    //! Implement VideoFrameInfoInterface::FrameInfo()
+    const VideoFrameInfo& FrameInfo() const;
     
 protected:
     int frames;
@@ -67,6 +70,7 @@ protected:
 
     std::vector<StreamInfo> streams;
     size_t frame_size_bytes;
+    VideoFrameInfo frame_info;
     
     bool realtime;
     pangolin::basetime frame_interval;
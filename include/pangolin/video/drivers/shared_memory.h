@@ -0,0 +1,163 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef PANGOLIN_SHARED_MEMORY_H
+#define PANGOLIN_SHARED_MEMORY_H
+
+#include <pangolin/platform.h>
+#include <pangolin/video/video.h>
+
+#include <stdint.h>
+#include <string>
+
+namespace pangolin
+{
+
+// Layout of a shm:// frame ring. A single writer publishes frames into a
+// fixed number of slots; any number of readers map the same memory and
+// observe frames without taking locks. Each slot carries the sequence
+// number of the frame it holds, which the writer invalidates before
+// overwriting, so readers can detect being lapped during or before a read.
+//
+// [SharedMemoryHeader][slot 0 header|frame][slot 1 header|frame]...
+
+const uint32_t shm_magic = 0x4d534750; // 'PGSM'
+const uint32_t shm_version = 1;
+const size_t shm_max_streams = 8;
+const size_t shm_format_len = 32;
+const size_t shm_alignment = 64;
+const uint64_t shm_invalid_seq = ~(uint64_t)0;
+
+struct SharedMemoryStream
+{
+    char format[shm_format_len];
+    uint32_t width;
+    uint32_t height;
+    uint64_t pitch;
+    uint64_t offset;
+};
+
+struct SharedMemoryHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t num_slots;
+    uint32_t num_streams;
+    uint64_t frame_size_bytes;
+    uint64_t slot_stride_bytes;
+
+    // Number of frames published so far. Frame n lives in slot n % num_slots.
+    uint64_t write_seq;
+
+    // Non-zero once the writer has gone away.
+    uint32_t closed;
+    uint32_t reserved;
+
+    SharedMemoryStream streams[shm_max_streams];
+};
+
+struct SharedMemorySlot
+{
+    // Sequence number of frame held, or shm_invalid_seq whilst being written
+    uint64_t seq;
+    int64_t host_time_us;
+    int64_t device_time_us;
+    int64_t sequence;
+    int64_t dropped;
+};
+
+inline size_t ShmAlign(size_t n)
+{
+    return (n + shm_alignment - 1) & ~(shm_alignment - 1);
+}
+
+inline size_t ShmHeaderBytes()
+{
+    return ShmAlign(sizeof(SharedMemoryHeader));
+}
+
+inline size_t ShmSlotHeaderBytes()
+{
+    return ShmAlign(sizeof(SharedMemorySlot));
+}
+
+// Lock-free accessors valid between processes sharing the mapping
+inline uint64_t ShmLoadAcquire(const uint64_t* p)
+{
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+inline void ShmStoreRelease(uint64_t* p, uint64_t v)
+{
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+//! Named POSIX shared memory region, mapped into this process
+class PANGOLIN_EXPORT SharedMemoryBuffer
+{
+public:
+    //! Create (owner=true, replacing any stale region) or open existing region.
+    //! size_bytes is ignored when opening; the existing size is mapped.
+    SharedMemoryBuffer(const std::string& name, bool owner, size_t size_bytes = 0);
+    ~SharedMemoryBuffer();
+
+    unsigned char* Ptr() { return ptr; }
+    size_t SizeBytes() const { return size_bytes; }
+
+    SharedMemoryHeader& Header() { return *(SharedMemoryHeader*)ptr; }
+
+    unsigned char* SlotPtr(size_t slot) {
+        return ptr + ShmHeaderBytes() + slot * Header().slot_stride_bytes;
+    }
+
+    SharedMemorySlot& Slot(size_t slot) {
+        return *(SharedMemorySlot*)SlotPtr(slot);
+    }
+
+    unsigned char* SlotFrame(size_t slot) {
+        return SlotPtr(slot) + ShmSlotHeaderBytes();
+    }
+
+protected:
+    std::string name;
+    bool owner;
+    int fd;
+    unsigned char* ptr;
+    size_t size_bytes;
+
+private:
+    SharedMemoryBuffer(const SharedMemoryBuffer&);
+    SharedMemoryBuffer& operator=(const SharedMemoryBuffer&);
+};
+
+//! Name as given to shm_open, with leading slash
+PANGOLIN_EXPORT
+std::string SharedMemoryName(const std::string& name);
+
+}
+
+#endif // PANGOLIN_SHARED_MEMORY_H
@@ -0,0 +1,87 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef PANGOLIN_SHARED_MEMORY_VIDEO_H
+#define PANGOLIN_SHARED_MEMORY_VIDEO_H
+
+#include <pangolin/video/video.h>
+#include <pangolin/video/drivers/shared_memory.h>
+
+namespace pangolin
+{
+
+//! Read frames published by a SharedMemoryVideoOutput in another process.
+//! Readers never block the writer; frames overwritten before they could be
+//! read are skipped and counted in FrameInfo().dropped.
+class PANGOLIN_EXPORT SharedMemoryVideo
+    : public VideoInterface, public VideoFrameInfoInterface
+{
+public:
+    SharedMemoryVideo(const std::string& name);
+    ~SharedMemoryVideo();
+
+    // Implement VideoInterface
+
+    size_t SizeBytes() const PANGOLIN_OVERRIDE;
+
+    const std::vector<StreamInfo>& Streams() const PANGOLIN_OVERRIDE;
+
+    void Start() PANGOLIN_OVERRIDE;
+
+    void Stop() PANGOLIN_OVERRIDE;
+
+    bool GrabNext( unsigned char* image, bool wait = true ) PANGOLIN_OVERRIDE;
+
+    bool GrabNewest( unsigned char* image, bool wait = true ) PANGOLIN_OVERRIDE;
+
+    // Implement VideoFrameInfoInterface
+
+    const VideoFrameInfo& FrameInfo() const PANGOLIN_OVERRIDE;
+
+    //! Access next frame in place without copying. Returns 0 if no frame is
+    //! available. The frame may be overwritten by the writer at any time, so
+    //! check IsValid(seq) once finished with the data.
+    const unsigned char* MapNext(uint64_t& seq, bool wait = true);
+
+    //! Returns true if frame seq has not been overwritten since it was mapped.
+    bool IsValid(uint64_t seq);
+
+protected:
+    bool WaitForFrame(bool wait);
+    bool CopyFrame(uint64_t seq, unsigned char* image);
+
+    SharedMemoryBuffer shm;
+    std::vector<StreamInfo> streams;
+    size_t size_bytes;
+    uint64_t next_seq;
+    int64_t lapped;
+    VideoFrameInfo frame_info;
+};
+
+}
+
+#endif // PANGOLIN_SHARED_MEMORY_VIDEO_H
@@ -35,7 +35,7 @@ namespace pangolin
 {
 
 // Video class that debayers its video input using the given method.
-class PANGOLIN_EXPORT ShiftVideo : public VideoInterface, public VideoFilterInterface
+class PANGOLIN_EXPORT ShiftVideo : public VideoInterface, public VideoFilterInterface, public VideoFrameInfoInterface
 {
 public:
     ShiftVideo(VideoInterface* videoin, VideoPixelFormat new_fmt, int shift_right_bits = 0, unsigned int mask = 0xFFFF);
@@ -61,10 +61,14 @@ public:
 
     std::vector<VideoInterface*>& InputStreams();
 
+    //! Implement VideoFrameInfoInterface::FrameInfo()
+    const VideoFrameInfo& FrameInfo() const;
+
 protected:
     std::vector<VideoInterface*> videoin;
     std::vector<StreamInfo> streams;
     size_t size_bytes;
+    VideoFrameInfo frame_info;
     unsigned char* buffer;
     int shift_right_bits;
     unsigned int mask;
@@ -37,7 +37,7 @@ namespace pangolin
 {
 
 // Video class that outputs test video signal.
-class PANGOLIN_EXPORT TeliVideo : public VideoInterface
+class PANGOLIN_EXPORT TeliVideo : public VideoInterface, public VideoFrameInfoInterface
 {
 public:
     TeliVideo();
@@ -62,6 +62,11 @@ public:
     //! Implement VideoInput::GrabNewest()
     bool GrabNewest( unsigned char* image, bool wait = true );
 
+    //! Implement VideoFrameInfoInterface::FrameInfo()
+    inline const VideoFrameInfo& FrameInfo() const {
+        return frame_info;
+    }
+
     inline Teli::CAM_HANDLE GetCameraHandle() {
         return cam;
     }
@@ -79,6 +84,7 @@ protected:
     Teli::CAM_HANDLE cam;
     Teli::CAM_STRM_HANDLE strm;
     HANDLE hStrmCmpEvt;
+    VideoFrameInfo frame_info;
 };
 
 }
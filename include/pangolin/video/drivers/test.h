@@ -34,11 +34,35 @@
 namespace pangolin
 {
 
+//! Pattern generated by TestVideo. All patterns are deterministic functions
+//! of frame number, so output can be verified downstream.
+enum TestVideoPattern
+{
+    //! Pseudo-random noise (xorshift, seeded by frame number)
+    TestVideoRandom,
+    //! Diagonal byte ramp moving one byte per frame
+    TestVideoGradient,
+    //! Vertical black / white bars moving horizontally
+    TestVideoBars,
+    //! RGGB Bayer mosaic of a colour gradient (8 or 16 bit formats)
+    TestVideoBayer
+};
+
+PANGOLIN_EXPORT
+TestVideoPattern TestVideoPatternFromString(const std::string& pattern);
+
 // Video class that outputs test video signal.
-class PANGOLIN_EXPORT TestVideo : public VideoInterface
+class PANGOLIN_EXPORT TestVideo : public VideoInterface, public VideoFrameInfoInterface
 {
 public:
-    TestVideo(size_t w, size_t h, size_t n, std::string pix_fmt);
+    //! fps=0 generates frames as fast as they are requested. jitter_us
+    //! delays each frame's arrival by up to this amount, emulating a real
+    //! camera. If counter is set, the sequence number is burnt into the top
+    //! left of each stream as 64 blocks of 8x8 pixels (msb first), white
+    //! for set bits.
+    TestVideo(size_t w, size_t h, size_t n, std::string pix_fmt,
+              TestVideoPattern pattern = TestVideoRandom, double fps = 0.0,
+              int64_t jitter_us = 0, bool counter = false);
     ~TestVideo();
     
     //! Implement VideoInput::Start()
@@ -58,10 +82,29 @@ public:
     
     //! Implement VideoInput::GrabNewest()
     bool GrabNewest( unsigned char* image, bool wait = true );
+
+    //! Implement VideoFrameInfoInterface::FrameInfo()
+    const VideoFrameInfo& FrameInfo() const;
     
 protected:
+    void Generate(unsigned char* image, int64_t frame);
+    void BurnCounter(Image<unsigned char>& img, size_t bpp, int64_t frame);
+    bool WaitForFrame(int64_t frame, bool wait);
+
     std::vector<StreamInfo> streams;
     size_t size_bytes;
+    VideoFrameInfo frame_info;
+
+    TestVideoPattern pattern;
+    int64_t period_us;
+    int64_t jitter_us;
+    bool counter;
+
+    // Precomputed data that patterns copy from
+    std::vector<unsigned char> ramp;
+
+    int64_t start_us;
+    int64_t next_frame;
 };
 
 }
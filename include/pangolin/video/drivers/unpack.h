@@ -30,13 +30,14 @@
 
 #include <pangolin/pangolin.h>
 #include <pangolin/video/video.h>
+#include <pangolin/image/image_convert.h>
 
 namespace pangolin
 {
 
 // Video class that debayers its video input using the given method.
 class PANGOLIN_EXPORT UnpackVideo :
-    public VideoInterface, public VideoFilterInterface
+    public VideoInterface, public VideoFilterInterface, public VideoFrameInfoInterface
 {
 public:
     UnpackVideo(VideoInterface* videoin, VideoPixelFormat new_fmt);
@@ -62,11 +63,16 @@ public:
 
     std::vector<VideoInterface*>& InputStreams();
 
+    //! Implement VideoFrameInfoInterface::FrameInfo()
+    const VideoFrameInfo& FrameInfo() const;
+
 protected:
     std::vector<VideoInterface*> videoin;
     std::vector<StreamInfo> streams;
     size_t size_bytes;
+    VideoFrameInfo frame_info;
     unsigned char* buffer;
+    std::vector<PixelConvertFunc> converters;
 };
 
 }
@@ -44,7 +44,7 @@ typedef struct timeval {
 namespace pangolin
 {
 
-class PANGOLIN_EXPORT UvcVideo : public VideoInterface, public VideoUvcInterface
+class PANGOLIN_EXPORT UvcVideo : public VideoInterface, public VideoUvcInterface, public VideoFrameInfoInterface
 {
 public:
     UvcVideo(int vendor_id, int product_id, const char* sn, int deviceid, int width, int height, int fps);
@@ -74,6 +74,9 @@ public:
     //! Implement VideoUvcInterface::GetCtrl()
     int IoCtrl(uint8_t unit, uint8_t ctrl, unsigned char* data, int len, UvcRequestCode req_code);
 
+    //! Implement VideoFrameInfoInterface::FrameInfo()
+    const VideoFrameInfo& FrameInfo() const;
+
 protected:
     static uvc_error_t FindDevice(
         uvc_context_t *ctx, uvc_device_t **dev,
@@ -88,6 +91,7 @@ protected:
     uvc_stream_handle* strm_;
     uvc_stream_ctrl_t ctrl_;
     uvc_frame_t* frame_;
+    VideoFrameInfo frame_info;
 };
 
 }
@@ -48,7 +48,7 @@ struct buffer {
     size_t length;
 };
 
-class PANGOLIN_EXPORT V4lVideo : public VideoInterface, public VideoUvcInterface
+class PANGOLIN_EXPORT V4lVideo : public VideoInterface, public VideoUvcInterface, public VideoFrameInfoInterface
 {
 public:
     V4lVideo(const char* dev_name, io_method io = IO_METHOD_MMAP, unsigned iwidth=0, unsigned iheight=0);
@@ -75,6 +75,9 @@ public:
     //! Implement VideoUvcInterface::IoCtrl()
     int IoCtrl(uint8_t unit, uint8_t ctrl, unsigned char* data, int len, UvcRequestCode req_code);
 
+    //! Implement VideoFrameInfoInterface::FrameInfo()
+    const VideoFrameInfo& FrameInfo() const;
+
     int GetFileDescriptor() const{
         return fd;
     }
@@ -104,6 +107,9 @@ protected:
     unsigned height;
     float fps;
     size_t image_size;
+
+    VideoFrameInfo frame_info;
+    int64_t last_device_sequence;
 };
 
 }
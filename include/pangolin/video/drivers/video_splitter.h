@@ -35,7 +35,7 @@ namespace pangolin
 {
 
 class PANGOLIN_EXPORT VideoSplitter
-    : public VideoInterface, public VideoFilterInterface
+    : public VideoInterface, public VideoFilterInterface, public VideoFrameInfoInterface
 {
 public:
     VideoSplitter(VideoInterface* videoin, const std::vector<StreamInfo>& streams);
@@ -55,10 +55,13 @@ public:
     bool GrabNewest( unsigned char* image, bool wait = true );
 
     std::vector<VideoInterface*>& InputStreams();
+
+    const VideoFrameInfo& FrameInfo() const;
     
 protected:
     std::vector<VideoInterface*> videoin;
     std::vector<StreamInfo> streams;
+    VideoFrameInfo frame_info;
 };
 
 
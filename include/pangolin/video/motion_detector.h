@@ -0,0 +1,78 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef PANGOLIN_MOTION_DETECTOR_H
+#define PANGOLIN_MOTION_DETECTOR_H
+
+#include <pangolin/platform.h>
+#include <pangolin/image/image.h>
+
+#include <vector>
+
+namespace pangolin
+{
+
+//! Sum of absolute differences between two byte arrays.
+PANGOLIN_EXPORT
+size_t SumAbsDiff(const unsigned char* a, const unsigned char* b, size_t n);
+
+//! Cheap frame-difference motion detector.
+//! Each processed frame is compared against the previous one over every
+//! row_step'th row. Rows are split into 16 byte blocks, and a block counts
+//! as changed when its mean absolute difference exceeds level. Motion is
+//! reported when the fraction of changed blocks exceeds area.
+class PANGOLIN_EXPORT MotionDetector
+{
+public:
+    MotionDetector(double level = 16.0, double area = 0.01, size_t row_step = 4);
+
+    //! Compare image against the previous one and retain it for next time.
+    //! Pixels are treated as raw bytes, so any 8 bit per channel format
+    //! works without conversion. Returns true if motion is detected.
+    bool Process(const Image<unsigned char>& img, size_t bytes_per_pixel = 1);
+
+    //! Fraction of changed blocks in last processed image
+    double Score() const { return score; }
+
+    //! Forget reference image, so next call to Process won't detect motion
+    void Reset();
+
+protected:
+    double level;
+    double area;
+    size_t row_step;
+
+    size_t ref_w;
+    size_t ref_h;
+    std::vector<unsigned char> reference;
+    double score;
+};
+
+}
+
+#endif // PANGOLIN_MOTION_DETECTOR_H
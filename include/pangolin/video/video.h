@@ -39,6 +39,9 @@
 // files - read one or more streams from image files
 // e.g.  "files://~/data/dataset/img_*.jpg"
 // e.g.  "files://~/data/dataset/img_[left,right]_*.pgm"
+//  JPEGs can be decoded at reduced size (scale=1/2, 1/4 or 1/8) and with
+//  a faster, less accurate IDCT (fast=1)
+// e.g.  "files:[scale=1/4,fast=1]//~/data/dataset/img_*.jpg"
 //
 // file/files - read PVN file format (pangolin video) or other formats using ffmpeg
 //  e.g. "file:[realtime=1]///home/user/video/movie.pvn"
@@ -86,6 +89,9 @@
 // mjpeg - capture from (possibly networked) motion jpeg stream using FFMPEG
 //  e.g. "mjpeg://http://127.0.0.1/?action=stream"
 //
+// shm - read frames published to POSIX shared memory by another process (Linux)
+//  e.g. "shm://camera0"
+//
 // split - split an input video into a one or more streams based on Region of Interest / memory specification
 //           roiN=X+Y+WxH
 //           memN=Offset:WxH:PitchBytes:Format
@@ -95,15 +101,21 @@
 // debayer - debayer an input video stream
 // e.g.  "debayer://v4l:///dev/video0
 //
-// test - output test video sequence
+// test - output deterministic test video sequence
+//           pattern=random|gradient|bars|bayer
+//           fps : emulated frame rate (default unlimited)
+//           jitter : maximum random delay of each frame in microseconds
+//           counter : burn frame sequence number into top left of image
 //  e.g. "test://"
 //  e.g. "test:[size=640x480,fmt=RGB24]//"
+//  e.g. "test:[size=1280x1024,fmt=GRAY8,pattern=bayer,fps=60,jitter=500,counter=1]//"
 
 #include <pangolin/image/image.h>
 #include <pangolin/image/image_common.h>
 #include <pangolin/utils/picojson.h>
 
 #include <vector>
+#include <stdint.h>
 
 namespace pangolin
 {
@@ -181,6 +193,35 @@ struct PANGOLIN_EXPORT VideoInterface
     virtual bool GrabNewest( unsigned char* image, bool wait = true ) = 0;
 };
 
+//! Timing and sequence information for a single captured frame
+struct PANGOLIN_EXPORT VideoFrameInfo
+{
+    inline VideoFrameInfo()
+        : host_time_us(0), device_time_us(-1), sequence(-1), dropped(0) {}
+
+    //! Record arrival of a new frame on the host, with optional device
+    //! timestamp and number of frames known to have been lost since the last.
+    void Arrived(int64_t device_time_us = -1, int64_t dropped_since_last = 0);
+
+    //! Host clock time (Time_us(TimeNow())) at which frame was received
+    int64_t host_time_us;
+
+    //! Device clock timestamp in microseconds, or -1 if unavailable
+    int64_t device_time_us;
+
+    //! Monotonic frame sequence number, starting from 0
+    int64_t sequence;
+
+    //! Total number of frames known to have been dropped so far
+    int64_t dropped;
+};
+
+struct PANGOLIN_EXPORT VideoFrameInfoInterface
+{
+    //! Access timing information of most recently captured frame
+    virtual const VideoFrameInfo& FrameInfo() const = 0;
+};
+
 struct PANGOLIN_EXPORT VideoPropertiesInterface
 {
     //! Access JSON properties of device
@@ -246,7 +287,7 @@ struct PANGOLIN_EXPORT VideoPlaybackInterface
 };
 
 //! Generic wrapper class for different video sources
-struct PANGOLIN_EXPORT VideoInput : public VideoInterface
+struct PANGOLIN_EXPORT VideoInput : public VideoInterface, public VideoFrameInfoInterface
 {
     VideoInput();
     VideoInput(const std::string& uri);
@@ -269,6 +310,8 @@ struct PANGOLIN_EXPORT VideoInput : public VideoInterface
     bool GrabNext( unsigned char* image, bool wait = true );
     bool GrabNewest( unsigned char* image, bool wait = true );
 
+    const VideoFrameInfo& FrameInfo() const;
+
     // Return pointer to inner video class as VideoType
     template<typename VideoType>
     VideoType* Cast() {
@@ -281,8 +324,14 @@ struct PANGOLIN_EXPORT VideoInput : public VideoInterface
 protected:
     Uri uri;
     VideoInterface* video;
+    VideoFrameInfo frame_info;
 };
 
+//! Update frame information of a filter from its source, or record the
+//! arrival time directly if source doesn't provide frame information.
+PANGOLIN_EXPORT
+void UpdateFrameInfoFromSource(VideoFrameInfo& info, VideoInterface* src);
+
 //! Open Video Interface from string specification (as described in this files header)
 PANGOLIN_EXPORT
 VideoInterface* OpenVideo(const std::string& uri);
@@ -34,7 +34,36 @@
 // VideoOutput URI's take the following form:
 //  scheme:[param1=value1,param2=value2,...]//device
 //
-// scheme = ffmpeg
+// scheme = pango | files | ffmpeg | shm | event
+//
+// pango - record streams into a pango log
+//  codec : encoding used for every stream, raw if unspecified. Supported:
+//          depth - lossless compression of 16 bit single channel images
+//          png   - lossless compression of 8 bit or GRAY16LE images
+//          jpeg  - lossy compression of GRAY8 or RGB24 images
+//          delta - lossless, stores only tiles changed since last frame
+//  codecN : encoding used for stream N only
+//  quality : jpeg quality in [0,100] (default 90)
+//  level : png zlib compression level in [0,9] (default 1)
+//  keyframe : delta keyframe interval in frames, 0 for first only (default 30)
+//  tile : delta tile size in pixels (default 16)
+//  alignment : byte boundary for frame data within the file (default 1)
+//
+//  e.g. pango://output.pango
+//  e.g. pango:[codec1=depth]//rgbd.pango
+//  e.g. pango:[codec0=jpeg,quality=80,codec1=depth]//rgbd.pango
+//  e.g. pango:[codec=delta,keyframe=100]//static_camera.pango
+//
+// files - write each frame of each stream to a numbered image file, encoding
+//         on a pool of threads. The path holds one printf style frame number
+//         conversion; use [a,b] for one path per stream. Type by extension.
+//  start : number of first frame (default 0)
+//  pending : frames queued for encoding before writing blocks (default 16)
+//  quality : jpeg quality in [0,100] (default 90)
+//  level : png zlib compression level in [0,9] (default libpng's)
+//
+//  e.g. files://dataset/frame_%06d.png
+//  e.g. files:[quality=95,start=1]//dataset/[rgb/%05d.jpg,depth/%05d.png]
 //
 // ffmpeg - encode to compressed file using ffmpeg
 //  fps : fps to embed in encoded file.
@@ -43,6 +72,23 @@
 //
 //  e.g. ffmpeg://output_file.avi
 //  e.g. ffmpeg:[fps=30,bps=1000000,unique_filename]//output_file.avi
+//
+// shm - publish frames to a POSIX shared memory ring for other processes (Linux)
+//  slots : number of frames held in the ring
+//
+//  e.g. shm://camera0
+//  e.g. shm:[slots=8]//camera0
+//
+// event - keep a pre-roll ring in memory and only record around events
+//  preroll : seconds of video kept from before each event
+//  postroll : seconds to continue recording once the scene goes quiet
+//  motion : detect events by frame difference of first stream (default true)
+//  level : mean absolute difference of a 16 byte block to count as changed
+//  area : fraction of changed blocks which constitutes motion
+//  row_step : only compare every row_step'th row
+//
+//  e.g. event://pango://events.pango
+//  e.g. event:[preroll=10,postroll=5,area=0.02]//events.pango
 
 #include <pangolin/video/video.h>
 
@@ -60,6 +106,13 @@ struct PANGOLIN_EXPORT VideoOutputInterface
     virtual void SetStreams(const std::vector<StreamInfo>& streams, const std::string& uri ="", const json::value& properties = json::value() ) = 0;
 
     virtual int WriteStreams(unsigned char* data, const json::value& frame_properties ) = 0;
+
+    //! Write frame along with its capture information. Outputs which
+    //! can't store frame information just ignore it.
+    virtual int WriteStreams(unsigned char* data, const json::value& frame_properties, const VideoFrameInfo& /*frame_info*/ )
+    {
+        return WriteStreams(data, frame_properties);
+    }
 };
 
 //! VideoOutput wrap to generically construct instances of VideoOutputInterface.
@@ -79,6 +132,8 @@ public:
     void SetStreams(const std::vector<StreamInfo>& streams, const std::string& uri = "", const json::value& properties = json::value() );
 
     int WriteStreams(unsigned char* data, const json::value& frame_properties = json::value() );
+
+    int WriteStreams(unsigned char* data, const json::value& frame_properties, const VideoFrameInfo& frame_info );
     
 protected:
     Uri uri;
@@ -0,0 +1,120 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef PANGOLIN_VIDEO_OUTPUT_ASYNC_H
+#define PANGOLIN_VIDEO_OUTPUT_ASYNC_H
+
+#include <pangolin/video/video_output.h>
+#include <pangolin/compat/thread.h>
+#include <pangolin/compat/mutex.h>
+#include <pangolin/compat/condition_variable.h>
+
+#include <deque>
+
+namespace pangolin
+{
+
+//! What AsyncVideoOutput does with a frame when its queue is full
+enum AsyncVideoOutputPolicy
+{
+    //! Wait for the writer thread to make space
+    AsyncVideoOutputBlock,
+    //! Discard the new frame, counting it as dropped
+    AsyncVideoOutputDrop
+};
+
+//! Snapshot of AsyncVideoOutput queue statistics
+struct PANGOLIN_EXPORT AsyncVideoOutputStats
+{
+    AsyncVideoOutputStats()
+        : queued(0), max_queued(0), depth(0), written(0), dropped(0) {}
+
+    size_t queued;
+    size_t max_queued;
+    size_t depth;
+    int64_t written;
+    int64_t dropped;
+};
+
+//! Write frames to another VideoOutputInterface from a background thread.
+//! WriteStreams copies each frame into a pooled buffer and returns
+//! immediately, so stalls in the output don't stall capture. Errors from
+//! the wrapped output are rethrown from the next call to WriteStreams.
+class PANGOLIN_EXPORT AsyncVideoOutput : public VideoOutputInterface
+{
+public:
+    //! Takes ownership of output.
+    AsyncVideoOutput(VideoOutputInterface* output, size_t queue_depth = 32, AsyncVideoOutputPolicy policy = AsyncVideoOutputBlock);
+
+    //! Waits for queued frames to be written.
+    ~AsyncVideoOutput();
+
+    const std::vector<StreamInfo>& Streams() const PANGOLIN_OVERRIDE;
+    void SetStreams(const std::vector<StreamInfo>& streams, const std::string& uri, const json::value& device_properties) PANGOLIN_OVERRIDE;
+    int WriteStreams(unsigned char* data, const json::value& frame_properties) PANGOLIN_OVERRIDE;
+    int WriteStreams(unsigned char* data, const json::value& frame_properties, const VideoFrameInfo& frame_info) PANGOLIN_OVERRIDE;
+
+    //! Wrapped output
+    VideoOutputInterface* Output() { return output; }
+
+    AsyncVideoOutputStats Stats() const;
+
+    //! Writer thread body
+    void operator()();
+
+protected:
+    struct QueuedFrame
+    {
+        std::vector<unsigned char> data;
+        json::value frame_properties;
+        VideoFrameInfo frame_info;
+    };
+
+    VideoOutputInterface* output;
+    size_t frame_size_bytes;
+    size_t depth;
+    AsyncVideoOutputPolicy policy;
+
+    std::deque<QueuedFrame*> queue;
+    std::vector<QueuedFrame*> pool;
+    mutable boostd::mutex queue_mutex;
+    boostd::condition_variable cond_pushed;
+    boostd::condition_variable cond_popped;
+
+    size_t max_queued;
+    int64_t written;
+    int64_t dropped;
+    std::string error;
+
+    boostd::thread write_thread;
+    bool should_run;
+};
+
+}
+
+#endif // PANGOLIN_VIDEO_OUTPUT_ASYNC_H
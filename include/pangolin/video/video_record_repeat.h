@@ -30,12 +30,13 @@
 
 #include <pangolin/video/video.h>
 #include <pangolin/video/video_output.h>
+#include <pangolin/video/video_output_async.h>
 
 namespace pangolin
 {
 
 struct PANGOLIN_EXPORT VideoRecordRepeat
-    : public VideoInterface, public VideoPropertiesInterface
+    : public VideoInterface, public VideoPropertiesInterface, public VideoFrameInfoInterface
 {
     VideoRecordRepeat();
     VideoRecordRepeat(const std::string &input_uri, const std::string &output_uri = "video_log.pango", int buffer_size_bytes = 10240000);
@@ -73,6 +74,8 @@ struct PANGOLIN_EXPORT VideoRecordRepeat
     const json::value& DeviceProperties() const;
     const json::value& FrameProperties() const;
 
+    const VideoFrameInfo& FrameInfo() const;
+
     /////////////////////////////////////////////////////////////
     // VideoInput Methods
     /////////////////////////////////////////////////////////////
@@ -95,6 +98,19 @@ struct PANGOLIN_EXPORT VideoRecordRepeat
     void Record();
     void Play(bool realtime = true);
     void Source();
+
+    //! Signal an external event to an event:// recorder, committing its
+    //! pre-roll and subsequent frames. No effect for other recorders.
+    void Trigger();
+
+    //! Configure background recording queue used by subsequent calls to
+    //! Record(). queue_depth of 0 writes frames synchronously on the
+    //! grabbing thread.
+    void SetRecordQueue(size_t queue_depth, AsyncVideoOutputPolicy policy = AsyncVideoOutputBlock);
+
+    //! Queue statistics of current recording (zero if not recording
+    //! or recording synchronously)
+    AsyncVideoOutputStats RecordStats() const;
     
     
     bool IsRecording() const;
@@ -107,6 +123,7 @@ protected:
     std::string str_uri_input;
     Uri uri_input;
     Uri uri_output;
+    std::string log_filename;
 
     VideoInterface* video_src;
     VideoPropertiesInterface* video_src_props;
@@ -114,7 +131,12 @@ protected:
     VideoInterface* video_file;
     VideoPropertiesInterface* video_file_props;
     VideoOutputInterface* video_recorder;
+    AsyncVideoOutput* video_recorder_async;
+    size_t record_queue_depth;
+    AsyncVideoOutputPolicy record_policy;
     
+    VideoFrameInfo frame_info;
+
     int buffer_size_bytes;
     
     int frame_num;
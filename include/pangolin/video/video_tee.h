@@ -0,0 +1,192 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef PANGOLIN_VIDEO_TEE_H
+#define PANGOLIN_VIDEO_TEE_H
+
+#include <pangolin/video/video.h>
+#include <pangolin/compat/memory.h>
+#include <pangolin/compat/thread.h>
+#include <pangolin/compat/mutex.h>
+#include <pangolin/compat/condition_variable.h>
+
+#include <deque>
+
+namespace pangolin
+{
+
+//! What a tee consumer does when its queue is full
+enum VideoTeePolicy
+{
+    //! Stall capture until this consumer catches up (affects all consumers)
+    VideoTeeBlock,
+    //! Discard the oldest queued frame to make room
+    VideoTeeDropOldest,
+    //! Keep only the most recent frame, irrespective of queue depth
+    VideoTeeNewestOnly
+};
+
+//! Captured frame, shared by reference between tee consumers
+struct PANGOLIN_EXPORT VideoTeeFrame
+{
+    std::vector<unsigned char> data;
+    VideoFrameInfo info;
+};
+
+typedef boostd::shared_ptr<const VideoTeeFrame> VideoTeeFramePtr;
+
+class VideoTee;
+
+//! Shared by a tee and its consumers, so that consumers which outlive the
+//! tee can tell it has gone. Held whilst a consumer uses tee, and taken
+//! before (never whilst holding) any tee or consumer queue lock.
+struct PANGOLIN_EXPORT VideoTeeLink
+{
+    VideoTeeLink(VideoTee* tee) : tee(tee) {}
+    boostd::mutex mutex;
+    VideoTee* tee;
+};
+
+//! Independent view of a VideoTee source with its own queue.
+//! Created by VideoTee::AddConsumer and owned by the caller.
+class PANGOLIN_EXPORT VideoTeeConsumer
+    : public VideoInterface, public VideoFrameInfoInterface
+{
+public:
+    friend class VideoTee;
+
+    ~VideoTeeConsumer();
+
+    // Implement VideoInterface
+
+    size_t SizeBytes() const PANGOLIN_OVERRIDE;
+
+    const std::vector<StreamInfo>& Streams() const PANGOLIN_OVERRIDE;
+
+    //! Begin receiving frames (consumers are started when created)
+    void Start() PANGOLIN_OVERRIDE;
+
+    //! Stop receiving frames and discard those queued
+    void Stop() PANGOLIN_OVERRIDE;
+
+    bool GrabNext( unsigned char* image, bool wait = true ) PANGOLIN_OVERRIDE;
+
+    bool GrabNewest( unsigned char* image, bool wait = true ) PANGOLIN_OVERRIDE;
+
+    // Implement VideoFrameInfoInterface
+
+    const VideoFrameInfo& FrameInfo() const PANGOLIN_OVERRIDE;
+
+    //! Take next queued frame without copying. Returns empty pointer if
+    //! no frame is available or the source has ended.
+    VideoTeeFramePtr Next(bool wait = true);
+
+    //! Take most recent queued frame without copying, discarding older ones.
+    VideoTeeFramePtr Newest(bool wait = true);
+
+    //! Number of frames this consumer has discarded due to its policy
+    int64_t Dropped() const;
+
+protected:
+    VideoTeeConsumer(VideoTee* tee, size_t depth, VideoTeePolicy policy);
+
+    // Called from tee capture thread
+    bool Full() const;
+    void Push(const VideoTeeFramePtr& frame);
+    void Close();
+    void NotifyTee();
+
+    boostd::shared_ptr<VideoTeeLink> link;
+    std::vector<StreamInfo> streams;
+    size_t size_bytes;
+    size_t depth;
+    VideoTeePolicy policy;
+
+    std::deque<VideoTeeFramePtr> queue;
+    mutable boostd::mutex queue_mutex;
+    boostd::condition_variable cond_pushed;
+    boostd::condition_variable cond_popped;
+    bool receiving;
+    bool closed;
+    int64_t dropped;
+
+    VideoFrameInfo frame_info;
+};
+
+//! Capture from one source on a background thread and distribute each
+//! frame, without copying, to any number of consumers.
+//! e.g. a 60Hz recorder with VideoTeeBlock and a 10Hz preview with
+//! VideoTeeNewestOnly fed from the same camera.
+class PANGOLIN_EXPORT VideoTee
+{
+public:
+    friend class VideoTeeConsumer;
+
+    //! Takes ownership of src.
+    VideoTee(VideoInterface* src);
+    ~VideoTee();
+
+    //! Create new consumer handle, owned by caller. Consumers may outlive
+    //! the tee, after which they provide no more frames.
+    VideoTeeConsumer* AddConsumer(size_t queue_depth = 2, VideoTeePolicy policy = VideoTeeDropOldest);
+
+    //! Start source and capture thread. Capture ends, closing consumers
+    //! once their queues drain, when the source fails to provide a frame.
+    void Start();
+
+    //! Stop source and capture thread, closing consumers as above. The
+    //! source is stopped first so that a capture waiting in its GrabNext
+    //! returns, which the source must allow.
+    void Stop();
+
+    VideoInterface* Source() { return src; }
+
+    //! Capture thread body
+    void operator()();
+
+protected:
+    void RemoveConsumer(VideoTeeConsumer* consumer);
+    boostd::shared_ptr<VideoTeeFrame> FreeFrame();
+
+    VideoInterface* src;
+    VideoFrameInfo src_info;
+    boostd::shared_ptr<VideoTeeLink> link;
+    std::vector<VideoTeeConsumer*> consumers;
+    boostd::mutex consumers_mutex;
+    boostd::condition_variable cond_space;
+
+    // Frames recycled once no consumer references them
+    std::vector<boostd::shared_ptr<VideoTeeFrame> > pool;
+
+    boostd::thread capture_thread;
+    bool should_run;
+    bool running;
+};
+
+}
+
+#endif // PANGOLIN_VIDEO_TEE_H
@@ -46,6 +46,7 @@
 #include <pangolin/utils/timer.h>
 #include <pangolin/utils/type_convert.h>
 #include <pangolin/image/image_io.h>
+#include <pangolin/image/image_writer.h>
 
 #ifdef BUILD_PANGOLIN_VARS
   #include <pangolin/var/var.h>
@@ -256,8 +257,7 @@ void SaveFramebuffer(std::string prefix, const Viewport& v)
     glReadBuffer(GL_BACK);
     glPixelStorei(GL_PACK_ALIGNMENT, 1); // TODO: Avoid this?
     glReadPixels(v.l, v.b, v.w, v.h, GL_RGBA, GL_UNSIGNED_BYTE, buffer.ptr );
-    SaveImage(buffer, fmt, prefix + ".png", false);
-    buffer.Dealloc();
+    DefaultImageWriter().Save(buffer, fmt, prefix + ".png", false);
 #endif // HAVE_PNG
     
 #endif // HAVE_GLES
@@ -31,6 +31,7 @@
 #include <pangolin/display/display_internal.h>
 #include <pangolin/display/view.h>
 #include <pangolin/display/viewport.h>
+#include <pangolin/image/image_writer.h>
 
 #include <stdexcept>
 
@@ -95,8 +96,7 @@ void SaveViewFromFbo(std::string prefix, View& view, float scale)
     glReadBuffer(GL_BACK);
     glPixelStorei(GL_PACK_ALIGNMENT, 1); // TODO: Avoid this?
     glReadPixels(0,0,w,h, GL_RGBA, GL_UNSIGNED_BYTE, buffer.ptr );
-    SaveImage(buffer, fmt, prefix + ".png", false);
-    buffer.Dealloc();
+    DefaultImageWriter().Save(buffer, fmt, prefix + ".png", false);
 #endif // HAVE_PNG
     
     // unbind FBO
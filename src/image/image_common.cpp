@@ -49,12 +49,49 @@ const VideoPixelFormat SupportedVideoPixelFormats[] =
     {"",0,{0,0,0,0},0,0}
 };
 
+// Table and PixelFormatId enum must be kept in step
+typedef char SupportedVideoPixelFormatsMatchesIds[
+    (sizeof(SupportedVideoPixelFormats) / sizeof(VideoPixelFormat) == PixelFormatCount + 1) ? 1 : -1
+];
+
+typedef std::map<std::string, PixelFormatId> PixelFormatIndex;
+
+static PixelFormatIndex BuildPixelFormatIndex()
+{
+    PixelFormatIndex index;
+    for(int i=0; i < PixelFormatCount; ++i) {
+        index[SupportedVideoPixelFormats[i].format] = (PixelFormatId)i;
+    }
+    return index;
+}
+
+PixelFormatId PixelFormatIdFromString(const std::string& format)
+{
+    static const PixelFormatIndex index = BuildPixelFormatIndex();
+    const PixelFormatIndex::const_iterator it = index.find(format);
+    return it != index.end() ? it->second : PixelFormatUnknown;
+}
+
+PixelFormatId PixelFormatIdFromFormat(const VideoPixelFormat& fmt)
+{
+    return PixelFormatIdFromString(fmt.format);
+}
+
+const VideoPixelFormat& VideoFormatFromId(PixelFormatId id)
+{
+    if(id < 0 || id >= PixelFormatCount) {
+        throw VideoException("Unknown Format Id");
+    }
+    return SupportedVideoPixelFormats[id];
+}
+
 VideoPixelFormat VideoFormatFromString(const std::string& format)
 {
-    for(int i=0; !SupportedVideoPixelFormats[i].format.empty(); ++i)
-        if(!format.compare(SupportedVideoPixelFormats[i].format))
-            return SupportedVideoPixelFormats[i];
-    throw VideoException("Unknown Format",format);
+    const PixelFormatId id = PixelFormatIdFromString(format);
+    if(id == PixelFormatUnknown) {
+        throw VideoException("Unknown Format",format);
+    }
+    return SupportedVideoPixelFormats[id];
 }
 
 }
@@ -0,0 +1,209 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <pangolin/image/image_convert.h>
+#include "image_convert_kernels.h"
+#include <pangolin/compat/mutex.h>
+
+namespace pangolin
+{
+
+template<typename T>
+void ConvertFrom10bit(
+    Image<unsigned char>& out,
+    const Image<unsigned char>& in
+) {
+    for(size_t r=0; r<out.h; ++r) {
+        T* pout = (T*)(out.ptr + r*out.pitch);
+        uint8_t* pin = in.ptr + r*in.pitch;
+        const uint8_t* pin_end = in.ptr + (r+1)*in.pitch;
+        while(pin != pin_end) {
+            uint64_t val = *(pin++);
+            val |= uint64_t(*(pin++)) << 8;
+            val |= uint64_t(*(pin++)) << 16;
+            val |= uint64_t(*(pin++)) << 24;
+            val |= uint64_t(*(pin++)) << 32;
+            *(pout++) = T( val & 0x00000003FF);
+            *(pout++) = T((val & 0x00000FFC00) >> 10);
+            *(pout++) = T((val & 0x003FF00000) >> 20);
+            *(pout++) = T((val & 0xFFC0000000) >> 30);
+        }
+    }
+}
+
+template<typename T>
+void ConvertFrom12bit(
+    Image<unsigned char>& out,
+    const Image<unsigned char>& in
+) {
+    for(size_t r=0; r<out.h; ++r) {
+        T* pout = (T*)(out.ptr + r*out.pitch);
+        uint8_t* pin = in.ptr + r*in.pitch;
+        const uint8_t* pin_end = in.ptr + (r+1)*in.pitch;
+        while(pin != pin_end) {
+            uint32_t val = *(pin++);
+            val |= uint32_t(*(pin++)) << 8;
+            val |= uint32_t(*(pin++)) << 16;
+            *(pout++) = T( val & 0x000FFF);
+            *(pout++) = T((val & 0xFFF000) >> 12);
+        }
+    }
+}
+
+template PANGOLIN_EXPORT void ConvertFrom10bit<uint16_t>(Image<unsigned char>&, const Image<unsigned char>&);
+template PANGOLIN_EXPORT void ConvertFrom10bit<float>(Image<unsigned char>&, const Image<unsigned char>&);
+template PANGOLIN_EXPORT void ConvertFrom12bit<uint16_t>(Image<unsigned char>&, const Image<unsigned char>&);
+template PANGOLIN_EXPORT void ConvertFrom12bit<float>(Image<unsigned char>&, const Image<unsigned char>&);
+
+// Per channel value cast, e.g. GRAY16LE to GRAY32F. Values are not rescaled.
+template<PixelFormatId Src, PixelFormatId Dst>
+void ConvertCast(
+    Image<unsigned char>& out,
+    const Image<unsigned char>& in
+) {
+    typedef typename PixelFormatTraits<Src>::channel_type Tin;
+    typedef typename PixelFormatTraits<Dst>::channel_type Tout;
+    const size_t n = out.w * PixelFormatTraits<Src>::channels;
+    for(size_t r=0; r<out.h; ++r) {
+        const Tin* pin = (const Tin*)(in.ptr + r*in.pitch);
+        Tout* pout = (Tout*)(out.ptr + r*out.pitch);
+        for(size_t i=0; i<n; ++i) {
+            pout[i] = Tout(pin[i]);
+        }
+    }
+}
+
+void ConvertSwapRedBlue(
+    Image<unsigned char>& out,
+    const Image<unsigned char>& in
+) {
+    for(size_t r=0; r<out.h; ++r) {
+        const uint8_t* pin = in.ptr + r*in.pitch;
+        uint8_t* pout = out.ptr + r*out.pitch;
+        for(size_t c=0; c<out.w; ++c, pin += 3, pout += 3) {
+            const uint8_t red = pin[0];
+            pout[0] = pin[2];
+            pout[1] = pin[1];
+            pout[2] = red;
+        }
+    }
+}
+
+void ConvertRgbToRgba(
+    Image<unsigned char>& out,
+    const Image<unsigned char>& in
+) {
+    for(size_t r=0; r<out.h; ++r) {
+        const uint8_t* pin = in.ptr + r*in.pitch;
+        uint8_t* pout = out.ptr + r*out.pitch;
+        for(size_t c=0; c<out.w; ++c, pin += 3, pout += 4) {
+            pout[0] = pin[0];
+            pout[1] = pin[1];
+            pout[2] = pin[2];
+            pout[3] = 255;
+        }
+    }
+}
+
+void ConvertRgbaToRgb(
+    Image<unsigned char>& out,
+    const Image<unsigned char>& in
+) {
+    for(size_t r=0; r<out.h; ++r) {
+        const uint8_t* pin = in.ptr + r*in.pitch;
+        uint8_t* pout = out.ptr + r*out.pitch;
+        for(size_t c=0; c<out.w; ++c, pin += 4, pout += 3) {
+            pout[0] = pin[0];
+            pout[1] = pin[1];
+            pout[2] = pin[2];
+        }
+    }
+}
+
+// Dense (src, dst) table of conversion kernels, with the built in
+// kernels registered on first use.
+struct PixelConversionTable
+{
+    PixelConversionTable()
+    {
+        for(int s=0; s < PixelFormatCount; ++s) {
+            for(int d=0; d < PixelFormatCount; ++d) {
+                funcs[s][d] = 0;
+            }
+        }
+
+        funcs[PixelFormatGray10][PixelFormatGray16LE] = &ConvertFrom10bit<uint16_t>;
+        funcs[PixelFormatGray10][PixelFormatGray32F]  = &ConvertFrom10bit<float>;
+        funcs[PixelFormatGray12][PixelFormatGray16LE] = &ConvertFrom12bit<uint16_t>;
+        funcs[PixelFormatGray12][PixelFormatGray32F]  = &ConvertFrom12bit<float>;
+        funcs[PixelFormatGray8][PixelFormatGray16LE]  = &ConvertCast<PixelFormatGray8, PixelFormatGray16LE>;
+        funcs[PixelFormatGray8][PixelFormatGray32F]   = &ConvertCast<PixelFormatGray8, PixelFormatGray32F>;
+        funcs[PixelFormatGray16LE][PixelFormatGray32F] = &ConvertCast<PixelFormatGray16LE, PixelFormatGray32F>;
+        funcs[PixelFormatRgb24][PixelFormatRgb96F]    = &ConvertCast<PixelFormatRgb24, PixelFormatRgb96F>;
+        funcs[PixelFormatRgb24][PixelFormatBgr24]     = &ConvertSwapRedBlue;
+        funcs[PixelFormatBgr24][PixelFormatRgb24]     = &ConvertSwapRedBlue;
+        funcs[PixelFormatRgb24][PixelFormatRgba]      = &ConvertRgbToRgba;
+        funcs[PixelFormatRgba][PixelFormatRgb24]      = &ConvertRgbaToRgb;
+    }
+
+    boostd::mutex lock;
+    PixelConvertFunc funcs[PixelFormatCount][PixelFormatCount];
+};
+
+static PixelConversionTable& ConversionTable()
+{
+    static PixelConversionTable table;
+    return table;
+}
+
+void RegisterPixelConversion(PixelFormatId src, PixelFormatId dst, PixelConvertFunc func)
+{
+    if(src < 0 || src >= PixelFormatCount || dst < 0 || dst >= PixelFormatCount) {
+        throw VideoException("RegisterPixelConversion: Unknown Format Id");
+    }
+    PixelConversionTable& table = ConversionTable();
+    boostd::unique_lock<boostd::mutex> l(table.lock);
+    table.funcs[src][dst] = func;
+}
+
+PixelConvertFunc FindPixelConversion(PixelFormatId src, PixelFormatId dst)
+{
+    if(src < 0 || src >= PixelFormatCount || dst < 0 || dst >= PixelFormatCount) {
+        return 0;
+    }
+    PixelConversionTable& table = ConversionTable();
+    boostd::unique_lock<boostd::mutex> l(table.lock);
+    return table.funcs[src][dst];
+}
+
+PixelConvertFunc FindPixelConversion(const VideoPixelFormat& src, const VideoPixelFormat& dst)
+{
+    return FindPixelConversion(PixelFormatIdFromFormat(src), PixelFormatIdFromFormat(dst));
+}
+
+}
@@ -26,10 +26,15 @@
  */
 
 #include <pangolin/image/image_io.h>
+#include <pangolin/image/image_mapped.h>
+#include <pangolin/utils/memstreambuf.h>
+#include <pangolin/utils/thread_pool.h>
 
 #include <algorithm>
 #include <stdexcept>
 #include <fstream>
+#include <iterator>
+#include <sstream>
 #include <string.h>
 #include <cstring>
 
@@ -39,6 +44,7 @@
 
 #ifdef HAVE_JPEG
 #include <jpeglib.h>
+#include <jerror.h>
 #ifndef HAVE_PNG
 // This should not be included when HAVE_PNG, as png.h includes its own.
 #include <setjmp.h>
@@ -49,8 +55,24 @@
 #include <ImfOutputFile.h>
 #include <ImfInputFile.h>
 #include <ImfChannelList.h>
+#include <ImfFrameBuffer.h>
+#include <ImfIO.h>
+#include <ImfInt64.h>
 #endif // HAVE_OPENEXR
 
+#ifdef HAVE_TIFF
+#include <tiffio.h>
+#include <stdint.h>
+#endif // HAVE_TIFF
+
+#ifndef _WIN_
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <errno.h>
+#endif // _WIN_
+
 #ifdef _WIN_
 // Undef windows Macro polution from jpeglib.h
 #undef LoadImage
@@ -80,7 +102,38 @@ VideoPixelFormat TgaFormat(int depth, int color_type, int color_map)
     throw std::runtime_error("Unsupported TGA format");    
 }
 
-TypedImage LoadTga(const std::string& filename)
+// What to do with an image once its header has been read
+enum ImageDecode
+{
+    ImageDecodeHeader, // Fill in dimensions and format only
+    ImageDecodeAlloc,  // Allocate image and decode into it
+    ImageDecodeInto    // Decode into existing image, which must match
+};
+
+// Prepare img for decoding image of given dimensions and format.
+// Returns false if only the header is wanted.
+bool BeginDecode(TypedImage& img, ImageDecode mode, size_t w, size_t h, const VideoPixelFormat& fmt, size_t row_bytes)
+{
+    switch(mode) {
+    case ImageDecodeHeader:
+        img = TypedImage(w, h, row_bytes, 0, fmt);
+        return false;
+    case ImageDecodeAlloc:
+        img.Alloc(w, h, fmt, row_bytes);
+        return true;
+    default:
+        // Only memory layout needs to agree (e.g. BGR24 destination for RGB24 file)
+        if(!img.ptr || img.w != w || img.h != h || img.fmt.bpp != fmt.bpp || img.fmt.channels != fmt.channels || img.pitch < row_bytes) {
+            std::ostringstream ss;
+            ss << "Image is " << w << "x" << h << " " << fmt.format << ", which doesn't match destination "
+               << img.w << "x" << img.h << " " << img.fmt.format;
+            throw std::runtime_error(ss.str());
+        }
+        return true;
+    }
+}
+
+void ReadTga(const std::string& filename, TypedImage& img, ImageDecode mode)
 {
     FILE *file;
     unsigned char type[4];
@@ -97,25 +150,42 @@ TypedImage LoadTga(const std::string& filename)
         const int width  = info[0] + (info[1] * 256);
         const int height = info[2] + (info[3] * 256);
         
-        TypedImage img;
         if(success) {
-            img.Alloc(width, height, TgaFormat(info[4], type[2], type[1]) );
-            
-            //read in image data
-            const size_t data_size = img.w * img.pitch;
-            success &= fread(img.ptr, sizeof(unsigned char), data_size, file) == data_size;
+            try {
+                const VideoPixelFormat fmt = TgaFormat(info[4], type[2], type[1]);
+                const size_t row_bytes = width * fmt.bpp / 8;
+                if(BeginDecode(img, mode, width, height, fmt, row_bytes)) {
+                    //read in image data
+                    for(size_t r=0; r < img.h && success; ++r) {
+                        success &= fread(img.ptr + r*img.pitch, sizeof(unsigned char), row_bytes, file) == row_bytes;
+                    }
+                }
+            }catch(...) {
+                fclose(file);
+                throw;
+            }
         }
         
         fclose(file);
         
         if (success) {
-            return img;
+            return;
+        }
+        if(mode == ImageDecodeAlloc) {
+            img.Dealloc();
         }
     }
     
     throw std::runtime_error("Unable to load TGA file, '" + filename + "'");    
 }
 
+TypedImage LoadTga(const std::string& filename)
+{
+    TypedImage img;
+    ReadTga(filename, img, ImageDecodeAlloc);
+    return img;
+}
+
 #ifdef HAVE_PNG
 VideoPixelFormat PngFormat(png_structp png_ptr, png_infop info_ptr )
 {
@@ -145,90 +215,147 @@ void PNGAPI PngWarningsCallback(png_structp /*png_ptr*/, png_const_charp /*warni
 {
     // Override default behaviour - don't do anything.
 }
+
+void PNGAPI PngReadStream(png_structp png_ptr, png_bytep data, png_size_t length)
+{
+    std::istream* is = (std::istream*)png_get_io_ptr(png_ptr);
+    if(!is->read((char*)data, length)) {
+        png_error(png_ptr, "Unexpected end of PNG data");
+    }
+}
+
+void PNGAPI PngWriteStream(png_structp png_ptr, png_bytep data, png_size_t length)
+{
+    std::ostream* os = (std::ostream*)png_get_io_ptr(png_ptr);
+    if(!os->write((const char*)data, length)) {
+        png_error(png_ptr, "Unable to write PNG data");
+    }
+}
+
+void PNGAPI PngFlushStream(png_structp png_ptr)
+{
+    std::ostream* os = (std::ostream*)png_get_io_ptr(png_ptr);
+    os->flush();
+}
 #endif
 
-TypedImage LoadPng(const std::string& filename)
+void ReadPng(std::istream& in, TypedImage& img, ImageDecode mode)
 {
 #ifdef HAVE_PNG
-    FILE *in = fopen(filename.c_str(), "rb");
-    
-    if( in )  {
-        //check the header
-        const size_t nBytes = 8;
-        png_byte header[nBytes];
-        size_t nread = fread(header, 1, nBytes, in);
-        int nIsPNG = png_sig_cmp(header, 0, nread);
-        
-        if ( nIsPNG != 0 )  {
-            throw std::runtime_error( filename + " is not a PNG file" );
-        }
-        
-        //set up initial png structs
-        png_structp png_ptr = png_create_read_struct( PNG_LIBPNG_VER_STRING, (png_voidp)NULL, NULL, &PngWarningsCallback);
-        if (!png_ptr) {
-            throw std::runtime_error( "PNG Init error 1" );
-        }
-        
-        png_infop info_ptr = png_create_info_struct(png_ptr);
-        if (!info_ptr)  {
-            png_destroy_read_struct(&png_ptr, (png_infopp)NULL, (png_infopp)NULL);
-            throw std::runtime_error( "PNG Init error 2" );
-        }
-        
-        png_infop end_info = png_create_info_struct(png_ptr);
-        if (!end_info) {
-            png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
-            throw std::runtime_error( "PNG Init error 3" );
-        }
-        
-        png_init_io(png_ptr, in);
-        png_set_sig_bytes(png_ptr, nBytes);
-        
-        //read the file
-        png_read_png(png_ptr, info_ptr, PNG_TRANSFORM_IDENTITY, NULL);
-        
-        if( png_get_bit_depth(png_ptr, info_ptr) == 1)  {
-            //Unpack bools to bytes to ease loading.
-            png_set_packing(png_ptr);
-        } else if( png_get_bit_depth(png_ptr, info_ptr) < 8) {
-            //Expand nonbool colour depths up to 8bpp
-            png_set_expand_gray_1_2_4_to_8(png_ptr);
-        }
-        
-        //Get rid of palette, by transforming it to RGB
-        if(png_get_color_type(png_ptr, info_ptr) == PNG_COLOR_TYPE_PALETTE) {
-            png_set_palette_to_rgb(png_ptr);
-        }
-        
-        if( png_get_interlace_type(png_ptr,info_ptr) != PNG_INTERLACE_NONE) {
-            throw std::runtime_error( "Interlace not yet supported" );
+    //check the header
+    const size_t nBytes = 8;
+    png_byte header[nBytes];
+    in.read((char*)header, nBytes);
+    if ( !in.good() || png_sig_cmp(header, 0, nBytes) != 0 )  {
+        throw std::runtime_error( "Not a PNG file" );
+    }
+
+    //set up initial png structs
+    png_structp png_ptr = png_create_read_struct( PNG_LIBPNG_VER_STRING, (png_voidp)NULL, NULL, &PngWarningsCallback);
+    if (!png_ptr) {
+        throw std::runtime_error( "PNG Init error 1" );
+    }
+
+    png_infop info_ptr = png_create_info_struct(png_ptr);
+    if (!info_ptr)  {
+        png_destroy_read_struct(&png_ptr, (png_infopp)NULL, (png_infopp)NULL);
+        throw std::runtime_error( "PNG Init error 2" );
+    }
+
+    png_infop end_info = png_create_info_struct(png_ptr);
+    if (!end_info) {
+        png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
+        throw std::runtime_error( "PNG Init error 3" );
+    }
+
+    // Setup Exception handling
+    if (setjmp(png_jmpbuf(png_ptr))) {
+        png_destroy_read_struct(&png_ptr, &info_ptr, &end_info);
+        if(mode == ImageDecodeAlloc) {
+            img.Dealloc();
         }
-        
-        const size_t w = png_get_image_width(png_ptr,info_ptr);
-        const size_t h = png_get_image_height(png_ptr,info_ptr);
-        const size_t pitch = png_get_rowbytes(png_ptr, info_ptr);
-        
-        TypedImage img;
-        img.Alloc(w, h, PngFormat(png_ptr, info_ptr), pitch);
-        
-        png_bytepp rows = png_get_rows(png_ptr, info_ptr);
+        throw std::runtime_error( "PNG Error: Error whilst reading png." );
+    }
+
+    png_set_read_fn(png_ptr, &in, &PngReadStream);
+    png_set_sig_bytes(png_ptr, nBytes);
+
+    png_read_info(png_ptr, info_ptr);
+
+    if( png_get_bit_depth(png_ptr, info_ptr) == 1)  {
+        //Unpack bools to bytes to ease loading.
+        png_set_packing(png_ptr);
+    } else if( png_get_bit_depth(png_ptr, info_ptr) < 8) {
+        //Expand nonbool colour depths up to 8bpp
+        png_set_expand_gray_1_2_4_to_8(png_ptr);
+    }
+
+    //Get rid of palette, by transforming it to RGB
+    if(png_get_color_type(png_ptr, info_ptr) == PNG_COLOR_TYPE_PALETTE) {
+        png_set_palette_to_rgb(png_ptr);
+    }
+
+    if( png_get_interlace_type(png_ptr,info_ptr) != PNG_INTERLACE_NONE) {
+        png_destroy_read_struct(&png_ptr, &info_ptr, &end_info);
+        throw std::runtime_error( "Interlace not yet supported" );
+    }
+
+    png_read_update_info(png_ptr, info_ptr);
+
+    const size_t w = png_get_image_width(png_ptr,info_ptr);
+    const size_t h = png_get_image_height(png_ptr,info_ptr);
+    const size_t row_bytes = png_get_rowbytes(png_ptr, info_ptr);
+
+    bool decode;
+    try {
+        decode = BeginDecode(img, mode, w, h, PngFormat(png_ptr, info_ptr), row_bytes);
+    }catch(...) {
+        png_destroy_read_struct(&png_ptr, &info_ptr, &end_info);
+        throw;
+    }
+
+    if(decode) {
+        // Decode rows straight into image
         for( unsigned int r = 0; r < h; r++) {
-            memcpy( img.ptr + pitch*r, rows[r], pitch );
+            png_read_row(png_ptr, img.ptr + img.pitch*r, NULL);
         }
-        png_destroy_read_struct(&png_ptr, &info_ptr, &end_info);
-        
-        fclose(in);
-        return img;
+        png_read_end(png_ptr, end_info);
     }
-    
-    throw std::runtime_error("Unable to load PNG file, '" + filename + "'");    
-    
+
+    png_destroy_read_struct(&png_ptr, &info_ptr, &end_info);
 #else
     throw std::runtime_error("PNG Support not enabled. Please rebuild Pangolin.");
 #endif
 }
 
-void SavePng(const Image<unsigned char>& image, const pangolin::VideoPixelFormat& fmt, const std::string& filename, bool top_line_first)
+TypedImage LoadPng(std::istream& in)
+{
+    TypedImage img;
+    ReadPng(in, img, ImageDecodeAlloc);
+    return img;
+}
+
+void LoadPng(std::istream& in, Image<unsigned char>& dst, const VideoPixelFormat& fmt)
+{
+    TypedImage img(dst.w, dst.h, dst.pitch, dst.ptr, fmt);
+    ReadPng(in, img, ImageDecodeInto);
+}
+
+TypedImage LoadPng(const std::string& filename)
+{
+    std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+    if(!in.is_open()) {
+        throw std::runtime_error("Unable to load PNG file, '" + filename + "'");
+    }
+
+    try {
+        return LoadPng(in);
+    }catch(const std::exception& e) {
+        throw std::runtime_error("Unable to load PNG file, '" + filename + "': " + e.what());
+    }
+}
+
+void SavePng(const Image<unsigned char>& image, const pangolin::VideoPixelFormat& fmt, std::ostream& out, bool top_line_first, int zlib_compression_level, int png_filters)
 {
     // Check image has supported bit depth
     for(unsigned int i=1; i < fmt.channels; ++i) {
@@ -238,20 +365,12 @@ void SavePng(const Image<unsigned char>& image, const pangolin::VideoPixelFormat
     }
 
 #ifdef HAVE_PNG
-    FILE *fp;
     png_structp png_ptr;
     png_infop info_ptr;
 
-    // Open file for writing (binary mode)
-    fp = fopen(filename.c_str(), "wb");
-    if (fp == NULL) {
-        throw std::runtime_error( "PNG Error: Could not open file '" + filename + "' for writing" );
-    }
-
     // Initialize write structure
     png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
     if (png_ptr == NULL) {
-        fclose(fp);
         throw std::runtime_error( "PNG Error: Could not allocate write struct." );
     }
 
@@ -259,19 +378,25 @@ void SavePng(const Image<unsigned char>& image, const pangolin::VideoPixelFormat
     info_ptr = png_create_info_struct(png_ptr);
     if (info_ptr == NULL) {
         png_destroy_write_struct(&png_ptr, (png_infopp)NULL);
-        fclose(fp);
         throw std::runtime_error( "PNG Error: Could not allocate info struct." );
     }
 
     // Setup Exception handling
     if (setjmp(png_jmpbuf(png_ptr))) {
         png_free_data(png_ptr, info_ptr, PNG_FREE_ALL, -1);
-        png_destroy_write_struct(&png_ptr, (png_infopp)NULL);
-        fclose(fp);
+        png_destroy_write_struct(&png_ptr, &info_ptr);
         throw std::runtime_error( "PNG Error: Error during png creation." );
     }
 
-    png_init_io(png_ptr, fp);
+    png_set_write_fn(png_ptr, &out, &PngWriteStream, &PngFlushStream);
+
+    if(zlib_compression_level >= 0) {
+        png_set_compression_level(png_ptr, zlib_compression_level);
+    }
+
+    if(png_filters >= 0) {
+        png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, png_filters);
+    }
 
     const int bit_depth = fmt.channel_bits[0];
 
@@ -282,6 +407,7 @@ void SavePng(const Image<unsigned char>& image, const pangolin::VideoPixelFormat
     case 3: colour_type = PNG_COLOR_TYPE_RGB; break;
     case 4: colour_type = PNG_COLOR_TYPE_RGBA; break;
     default:
+        png_destroy_write_struct(&png_ptr, &info_ptr);
         throw std::runtime_error( "PNG Error: unexpected image channel number");
     }
 
@@ -309,15 +435,25 @@ void SavePng(const Image<unsigned char>& image, const pangolin::VideoPixelFormat
     png_write_end(png_ptr, NULL);
 
     // Free resources
-    fclose(fp);
     png_free_data(png_ptr, info_ptr, PNG_FREE_ALL, -1);
-    png_destroy_write_struct(&png_ptr, (png_infopp)NULL);
+    png_destroy_write_struct(&png_ptr, &info_ptr);
 
 #else
     throw std::runtime_error("PNG Support not enabled. Please rebuild Pangolin.");
 #endif
 }
 
+void SavePng(const Image<unsigned char>& image, const pangolin::VideoPixelFormat& fmt, const std::string& filename, bool top_line_first)
+{
+    // Open file for writing (binary mode)
+    std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary);
+    if (!out.is_open()) {
+        throw std::runtime_error( "PNG Error: Could not open file '" + filename + "' for writing" );
+    }
+
+    SavePng(image, fmt, out, top_line_first);
+}
+
 #ifdef HAVE_JPEG
 struct my_error_mgr
 {
@@ -334,74 +470,300 @@ METHODDEF(void) my_error_exit(j_common_ptr cinfo)
   longjmp(myerr->setjmp_buffer, 1);
 }
 
-VideoPixelFormat JpgFormat(jpeg_decompress_struct& /*info*/ )
+VideoPixelFormat JpgFormat(jpeg_decompress_struct& info )
+{
+    if(info.output_components == 1) {
+        return VideoFormatFromString("GRAY8");
+    }else if(info.output_components == 3) {
+        return VideoFormatFromString("RGB24");
+    }else{
+        throw std::runtime_error("Unsupported JPEG format");
+    }
+}
+
+// libjpeg source / destination managers for std::iostreams,
+// following jpeg_stdio_src / jpeg_stdio_dest.
+const size_t jpeg_stream_buffer_size = 4096;
+
+struct JpegStreamSource
+{
+    jpeg_source_mgr pub;
+    std::istream* is;
+    JOCTET buffer[jpeg_stream_buffer_size];
+};
+
+METHODDEF(void) JpegInitSource(j_decompress_ptr /*cinfo*/)
+{
+}
+
+METHODDEF(boolean) JpegFillInputBuffer(j_decompress_ptr cinfo)
 {
-    // TODO: Actually work this out properly.
-    return VideoFormatFromString("RGB24");
+    JpegStreamSource* src = (JpegStreamSource*)cinfo->src;
+    src->is->read((char*)src->buffer, jpeg_stream_buffer_size);
+    size_t nbytes = (size_t)src->is->gcount();
+
+    if(nbytes == 0) {
+        // Insert fake EOI marker, as jpeg_stdio_src does
+        src->buffer[0] = (JOCTET) 0xFF;
+        src->buffer[1] = (JOCTET) JPEG_EOI;
+        nbytes = 2;
+    }
+
+    src->pub.next_input_byte = src->buffer;
+    src->pub.bytes_in_buffer = nbytes;
+    return TRUE;
+}
+
+METHODDEF(void) JpegSkipInputData(j_decompress_ptr cinfo, long num_bytes)
+{
+    JpegStreamSource* src = (JpegStreamSource*)cinfo->src;
+    if(num_bytes > 0) {
+        while(num_bytes > (long)src->pub.bytes_in_buffer) {
+            num_bytes -= (long)src->pub.bytes_in_buffer;
+            JpegFillInputBuffer(cinfo);
+        }
+        src->pub.next_input_byte += (size_t)num_bytes;
+        src->pub.bytes_in_buffer -= (size_t)num_bytes;
+    }
+}
+
+METHODDEF(void) JpegTermSource(j_decompress_ptr /*cinfo*/)
+{
+}
+
+void JpegStreamSrc(j_decompress_ptr cinfo, JpegStreamSource& src, std::istream& is)
+{
+    src.is = &is;
+    src.pub.init_source = JpegInitSource;
+    src.pub.fill_input_buffer = JpegFillInputBuffer;
+    src.pub.skip_input_data = JpegSkipInputData;
+    src.pub.resync_to_restart = jpeg_resync_to_restart;
+    src.pub.term_source = JpegTermSource;
+    src.pub.bytes_in_buffer = 0;
+    src.pub.next_input_byte = NULL;
+    cinfo->src = &src.pub;
+}
+
+struct JpegStreamDest
+{
+    jpeg_destination_mgr pub;
+    std::ostream* os;
+    JOCTET buffer[jpeg_stream_buffer_size];
+};
+
+METHODDEF(void) JpegInitDestination(j_compress_ptr cinfo)
+{
+    JpegStreamDest* dest = (JpegStreamDest*)cinfo->dest;
+    dest->pub.next_output_byte = dest->buffer;
+    dest->pub.free_in_buffer = jpeg_stream_buffer_size;
+}
+
+METHODDEF(boolean) JpegEmptyOutputBuffer(j_compress_ptr cinfo)
+{
+    JpegStreamDest* dest = (JpegStreamDest*)cinfo->dest;
+    if(!dest->os->write((const char*)dest->buffer, jpeg_stream_buffer_size)) {
+        ERREXIT(cinfo, JERR_FILE_WRITE);
+    }
+    dest->pub.next_output_byte = dest->buffer;
+    dest->pub.free_in_buffer = jpeg_stream_buffer_size;
+    return TRUE;
+}
+
+METHODDEF(void) JpegTermDestination(j_compress_ptr cinfo)
+{
+    JpegStreamDest* dest = (JpegStreamDest*)cinfo->dest;
+    const size_t datacount = jpeg_stream_buffer_size - dest->pub.free_in_buffer;
+    if(datacount > 0 && !dest->os->write((const char*)dest->buffer, datacount)) {
+        ERREXIT(cinfo, JERR_FILE_WRITE);
+    }
+    dest->os->flush();
+}
+
+void JpegStreamDst(j_compress_ptr cinfo, JpegStreamDest& dest, std::ostream& os)
+{
+    dest.os = &os;
+    dest.pub.init_destination = JpegInitDestination;
+    dest.pub.empty_output_buffer = JpegEmptyOutputBuffer;
+    dest.pub.term_destination = JpegTermDestination;
+    cinfo->dest = &dest.pub;
 }
 #endif
 
-TypedImage LoadJpg(const std::string& filename)
+void ReadJpg(std::istream& in, TypedImage& img, ImageDecode mode, const ImageLoadOptions& options = ImageLoadOptions())
 {
 #ifdef HAVE_JPEG
-    FILE * infile = fopen(filename.c_str(), "rb");
+    struct my_error_mgr jerr;
+    struct jpeg_decompress_struct cinfo;
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = my_error_exit;
 
-    if(infile) {
-        struct my_error_mgr jerr;
-        jerr.pub.error_exit = my_error_exit;
-    
-        struct jpeg_decompress_struct cinfo;
-        cinfo.err = jpeg_std_error(&jerr.pub);
-    
-        if (setjmp(jerr.setjmp_buffer)) {
-            // If we get here, the JPEG code has signaled an error.
-            jpeg_destroy_decompress(&cinfo);
-            fclose(infile);
-            throw std::runtime_error("Error whilst loading JPEG image, '" + filename + "'");
+    JpegStreamSource src;
+
+    if (setjmp(jerr.setjmp_buffer)) {
+        // If we get here, the JPEG code has signaled an error.
+        jpeg_destroy_decompress(&cinfo);
+        if(mode == ImageDecodeAlloc) {
+            img.Dealloc();
         }
-    
-        jpeg_create_decompress(&cinfo);
-        jpeg_stdio_src(&cinfo, infile);
-        jpeg_read_header(&cinfo, TRUE);
+        throw std::runtime_error("Error whilst loading JPEG image");
+    }
+
+    jpeg_create_decompress(&cinfo);
+    JpegStreamSrc(&cinfo, src, in);
+    jpeg_read_header(&cinfo, TRUE);
+
+    // Scaling happens within the IDCT, so smaller outputs decode faster
+    cinfo.scale_num = options.scale_num;
+    cinfo.scale_denom = options.scale_denom;
+    if(options.fast_dct) {
+        cinfo.dct_method = JDCT_IFAST;
+        cinfo.do_fancy_upsampling = FALSE;
+    }
+    jpeg_calc_output_dimensions(&cinfo);
+
+    bool decode;
+    try {
+        const VideoPixelFormat fmt = JpgFormat(cinfo);
+        const size_t row_stride = cinfo.output_width * cinfo.output_components;
+        decode = BeginDecode(img, mode, cinfo.output_width, cinfo.output_height, fmt, row_stride);
+    }catch(...) {
+        jpeg_destroy_decompress(&cinfo);
+        throw;
+    }
+
+    if(decode) {
         jpeg_start_decompress(&cinfo);
-    
-        const int row_stride = cinfo.output_width * cinfo.output_components;
-        
-        TypedImage img;
-        img.Alloc(cinfo.output_width, cinfo.output_height, JpgFormat(cinfo), row_stride);
-        
-        JSAMPARRAY row_buffer = (*cinfo.mem->alloc_sarray)
-                ((j_common_ptr) &cinfo, JPOOL_IMAGE, row_stride, 1);
-        
         while (cinfo.output_scanline < cinfo.output_height) {
-            const int scanline = cinfo.output_scanline;
-            jpeg_read_scanlines(&cinfo, row_buffer, 1);
-            memcpy(img.ptr + scanline * img.pitch, row_buffer[0], img.pitch );
+            JSAMPROW row = (JSAMPROW)(img.ptr + cinfo.output_scanline * img.pitch);
+            jpeg_read_scanlines(&cinfo, &row, 1);
         }
-        
         jpeg_finish_decompress(&cinfo);
-        jpeg_destroy_decompress(&cinfo);
-        fclose(infile);  
-        return img;
     }
-    throw std::runtime_error("Unable to load JPEG file, '" + filename + "'");
-#else   
+
+    jpeg_destroy_decompress(&cinfo);
+#else
     throw std::runtime_error("JPEG Support not enabled. Please rebuild Pangolin.");
 #endif
 }
 
-VideoPixelFormat PpmFormat(const std::string& strType, int /*num_colours*/)
+TypedImage LoadJpg(std::istream& in)
+{
+    TypedImage img;
+    ReadJpg(in, img, ImageDecodeAlloc);
+    return img;
+}
+
+TypedImage LoadJpg(std::istream& in, const ImageLoadOptions& options)
+{
+    TypedImage img;
+    ReadJpg(in, img, ImageDecodeAlloc, options);
+    return img;
+}
+
+void LoadJpg(std::istream& in, Image<unsigned char>& dst, const VideoPixelFormat& fmt)
+{
+    TypedImage img(dst.w, dst.h, dst.pitch, dst.ptr, fmt);
+    ReadJpg(in, img, ImageDecodeInto);
+}
+
+TypedImage LoadJpg(const std::string& filename)
+{
+    std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+    if(!in.is_open()) {
+        throw std::runtime_error("Unable to load JPEG file, '" + filename + "'");
+    }
+
+    try {
+        return LoadJpg(in);
+    }catch(const std::exception& e) {
+        throw std::runtime_error("Unable to load JPEG file, '" + filename + "': " + e.what());
+    }
+}
+
+void SaveJpg(const Image<unsigned char>& image, const pangolin::VideoPixelFormat& fmt, std::ostream& out, int quality, bool top_line_first)
 {
-    if(strType == "P5") {
-        return VideoFormatFromString("GRAY8"); 
-    }else if(strType == "P6") {
-        return VideoFormatFromString("RGB24"); 
+#ifdef HAVE_JPEG
+    J_COLOR_SPACE colour_space;
+    if(fmt.channels == 1 && fmt.bpp == 8) {
+        colour_space = JCS_GRAYSCALE;
+    }else if(fmt.channels == 3 && fmt.bpp == 24) {
+        colour_space = JCS_RGB;
     }else{
-        throw std::runtime_error("Unsupported PPM/PGM format");        
+        throw std::runtime_error("JPEG Saving only supported for GRAY8 and RGB24 images, not " + fmt.format);
+    }
+
+    struct my_error_mgr jerr;
+    struct jpeg_compress_struct cinfo;
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = my_error_exit;
+
+    JpegStreamDest dest;
+
+    if (setjmp(jerr.setjmp_buffer)) {
+        jpeg_destroy_compress(&cinfo);
+        throw std::runtime_error("JPEG Error: Error during jpeg creation.");
+    }
+
+    jpeg_create_compress(&cinfo);
+    JpegStreamDst(&cinfo, dest, out);
+
+    cinfo.image_width = (JDIMENSION)image.w;
+    cinfo.image_height = (JDIMENSION)image.h;
+    cinfo.input_components = (int)fmt.channels;
+    cinfo.in_color_space = colour_space;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, quality, TRUE);
+    jpeg_start_compress(&cinfo, TRUE);
+
+    while (cinfo.next_scanline < cinfo.image_height) {
+        const size_t y = top_line_first ? cinfo.next_scanline : image.h - 1 - cinfo.next_scanline;
+        JSAMPROW row = (JSAMPROW)(image.ptr + y * image.pitch);
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+#else
+    throw std::runtime_error("JPEG Support not enabled. Please rebuild Pangolin.");
+#endif
+}
+
+void SaveJpg(const Image<unsigned char>& image, const pangolin::VideoPixelFormat& fmt, const std::string& filename, int quality, bool top_line_first)
+{
+    std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary);
+    if (!out.is_open()) {
+        throw std::runtime_error( "JPEG Error: Could not open file '" + filename + "' for writing" );
+    }
+
+    SaveJpg(image, fmt, out, quality, top_line_first);
+}
+
+bool HostIsLittleEndian()
+{
+    const unsigned short one = 1;
+    return *(const unsigned char*)&one == 1;
+}
+
+// Reverse byte order of each word_bytes sized element
+void SwapBytes(unsigned char* data, size_t size_bytes, size_t word_bytes)
+{
+    for(unsigned char* p = data; p + word_bytes <= data + size_bytes; p += word_bytes) {
+        std::reverse(p, p + word_bytes);
     }
 }
 
-void PpmConsumeWhitespaceAndComments(std::ifstream& bFile)
+// Raw binary PGM / PPM / PFM header
+struct PpmHeader
+{
+    VideoPixelFormat fmt;
+    size_t w;
+    size_t h;
+    size_t row_bytes;
+    bool top_line_first; // PFM rows are stored bottom to top
+    bool swap_bytes;     // Stored byte order differs from host
+};
+
+void PpmConsumeWhitespaceAndComments(std::istream& bFile)
 {
     // TODO: Make a little more general / more efficient
     while( bFile.peek() == ' ' )  bFile.get();
@@ -409,13 +771,14 @@ void PpmConsumeWhitespaceAndComments(std::ifstream& bFile)
     while( bFile.peek() == '#' )  bFile.ignore(4096, '\n');
 }
 
-TypedImage LoadPpm(std::ifstream& bFile)
+// Parse header, leaving bFile at the start of pixel data
+PpmHeader ReadPpmHeader(std::istream& bFile)
 {
-    // Parse header
     std::string ppm_type = "";
-    int num_colors = 0;
     int w = 0;
     int h = 0;
+    // Max value for PGM / PPM, scale and byte order for PFM
+    double max_val = 0;
 
     bFile >> ppm_type;
     PpmConsumeWhitespaceAndComments(bFile);
@@ -423,57 +786,429 @@ TypedImage LoadPpm(std::ifstream& bFile)
     PpmConsumeWhitespaceAndComments(bFile);
     bFile >> h;
     PpmConsumeWhitespaceAndComments(bFile);
-    bFile >> num_colors;
+    bFile >> max_val;
     bFile.ignore(1,'\n');
-    
-    TypedImage img;
-    bool success = !bFile.fail() && w > 0 && h > 0;
 
-    if(success) {
-        img.Alloc(w, h, PpmFormat(ppm_type, num_colors) );
+    if(bFile.fail() || w <= 0 || h <= 0) {
+        throw std::runtime_error("Invalid PPM/PGM header");
+    }
 
-        // Read in data
-        for(size_t r=0; r<img.h; ++r) {
-            bFile.read( (char*)img.ptr + r*img.pitch, img.pitch );
-        }
-        success = !bFile.fail();
+    PpmHeader hdr;
+    hdr.w = w;
+    hdr.h = h;
+    hdr.top_line_first = true;
+    hdr.swap_bytes = false;
+
+    if(ppm_type == "P5" && max_val < 256) {
+        hdr.fmt = VideoFormatFromString("GRAY8");
+    }else if(ppm_type == "P5" && max_val < 65536) {
+        // 16 bit PGM is big endian
+        hdr.fmt = VideoFormatFromString("GRAY16LE");
+        hdr.swap_bytes = HostIsLittleEndian();
+    }else if(ppm_type == "P6" && max_val < 256) {
+        hdr.fmt = VideoFormatFromString("RGB24");
+    }else if(ppm_type == "Pf" || ppm_type == "PF") {
+        // Negative scale signals little endian data
+        hdr.fmt = VideoFormatFromString(ppm_type == "Pf" ? "GRAY32F" : "RGB96F");
+        hdr.top_line_first = false;
+        hdr.swap_bytes = (max_val < 0) != HostIsLittleEndian();
+    }else{
+        throw std::runtime_error("Unsupported PPM/PGM/PFM format");
     }
 
-    if(!success) {
-        img.Dealloc();
+    hdr.row_bytes = hdr.w * hdr.fmt.bpp / 8;
+    return hdr;
+}
+
+void ReadPpm(std::istream& bFile, TypedImage& img, ImageDecode mode)
+{
+    const PpmHeader hdr = ReadPpmHeader(bFile);
+
+    if(BeginDecode(img, mode, hdr.w, hdr.h, hdr.fmt, hdr.row_bytes)) {
+        // Read in data, flipping to top line first
+        for(size_t r=0; r<img.h; ++r) {
+            unsigned char* row = img.ptr + (hdr.top_line_first ? r : img.h - r - 1) * img.pitch;
+            bFile.read( (char*)row, hdr.row_bytes );
+            if(hdr.swap_bytes) {
+                SwapBytes(row, hdr.row_bytes, hdr.fmt.channel_bits[0] / 8);
+            }
+        }
+        if(bFile.fail()) {
+            if(mode == ImageDecodeAlloc) {
+                img.Dealloc();
+            }
+            throw std::runtime_error("Unexpected end of PPM/PGM data");
+        }
     }
+}
 
+TypedImage LoadPpm(std::istream& in)
+{
+    TypedImage img;
+    ReadPpm(in, img, ImageDecodeAlloc);
     return img;
 }
 
 TypedImage LoadPpm(const std::string& filename)
 {
     std::ifstream bFile( filename.c_str(), std::ios::in | std::ios::binary );
-    return LoadPpm(bFile);
+    if(!bFile.is_open()) {
+        throw std::runtime_error("Unable to load PPM/PGM/PFM file, '" + filename + "'");
+    }
+
+    try {
+        return LoadPpm(bFile);
+    }catch(const std::exception& e) {
+        throw std::runtime_error("Unable to load PPM/PGM/PFM file, '" + filename + "': " + e.what());
+    }
 }
 
-#ifdef HAVE_OPENEXR
-Imf::PixelType OpenEXRPixelType(int channel_bits)
+MappedImage::MappedImage()
+    : top_line_first(true), mapping(0), mapping_bytes(0), mapped(false)
 {
-    if( channel_bits == 16 ) {
-        return Imf::PixelType::HALF;
-    }else if( channel_bits == 32 ) {
-        return Imf::PixelType::FLOAT;
-    }else{
-        throw std::runtime_error("Unsupported OpenEXR Pixel Type.");
-    }
 }
 
-void SetOpenEXRChannels(Imf::ChannelList& ch, const pangolin::VideoPixelFormat& fmt)
+MappedImage::MappedImage(const std::string& filename)
+    : top_line_first(true), mapping(0), mapping_bytes(0), mapped(false)
+{
+    Open(filename);
+}
+
+MappedImage::~MappedImage()
+{
+    Close();
+}
+
+void MappedImage::Open(const std::string& filename)
+{
+    Close();
+
+    std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+    if(!in.is_open()) {
+        throw std::runtime_error("Unable to open image file, '" + filename + "'");
+    }
+
+    PpmHeader hdr;
+    try {
+        hdr = ReadPpmHeader(in);
+    }catch(const std::exception& e) {
+        throw std::runtime_error("Unable to map image file, '" + filename + "': " + e.what());
+    }
+    size_t offset = (size_t)(std::streamoff)in.tellg();
+    const size_t data_bytes = hdr.h * hdr.row_bytes;
+
+#ifndef _WIN_
+    // Pixels can only be used in place if they are in host byte order and
+    // the header length leaves them aligned for their type (the mapping
+    // itself is page aligned).
+    if(!hdr.swap_bytes && offset % (hdr.fmt.channel_bits[0] / 8) == 0) {
+        in.close();
+        const int fd = open(filename.c_str(), O_RDONLY);
+        struct stat st;
+        if(fd == -1 || fstat(fd, &st) == -1) {
+            if(fd != -1) close(fd);
+            throw std::runtime_error("Unable to map image file, '" + filename + "': " + strerror(errno));
+        }
+        if((size_t)st.st_size < offset + data_bytes) {
+            close(fd);
+            throw std::runtime_error("Unable to map image file, '" + filename + "': file is truncated");
+        }
+
+        void* p = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        const std::string err = strerror(errno);
+        close(fd);
+        if(p == MAP_FAILED) {
+            throw std::runtime_error("Unable to map image file, '" + filename + "': " + err);
+        }
+        mapping = (unsigned char*)p;
+        mapping_bytes = st.st_size;
+        mapped = true;
+    }
+#endif // _WIN_
+
+    if(!mapped) {
+        // Read pixel data into (suitably aligned) memory instead
+        mapping = new unsigned char[data_bytes];
+        mapping_bytes = data_bytes;
+        in.read((char*)mapping, data_bytes);
+        if(in.fail()) {
+            Close();
+            throw std::runtime_error("Unable to map image file, '" + filename + "': file is truncated");
+        }
+        if(hdr.swap_bytes) {
+            SwapBytes(mapping, data_bytes, hdr.fmt.channel_bits[0] / 8);
+        }
+        offset = 0;
+    }
+
+    unsigned char* data = mapping + offset;
+
+    w = hdr.w;
+    h = hdr.h;
+    pitch = hdr.row_bytes;
+    ptr = data;
+    fmt = hdr.fmt;
+    top_line_first = hdr.top_line_first;
+}
+
+void MappedImage::Close()
+{
+    if(mapping) {
+#ifndef _WIN_
+        if(mapped) {
+            munmap(mapping, mapping_bytes);
+        }else
+#endif // _WIN_
+        {
+            delete[] mapping;
+        }
+    }
+    mapping = 0;
+    mapping_bytes = 0;
+    mapped = false;
+    ptr = 0;
+    w = 0;
+    h = 0;
+    pitch = 0;
+    top_line_first = true;
+}
+
+bool MappedImage::IsOpen() const
+{
+    return mapping != 0;
+}
+
+bool MappedImage::IsMapped() const
+{
+    return mapped;
+}
+
+void SavePpm(const Image<unsigned char>& image, const pangolin::VideoPixelFormat& fmt, std::ostream& out, bool top_line_first)
+{
+    bool swap_bytes = false;
+    bool pfm = false;
+
+    if(fmt.format == "GRAY8") {
+        out << "P5\n" << image.w << " " << image.h << "\n255\n";
+    }else if(fmt.format == "RGB24") {
+        out << "P6\n" << image.w << " " << image.h << "\n255\n";
+    }else if(fmt.format == "GRAY16LE") {
+        out << "P5\n" << image.w << " " << image.h << "\n65535\n";
+        swap_bytes = HostIsLittleEndian();
+    }else if(fmt.format == "GRAY32F" || fmt.format == "RGB96F") {
+        // Store floats in host order, signalled by sign of scale
+        out << (fmt.channels == 1 ? "Pf" : "PF") << "\n" << image.w << " " << image.h << "\n"
+            << (HostIsLittleEndian() ? "-1.0" : "1.0") << "\n";
+        pfm = true;
+    }else{
+        throw std::runtime_error("Unable to save PPM/PGM/PFM image with format '" + fmt.format + "'");
+    }
+
+    const size_t row_bytes = image.w * fmt.bpp / 8;
+    std::vector<unsigned char> swapped(swap_bytes ? row_bytes : 0);
+
+    for(size_t r=0; r < image.h; ++r) {
+        // PFM stores bottom line first
+        const size_t file_y = pfm ? image.h - r - 1 : r;
+        const size_t y = top_line_first ? file_y : image.h - file_y - 1;
+        const unsigned char* row = image.ptr + y*image.pitch;
+        if(swap_bytes) {
+            std::memcpy(&swapped[0], row, row_bytes);
+            SwapBytes(&swapped[0], row_bytes, fmt.channel_bits[0] / 8);
+            row = &swapped[0];
+        }
+        out.write( (const char*)row, row_bytes );
+    }
+
+    if(!out.good()) {
+        throw std::runtime_error("Error whilst writing PPM/PGM/PFM image");
+    }
+}
+
+void SavePpm(const Image<unsigned char>& image, const pangolin::VideoPixelFormat& fmt, const std::string& filename, bool top_line_first)
+{
+    std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary);
+    if (!out.is_open()) {
+        throw std::runtime_error( "PPM Error: Could not open file '" + filename + "' for writing" );
+    }
+
+    SavePpm(image, fmt, out, top_line_first);
+}
+
+#ifdef HAVE_OPENEXR
+Imf::PixelType OpenEXRPixelType(int channel_bits)
+{
+    if( channel_bits == 16 ) {
+        return Imf::PixelType::HALF;
+    }else if( channel_bits == 32 ) {
+        return Imf::PixelType::FLOAT;
+    }else{
+        throw std::runtime_error("Unsupported OpenEXR Pixel Type.");
+    }
+}
+
+void SetOpenEXRChannels(Imf::ChannelList& ch, const pangolin::VideoPixelFormat& fmt)
 {
     const char* CHANNEL_NAMES[] = {"R","G","B","A"};
     for(size_t c=0; c < fmt.channels; ++c) {
         ch.insert( CHANNEL_NAMES[c], Imf::Channel(OpenEXRPixelType(fmt.channel_bits[c])) );
     }
 }
+
+// Adapt std::istream for reading by OpenEXR
+class ExrIStream : public Imf::IStream
+{
+public:
+    ExrIStream(std::istream& in)
+        : Imf::IStream("stream"), in(in)
+    {
+    }
+
+    // As Imf::IStream requires, throw if fewer than n bytes remain, and
+    // return false once the last byte has been read.
+    bool read(char c[], int n)
+    {
+        in.read(c, n);
+        if(in.gcount() != n) {
+            throw std::runtime_error("Unexpected end of EXR data");
+        }
+        if(in.peek() == std::char_traits<char>::eof()) {
+            // Leave the stream usable for tellg() / seekg()
+            in.clear(in.rdstate() & ~std::ios::eofbit);
+            return false;
+        }
+        return true;
+    }
+
+    Imf::Int64 tellg()
+    {
+        return (Imf::Int64)(std::streamoff)in.tellg();
+    }
+
+    void seekg(Imf::Int64 pos)
+    {
+        in.seekg((std::streamoff)pos);
+    }
+
+    void clear()
+    {
+        in.clear();
+    }
+
+private:
+    std::istream& in;
+};
+
+// Adapt std::ostream for writing by OpenEXR. Stream must be seekable.
+class ExrOStream : public Imf::OStream
+{
+public:
+    ExrOStream(std::ostream& out)
+        : Imf::OStream("stream"), out(out)
+    {
+    }
+
+    void write(const char c[], int n)
+    {
+        out.write(c, n);
+        if(!out.good()) {
+            throw std::runtime_error("Error whilst writing EXR data");
+        }
+    }
+
+    Imf::Int64 tellp()
+    {
+        return (Imf::Int64)(std::streamoff)out.tellp();
+    }
+
+    void seekp(Imf::Int64 pos)
+    {
+        out.seekp((std::streamoff)pos);
+    }
+
+private:
+    std::ostream& out;
+};
 #endif //HAVE_OPENEXR
 
-void SaveExr(const Image<unsigned char>& image_in, const pangolin::VideoPixelFormat& fmt, const std::string& filename, bool top_line_first)
+void ReadExr(std::istream& in, TypedImage& img, ImageDecode mode)
+{
+#ifdef HAVE_OPENEXR
+    ExrIStream is(in);
+    Imf::InputFile file(is);
+
+    const Imath::Box2i dw = file.header().dataWindow();
+    const size_t w = dw.max.x - dw.min.x + 1;
+    const size_t h = dw.max.y - dw.min.y + 1;
+
+    // Colour images decode to RGB96F, anything else to GRAY32F.
+    // OpenEXR converts HALF channels to FLOAT for us.
+    const Imf::ChannelList& channels = file.header().channels();
+    std::vector<std::string> names;
+    if(channels.findChannel("R") && channels.findChannel("G") && channels.findChannel("B")) {
+        names.push_back("R");
+        names.push_back("G");
+        names.push_back("B");
+    }else if(channels.findChannel("Y")) {
+        names.push_back("Y");
+    }else if(channels.begin() != channels.end()) {
+        names.push_back(channels.begin().name());
+    }else{
+        throw std::runtime_error("EXR image has no channels");
+    }
+
+    const VideoPixelFormat fmt = VideoFormatFromString(names.size() == 3 ? "RGB96F" : "GRAY32F");
+    const size_t pixel_bytes = fmt.bpp / 8;
+
+    if(BeginDecode(img, mode, w, h, fmt, w * pixel_bytes)) {
+        // OpenEXR addresses pixels in data window coordinates
+        char* base = (char*)img.ptr - dw.min.x * (ptrdiff_t)pixel_bytes - dw.min.y * (ptrdiff_t)img.pitch;
+
+        Imf::FrameBuffer frameBuffer;
+        for(size_t c=0; c < names.size(); ++c) {
+            frameBuffer.insert(
+                names[c].c_str(),
+                Imf::Slice( Imf::PixelType::FLOAT, base + c*sizeof(float), pixel_bytes, img.pitch )
+            );
+        }
+
+        try {
+            file.setFrameBuffer(frameBuffer);
+            file.readPixels(dw.min.y, dw.max.y);
+        }catch(...) {
+            if(mode == ImageDecodeAlloc) {
+                img.Dealloc();
+            }
+            throw;
+        }
+    }
+#else
+    throw std::runtime_error("EXR Support not enabled. Please rebuild Pangolin.");
+#endif // HAVE_OPENEXR
+}
+
+TypedImage LoadExr(std::istream& in)
+{
+    TypedImage img;
+    ReadExr(in, img, ImageDecodeAlloc);
+    return img;
+}
+
+TypedImage LoadExr(const std::string& filename)
+{
+    std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+    if(!in.is_open()) {
+        throw std::runtime_error("Unable to load EXR file, '" + filename + "'");
+    }
+
+    try {
+        return LoadExr(in);
+    }catch(const std::exception& e) {
+        throw std::runtime_error("Unable to load EXR file, '" + filename + "': " + e.what());
+    }
+}
+
+void SaveExr(const Image<unsigned char>& image_in, const pangolin::VideoPixelFormat& fmt, std::ostream& out, bool top_line_first)
 {
 #ifdef HAVE_OPENEXR
     Image<unsigned char> image;
@@ -491,7 +1226,8 @@ void SaveExr(const Image<unsigned char>& image_in, const pangolin::VideoPixelFor
     Imf::Header header (image.w, image.h);
     SetOpenEXRChannels(header.channels(), fmt);
 
-    Imf::OutputFile file (filename.c_str(), header);
+    ExrOStream os(out);
+    Imf::OutputFile file (os, header);
     Imf::FrameBuffer frameBuffer;
 
     int ch=0;
@@ -523,6 +1259,412 @@ void SaveExr(const Image<unsigned char>& image_in, const pangolin::VideoPixelFor
 #endif // HAVE_OPENEXR
 }
 
+void SaveExr(const Image<unsigned char>& image, const pangolin::VideoPixelFormat& fmt, const std::string& filename, bool top_line_first)
+{
+    std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary);
+    if (!out.is_open()) {
+        throw std::runtime_error( "EXR Error: Could not open file '" + filename + "' for writing" );
+    }
+
+    SaveExr(image, fmt, out, top_line_first);
+}
+
+// TIFF file, or TIFF held in memory
+struct TiffSource
+{
+    TiffSource(const std::string& filename)
+        : filename(filename), data(0), size_bytes(0)
+    {
+    }
+
+    TiffSource(const unsigned char* data, size_t size_bytes)
+        : data(data), size_bytes(size_bytes)
+    {
+    }
+
+    std::string filename;
+    const unsigned char* data;
+    size_t size_bytes;
+};
+
+#ifdef HAVE_TIFF
+// TIFF held in memory, read through libtiff client callbacks
+struct TiffMemory
+{
+    const unsigned char* data;
+    toff_t size;
+    toff_t pos;
+};
+
+tmsize_t TiffMemoryRead(thandle_t handle, void* buf, tmsize_t n)
+{
+    TiffMemory& m = *(TiffMemory*)handle;
+    const toff_t available = m.pos < m.size ? m.size - m.pos : 0;
+    const toff_t num = std::min((toff_t)n, available);
+    std::memcpy(buf, m.data + m.pos, (size_t)num);
+    m.pos += num;
+    return (tmsize_t)num;
+}
+
+tmsize_t TiffMemoryWrite(thandle_t /*handle*/, void* /*buf*/, tmsize_t /*n*/)
+{
+    return 0;
+}
+
+toff_t TiffMemorySeek(thandle_t handle, toff_t off, int whence)
+{
+    TiffMemory& m = *(TiffMemory*)handle;
+    switch(whence) {
+    case SEEK_SET: m.pos = off; break;
+    case SEEK_CUR: m.pos += off; break;
+    case SEEK_END: m.pos = m.size + off; break;
+    }
+    return m.pos;
+}
+
+int TiffMemoryClose(thandle_t handle)
+{
+    delete (TiffMemory*)handle;
+    return 0;
+}
+
+toff_t TiffMemorySize(thandle_t handle)
+{
+    return ((TiffMemory*)handle)->size;
+}
+
+int TiffMemoryMap(thandle_t handle, void** base, toff_t* size)
+{
+    // Let libtiff read strips straight from our buffer
+    TiffMemory& m = *(TiffMemory*)handle;
+    *base = (void*)m.data;
+    *size = m.size;
+    return 1;
+}
+
+void TiffMemoryUnmap(thandle_t /*handle*/, void* /*base*/, toff_t /*size*/)
+{
+}
+
+// Open separate handle onto source for each decoding thread, since a
+// libtiff handle can't be shared between threads.
+TIFF* TiffOpen(const TiffSource& source)
+{
+    TIFFSetWarningHandler(0);
+
+    TIFF* tif = 0;
+    if(source.data) {
+        TiffMemory* m = new TiffMemory;
+        m->data = source.data;
+        m->size = source.size_bytes;
+        m->pos = 0;
+        tif = TIFFClientOpen(
+            "memory", "r", (thandle_t)m,
+            TiffMemoryRead, TiffMemoryWrite, TiffMemorySeek, TiffMemoryClose,
+            TiffMemorySize, TiffMemoryMap, TiffMemoryUnmap
+        );
+        // libtiff doesn't close handle on failure
+        if(!tif) delete m;
+    }else{
+        tif = TIFFOpen(source.filename.c_str(), "r");
+    }
+
+    if(!tif) {
+        throw std::runtime_error("Not a valid TIFF");
+    }
+    return tif;
+}
+
+VideoPixelFormat TiffFormat(uint16_t samples, uint16_t bits, uint16_t sample_format)
+{
+    if(sample_format == SAMPLEFORMAT_IEEEFP && bits == 32) {
+        if(samples == 1) return VideoFormatFromString("GRAY32F");
+        if(samples == 3) return VideoFormatFromString("RGB96F");
+    }else if(sample_format == SAMPLEFORMAT_UINT && bits == 8) {
+        if(samples == 1) return VideoFormatFromString("GRAY8");
+        if(samples == 2) return VideoFormatFromString("Y400A");
+        if(samples == 3) return VideoFormatFromString("RGB24");
+        if(samples == 4) return VideoFormatFromString("RGBA");
+    }else if(sample_format == SAMPLEFORMAT_UINT && bits == 16 && samples == 1) {
+        return VideoFormatFromString("GRAY16LE");
+    }
+
+    throw std::runtime_error("Unsupported TIFF format");
+}
+
+// Strips or tiles, which can be decoded independently
+struct TiffLayout
+{
+    bool tiled;
+    size_t chunk_w;
+    size_t chunk_h;
+    size_t chunks_across;
+    size_t num_chunks;
+    size_t pixel_bytes;
+};
+
+// Decodes every num_workers'th chunk, starting at worker, into img
+struct TiffDecodeWorker
+{
+    const TiffSource* source;
+    TIFF* first;
+    TiffLayout layout;
+    TypedImage img;
+    size_t num_workers;
+
+    void operator()(size_t worker) const
+    {
+        // Worker 0 reuses handle which read the header
+        TIFF* tif = (worker == 0) ? first : TiffOpen(*source);
+        std::vector<unsigned char> scratch;
+
+        bool success = true;
+        for(size_t c = worker; c < layout.num_chunks && success; c += num_workers) {
+            success = DecodeChunk(tif, c, scratch);
+        }
+
+        if(tif != first) {
+            TIFFClose(tif);
+        }
+        if(!success) {
+            throw std::runtime_error("Error whilst decoding TIFF data");
+        }
+    }
+
+    bool DecodeChunk(TIFF* tif, size_t c, std::vector<unsigned char>& scratch) const
+    {
+        const size_t x0 = (c % layout.chunks_across) * layout.chunk_w;
+        const size_t y0 = (c / layout.chunks_across) * layout.chunk_h;
+        const size_t copy_rows = std::min(layout.chunk_h, img.h - y0);
+        const size_t copy_bytes = std::min(layout.chunk_w, img.w - x0) * layout.pixel_bytes;
+        const size_t chunk_row_bytes = layout.chunk_w * layout.pixel_bytes;
+        unsigned char* dst = img.ptr + y0*img.pitch + x0*layout.pixel_bytes;
+
+        if(!layout.tiled && img.pitch == chunk_row_bytes) {
+            // Strip is contiguous in destination, so decode in place
+            return TIFFReadEncodedStrip(tif, (uint32_t)c, dst, (tmsize_t)(copy_rows*chunk_row_bytes)) != -1;
+        }
+
+        scratch.resize(layout.chunk_h * chunk_row_bytes);
+        const tmsize_t n = layout.tiled ?
+            TIFFReadEncodedTile(tif, (uint32_t)c, &scratch[0], (tmsize_t)scratch.size()) :
+            TIFFReadEncodedStrip(tif, (uint32_t)c, &scratch[0], (tmsize_t)(copy_rows*chunk_row_bytes));
+        if(n == -1) {
+            return false;
+        }
+
+        for(size_t r=0; r < copy_rows; ++r) {
+            std::memcpy(dst + r*img.pitch, &scratch[r*chunk_row_bytes], copy_bytes);
+        }
+        return true;
+    }
+};
+#endif // HAVE_TIFF
+
+void ReadTiff(const TiffSource& source, TypedImage& img, ImageDecode mode)
+{
+#ifdef HAVE_TIFF
+    TIFF* tif = TiffOpen(source);
+
+    try {
+        uint32_t w = 0;
+        uint32_t h = 0;
+        uint16_t bits = 0;
+        uint16_t samples = 0;
+        uint16_t sample_format = SAMPLEFORMAT_UINT;
+        uint16_t planar = PLANARCONFIG_CONTIG;
+        uint16_t photometric = PHOTOMETRIC_MINISBLACK;
+
+        TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &w);
+        TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &h);
+        TIFFGetFieldDefaulted(tif, TIFFTAG_BITSPERSAMPLE, &bits);
+        TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &samples);
+        TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLEFORMAT, &sample_format);
+        TIFFGetFieldDefaulted(tif, TIFFTAG_PLANARCONFIG, &planar);
+        TIFFGetField(tif, TIFFTAG_PHOTOMETRIC, &photometric);
+
+        if(w == 0 || h == 0) {
+            throw std::runtime_error("Invalid TIFF dimensions");
+        }
+        if(samples > 1 && planar != PLANARCONFIG_CONTIG) {
+            throw std::runtime_error("Planar TIFF not supported");
+        }
+        if(photometric != PHOTOMETRIC_MINISBLACK && photometric != PHOTOMETRIC_RGB) {
+            throw std::runtime_error("Unsupported TIFF photometric interpretation");
+        }
+
+        const VideoPixelFormat fmt = TiffFormat(samples, bits, sample_format);
+
+        TiffLayout layout;
+        layout.pixel_bytes = fmt.bpp / 8;
+        layout.tiled = TIFFIsTiled(tif) != 0;
+        if(layout.tiled) {
+            uint32_t tile_w = 0;
+            uint32_t tile_h = 0;
+            TIFFGetField(tif, TIFFTAG_TILEWIDTH, &tile_w);
+            TIFFGetField(tif, TIFFTAG_TILELENGTH, &tile_h);
+            if(tile_w == 0 || tile_h == 0) {
+                throw std::runtime_error("Invalid TIFF tile size");
+            }
+            layout.chunk_w = tile_w;
+            layout.chunk_h = tile_h;
+        }else{
+            uint32_t rows_per_strip = 0;
+            TIFFGetFieldDefaulted(tif, TIFFTAG_ROWSPERSTRIP, &rows_per_strip);
+            layout.chunk_w = w;
+            layout.chunk_h = std::max<uint32_t>(1, std::min(rows_per_strip, h));
+        }
+        layout.chunks_across = (w + layout.chunk_w - 1) / layout.chunk_w;
+        layout.num_chunks = layout.chunks_across * ((h + layout.chunk_h - 1) / layout.chunk_h);
+
+        if(BeginDecode(img, mode, w, h, fmt, w * layout.pixel_bytes)) {
+            ThreadPool& pool = DefaultThreadPool();
+
+            TiffDecodeWorker worker;
+            worker.source = &source;
+            worker.first = tif;
+            worker.layout = layout;
+            worker.img = img;
+            worker.num_workers = std::min(layout.num_chunks, pool.NumThreads() + 1);
+
+            if(worker.num_workers > 1) {
+                pool.ParallelFor(worker.num_workers, worker);
+            }else{
+                worker(0);
+            }
+        }
+    }catch(...) {
+        TIFFClose(tif);
+        if(mode == ImageDecodeAlloc) {
+            img.Dealloc();
+        }
+        throw;
+    }
+
+    TIFFClose(tif);
+#else
+    throw std::runtime_error("TIFF Support not enabled. Please rebuild Pangolin.");
+#endif // HAVE_TIFF
+}
+
+TypedImage LoadTiff(const std::string& filename)
+{
+    TypedImage img;
+    try {
+        ReadTiff(TiffSource(filename), img, ImageDecodeAlloc);
+    }catch(const std::exception& e) {
+        throw std::runtime_error("Unable to load TIFF file, '" + filename + "': " + e.what());
+    }
+    return img;
+}
+
+void SaveTiff(const Image<unsigned char>& image, const pangolin::VideoPixelFormat& fmt, const std::string& filename, bool top_line_first)
+{
+#ifdef HAVE_TIFF
+    uint16_t sample_format = SAMPLEFORMAT_UINT;
+    if(fmt.format == "GRAY32F" || fmt.format == "RGB96F") {
+        sample_format = SAMPLEFORMAT_IEEEFP;
+    }else if(fmt.format != "GRAY8" && fmt.format != "GRAY16LE" && fmt.format != "Y400A" &&
+             fmt.format != "RGB24" && fmt.format != "RGBA") {
+        throw std::runtime_error("TIFF Saving not supported for " + fmt.format + " images");
+    }
+
+    TIFFSetWarningHandler(0);
+    TIFF* tif = TIFFOpen(filename.c_str(), "w");
+    if(!tif) {
+        throw std::runtime_error( "TIFF Error: Could not open file '" + filename + "' for writing" );
+    }
+
+    TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, (uint32_t)image.w);
+    TIFFSetField(tif, TIFFTAG_IMAGELENGTH, (uint32_t)image.h);
+    TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, fmt.channel_bits[0]);
+    TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, fmt.channels);
+    TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT, sample_format);
+    TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, fmt.channels >= 3 ? PHOTOMETRIC_RGB : PHOTOMETRIC_MINISBLACK);
+    TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+    TIFFSetField(tif, TIFFTAG_ORIENTATION, ORIENTATION_TOPLEFT);
+    if(fmt.channels == 2 || fmt.channels == 4) {
+        const uint16_t extra = EXTRASAMPLE_UNASSALPHA;
+        TIFFSetField(tif, TIFFTAG_EXTRASAMPLES, 1, &extra);
+    }
+    TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, TIFFDefaultStripSize(tif, 0));
+
+    // libtiff may modify the row it is given
+    const size_t row_bytes = image.w * fmt.bpp / 8;
+    std::vector<unsigned char> row(row_bytes);
+    for(size_t r=0; r < image.h; ++r) {
+        const size_t y = top_line_first ? r : image.h - r - 1;
+        std::memcpy(&row[0], image.ptr + y*image.pitch, row_bytes);
+        if(TIFFWriteScanline(tif, &row[0], (uint32_t)r, 0) < 0) {
+            TIFFClose(tif);
+            throw std::runtime_error( "TIFF Error: Error whilst writing '" + filename + "'" );
+        }
+    }
+
+    TIFFClose(tif);
+#else
+    throw std::runtime_error("TIFF Support not enabled. Please rebuild Pangolin.");
+#endif // HAVE_TIFF
+}
+
+void ReadImage(std::istream& in, ImageFileType file_type, TypedImage& img, ImageDecode mode, const ImageLoadOptions& options = ImageLoadOptions())
+{
+    switch (file_type) {
+    case ImageFileTypePng:
+        return ReadPng(in, img, mode);
+    case ImageFileTypeJpg:
+        return ReadJpg(in, img, mode, options);
+    case ImageFileTypePpm:
+        return ReadPpm(in, img, mode);
+    case ImageFileTypeExr:
+        return ReadExr(in, img, mode);
+    case ImageFileTypeTiff:
+    {
+        // TIFF needs random access from several threads, so buffer it
+        const std::vector<unsigned char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        return ReadTiff(TiffSource(data.empty() ? 0 : &data[0], data.size()), img, mode);
+    }
+    default:
+        throw std::runtime_error("Unsupported image file type");
+    }
+}
+
+void ReadImage(const unsigned char* data, size_t size_bytes, ImageFileType file_type, TypedImage& img, ImageDecode mode)
+{
+    if(file_type == ImageFileTypeTiff) {
+        ReadTiff(TiffSource(data, size_bytes), img, mode);
+        return;
+    }
+
+    memstreambuf buf(data, size_bytes);
+    std::istream in(&buf);
+    ReadImage(in, file_type, img, mode);
+}
+
+void ReadImage(const std::string& filename, ImageFileType file_type, TypedImage& img, ImageDecode mode, const ImageLoadOptions& options = ImageLoadOptions())
+{
+    if(file_type == ImageFileTypeTga) {
+        ReadTga(filename, img, mode);
+        return;
+    }
+
+    std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+    if(!in.is_open()) {
+        throw std::runtime_error("Unable to open image file, '" + filename + "'");
+    }
+
+    try {
+        if(file_type == ImageFileTypeTiff) {
+            // Decoding threads each open the file themselves
+            in.close();
+            ReadTiff(TiffSource(filename), img, mode);
+        }else{
+            ReadImage(in, file_type, img, mode, options);
+        }
+    }catch(const std::exception& e) {
+        throw std::runtime_error("Unable to load image file, '" + filename + "': " + e.what());
+    }
+}
 
 TypedImage LoadImage(const std::string& filename, ImageFileType file_type)
 {
@@ -535,6 +1677,10 @@ TypedImage LoadImage(const std::string& filename, ImageFileType file_type)
         return LoadJpg(filename);
     case ImageFileTypePpm:
         return LoadPpm(filename);
+    case ImageFileTypeExr:
+        return LoadExr(filename);
+    case ImageFileTypeTiff:
+        return LoadTiff(filename);
     default:
         throw std::runtime_error("Unsupported image file type, '" + filename + "'");
     }
@@ -546,13 +1692,80 @@ TypedImage LoadImage(const std::string& filename)
     return LoadImage( filename, file_type );
 }
 
+void LoadImage(const std::string& filename, Image<unsigned char>& dst, const VideoPixelFormat& fmt, ImageFileType file_type)
+{
+    TypedImage img(dst.w, dst.h, dst.pitch, dst.ptr, fmt);
+    ReadImage(filename, file_type, img, ImageDecodeInto);
+}
+
+void LoadImage(const std::string& filename, Image<unsigned char>& dst, const VideoPixelFormat& fmt)
+{
+    LoadImage(filename, dst, fmt, FileType(filename));
+}
+
+TypedImage ProbeImage(const std::string& filename, ImageFileType file_type)
+{
+    TypedImage img;
+    ReadImage(filename, file_type, img, ImageDecodeHeader);
+    return img;
+}
+
+TypedImage ProbeImage(const std::string& filename)
+{
+    return ProbeImage(filename, FileType(filename));
+}
+
+TypedImage LoadImage(const std::string& filename, const ImageLoadOptions& options)
+{
+    TypedImage img;
+    ReadImage(filename, FileType(filename), img, ImageDecodeAlloc, options);
+    return img;
+}
+
+void LoadImage(const std::string& filename, Image<unsigned char>& dst, const VideoPixelFormat& fmt, const ImageLoadOptions& options)
+{
+    TypedImage img(dst.w, dst.h, dst.pitch, dst.ptr, fmt);
+    ReadImage(filename, FileType(filename), img, ImageDecodeInto, options);
+}
+
+TypedImage ProbeImage(const std::string& filename, const ImageLoadOptions& options)
+{
+    TypedImage img;
+    ReadImage(filename, FileType(filename), img, ImageDecodeHeader, options);
+    return img;
+}
+
+TypedImage LoadImage(const unsigned char* data, size_t size_bytes, ImageFileType file_type)
+{
+    TypedImage img;
+    ReadImage(data, size_bytes, file_type, img, ImageDecodeAlloc);
+    return img;
+}
+
+TypedImage LoadImage(const unsigned char* data, size_t size_bytes)
+{
+    return LoadImage(data, size_bytes, FileTypeMagic(data, size_bytes));
+}
+
+void LoadImage(const unsigned char* data, size_t size_bytes, Image<unsigned char>& dst, const VideoPixelFormat& fmt)
+{
+    TypedImage img(dst.w, dst.h, dst.pitch, dst.ptr, fmt);
+    ReadImage(data, size_bytes, FileTypeMagic(data, size_bytes), img, ImageDecodeInto);
+}
+
 void SaveImage(const Image<unsigned char>& image, const pangolin::VideoPixelFormat& fmt, const std::string& filename, ImageFileType file_type, bool top_line_first)
 {
     switch (file_type) {
     case ImageFileTypePng:
         return SavePng(image, fmt, filename, top_line_first);
+    case ImageFileTypeJpg:
+        return SaveJpg(image, fmt, filename, 90, top_line_first);
+    case ImageFileTypePpm:
+        return SavePpm(image, fmt, filename, top_line_first);
     case ImageFileTypeExr:
         return SaveExr(image, fmt, filename, top_line_first);
+    case ImageFileTypeTiff:
+        return SaveTiff(image, fmt, filename, top_line_first);
     default:
         throw std::runtime_error("Unsupported image file type, '" + filename + "'");
     }
@@ -570,6 +1783,30 @@ void SaveImage(const TypedImage& image, const std::string& filename, bool top_li
     SaveImage(image, image.fmt, filename, top_line_first);
 }
 
+void SaveImage(const Image<unsigned char>& image, const pangolin::VideoPixelFormat& fmt, std::vector<unsigned char>& out, ImageFileType file_type, bool top_line_first)
+{
+    vectorstreambuf buf(out);
+    std::ostream os(&buf);
+
+    switch (file_type) {
+    case ImageFileTypePng:
+        return SavePng(image, fmt, os, top_line_first);
+    case ImageFileTypeJpg:
+        return SaveJpg(image, fmt, os, 90, top_line_first);
+    case ImageFileTypePpm:
+        return SavePpm(image, fmt, os, top_line_first);
+    case ImageFileTypeExr:
+        return SaveExr(image, fmt, os, top_line_first);
+    default:
+        throw std::runtime_error("Unsupported image file type for in-memory encoding");
+    }
+}
+
+void SaveImage(const TypedImage& image, std::vector<unsigned char>& out, ImageFileType file_type, bool top_line_first)
+{
+    SaveImage(image, image.fmt, out, file_type, top_line_first);
+}
+
 void FreeImage(TypedImage& img)
 {
     img.Dealloc();
@@ -0,0 +1,149 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <pangolin/image/image_pool.h>
+
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN_
+#include <malloc.h>
+#endif
+
+namespace pangolin
+{
+
+unsigned char* AlignedAlloc(size_t bytes)
+{
+    void* ptr = 0;
+#ifdef _WIN_
+    ptr = _aligned_malloc(bytes ? bytes : 1, ImageAlignmentBytes);
+#else
+    if(posix_memalign(&ptr, ImageAlignmentBytes, bytes ? bytes : 1) != 0) {
+        ptr = 0;
+    }
+#endif
+    if(!ptr) {
+        throw std::bad_alloc();
+    }
+    return (unsigned char*)ptr;
+}
+
+void AlignedFree(unsigned char* ptr)
+{
+#ifdef _WIN_
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+ImageBufferPool::ImageBufferPool(size_t max_cached_bytes)
+    : cached_bytes(0), max_cached_bytes(max_cached_bytes)
+{
+}
+
+ImageBufferPool::~ImageBufferPool()
+{
+    Clear();
+}
+
+size_t ImageBufferPool::BucketSize(size_t bytes)
+{
+    const size_t min_bucket = 4096;
+    if(bytes <= min_bucket) {
+        return min_bucket;
+    }
+
+    // Round up to multiple of a quarter of the largest power of two <= bytes,
+    // wasting at most 25%.
+    size_t pow2 = min_bucket;
+    while(pow2 <= bytes / 2) {
+        pow2 *= 2;
+    }
+    const size_t step = pow2 / 4;
+    return ((bytes + step - 1) / step) * step;
+}
+
+unsigned char* ImageBufferPool::Allocate(size_t bytes)
+{
+    const size_t bucket = BucketSize(bytes);
+    {
+        boostd::unique_lock<boostd::mutex> lock(mutex);
+        std::map<size_t, std::vector<unsigned char*> >::iterator it = free_buffers.find(bucket);
+        if(it != free_buffers.end() && !it->second.empty()) {
+            unsigned char* ptr = it->second.back();
+            it->second.pop_back();
+            cached_bytes -= bucket;
+            return ptr;
+        }
+    }
+    return AlignedAlloc(bucket);
+}
+
+void ImageBufferPool::Free(unsigned char* ptr, size_t bytes)
+{
+    if(!ptr) return;
+
+    const size_t bucket = BucketSize(bytes);
+    {
+        boostd::unique_lock<boostd::mutex> lock(mutex);
+        if(cached_bytes + bucket <= max_cached_bytes) {
+            free_buffers[bucket].push_back(ptr);
+            cached_bytes += bucket;
+            return;
+        }
+    }
+    AlignedFree(ptr);
+}
+
+void ImageBufferPool::Clear()
+{
+    boostd::unique_lock<boostd::mutex> lock(mutex);
+    for(std::map<size_t, std::vector<unsigned char*> >::iterator it = free_buffers.begin(); it != free_buffers.end(); ++it) {
+        for(size_t i=0; i < it->second.size(); ++i) {
+            AlignedFree(it->second[i]);
+        }
+    }
+    free_buffers.clear();
+    cached_bytes = 0;
+}
+
+size_t ImageBufferPool::CachedBytes() const
+{
+    boostd::unique_lock<boostd::mutex> lock(mutex);
+    return cached_bytes;
+}
+
+ImageBufferPool& DefaultImageBufferPool()
+{
+    static ImageBufferPool pool;
+    return pool;
+}
+
+}
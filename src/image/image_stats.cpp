@@ -0,0 +1,523 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <pangolin/image/image_stats.h>
+#include <pangolin/utils/thread_pool.h>
+
+#include <algorithm>
+#include <limits>
+#include <stdint.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#  include <emmintrin.h>
+#  define PANGOLIN_STATS_SSE2
+#endif
+
+namespace pangolin
+{
+
+// Images smaller than this are processed on the calling thread
+const size_t stats_min_parallel_pixels = 1 << 16;
+
+template<typename T>
+Image<T> ClampedRoi(const Image<T>& img, const ImageRoi& roi)
+{
+    if(roi.w == 0 || roi.h == 0) {
+        return img;
+    }
+    const size_t x = std::min(roi.x, img.w);
+    const size_t y = std::min(roi.y, img.h);
+    return Image<T>(
+        std::min(roi.w, img.w - x), std::min(roi.h, img.h - y), img.pitch,
+        (T*)((unsigned char*)img.ptr + y*img.pitch) + x
+    );
+}
+
+inline size_t NumRowBlocks(size_t w, size_t h)
+{
+    if(w*h < stats_min_parallel_pixels) {
+        return 1;
+    }
+    return std::max((size_t)1, std::min(h, DefaultThreadPool().NumThreads() + 1));
+}
+
+// True for pixels which count towards statistics
+template<typename T>
+inline bool ValidPixel(T v, bool ignore_zero)
+{
+    return !(ignore_zero && v == 0);
+}
+
+// NaN and infinities would poison sums and can't be binned
+template<>
+inline bool ValidPixel<float>(float v, bool ignore_zero)
+{
+    return v - v == 0 && !(ignore_zero && v == 0);
+}
+
+// Partial sums over some rows, merged once all rows are done
+struct StatsAccum
+{
+    StatsAccum()
+        : count(0), min(std::numeric_limits<double>::infinity()),
+          max(-std::numeric_limits<double>::infinity()), sum(0), sum_sq(0)
+    {
+    }
+
+    void Merge(const StatsAccum& o)
+    {
+        count += o.count;
+        min = std::min(min, o.min);
+        max = std::max(max, o.max);
+        sum += o.sum;
+        sum_sq += o.sum_sq;
+    }
+
+    size_t count;
+    double min;
+    double max;
+    double sum;
+    double sum_sq;
+};
+
+// Sums over one integer row. Zeros add nothing to the sums, so
+// ignore_zero only affects min and count.
+template<typename T>
+struct IntRowSums
+{
+    IntRowSums()
+        : mn(std::numeric_limits<T>::max()), mx(0), sum(0), sum_sq(0), zeros(0)
+    {
+    }
+
+    void Add(const T* p, size_t x, size_t w, bool ignore_zero)
+    {
+        for(; x < w; ++x) {
+            const T v = p[x];
+            if(!(ignore_zero && v == 0)) mn = std::min(mn, v);
+            mx = std::max(mx, v);
+            sum += v;
+            sum_sq += uint64_t(v) * v;
+            zeros += (v == 0);
+        }
+    }
+
+    void Finish(StatsAccum& a, size_t w, bool ignore_zero) const
+    {
+        const size_t n = ignore_zero ? w - zeros : w;
+        if(n) {
+            a.count += n;
+            a.min = std::min(a.min, (double)mn);
+            a.max = std::max(a.max, (double)mx);
+            a.sum += (double)sum;
+            a.sum_sq += (double)sum_sq;
+        }
+    }
+
+    T mn;
+    T mx;
+    uint64_t sum;
+    uint64_t sum_sq;
+    size_t zeros;
+};
+
+#ifdef PANGOLIN_STATS_SSE2
+// Pixels per chunk for which narrow SIMD lane counters can't overflow
+const size_t stats_sse_chunk = 1 << 16;
+
+// Accumulate the leading multiple of 16 pixels, returning how many were used
+inline size_t AccumulateRowSse2(IntRowSums<uint8_t>& s, const uint8_t* p, size_t w, bool ignore_zero)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i zero_to_max = ignore_zero ? _mm_set1_epi8(-1) : zero;
+    __m128i vmn = _mm_set1_epi8(-1);
+    __m128i vmx = zero;
+    __m128i vsum = zero;
+    __m128i vzeros = zero;
+
+    const size_t n = w & ~size_t(15);
+    for(size_t x0=0; x0 < n; x0 += stats_sse_chunk) {
+        const size_t x1 = std::min(n, x0 + stats_sse_chunk);
+        __m128i vsum_sq = zero;
+        for(size_t x=x0; x < x1; x += 16) {
+            const __m128i v = _mm_loadu_si128((const __m128i*)(p + x));
+            const __m128i is_zero = _mm_cmpeq_epi8(v, zero);
+            vmn = _mm_min_epu8(vmn, _mm_or_si128(v, _mm_and_si128(is_zero, zero_to_max)));
+            vmx = _mm_max_epu8(vmx, v);
+            vsum = _mm_add_epi64(vsum, _mm_sad_epu8(v, zero));
+            vzeros = _mm_add_epi64(vzeros, _mm_sad_epu8(_mm_and_si128(is_zero, one), zero));
+            const __m128i lo = _mm_unpacklo_epi8(v, zero);
+            const __m128i hi = _mm_unpackhi_epi8(v, zero);
+            vsum_sq = _mm_add_epi32(vsum_sq, _mm_add_epi32(_mm_madd_epi16(lo, lo), _mm_madd_epi16(hi, hi)));
+        }
+        uint32_t lanes_sq[4];
+        _mm_storeu_si128((__m128i*)lanes_sq, vsum_sq);
+        s.sum_sq += (uint64_t)lanes_sq[0] + lanes_sq[1] + lanes_sq[2] + lanes_sq[3];
+    }
+
+    uint8_t lanes_mn[16], lanes_mx[16];
+    uint64_t lanes_sum[2], lanes_zeros[2];
+    _mm_storeu_si128((__m128i*)lanes_mn, vmn);
+    _mm_storeu_si128((__m128i*)lanes_mx, vmx);
+    _mm_storeu_si128((__m128i*)lanes_sum, vsum);
+    _mm_storeu_si128((__m128i*)lanes_zeros, vzeros);
+    for(int l=0; l < 16; ++l) {
+        s.mn = std::min(s.mn, lanes_mn[l]);
+        s.mx = std::max(s.mx, lanes_mx[l]);
+    }
+    s.sum += lanes_sum[0] + lanes_sum[1];
+    s.zeros += (size_t)(lanes_zeros[0] + lanes_zeros[1]);
+    return n;
+}
+
+// Accumulate the leading multiple of 8 pixels, returning how many were used.
+// SSE2 only has signed 16 bit min / max, so compare values offset by 0x8000.
+inline size_t AccumulateRowSse2(IntRowSums<uint16_t>& s, const uint16_t* p, size_t w, bool ignore_zero)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi16((short)0x8000);
+    const __m128i zero_to_max = ignore_zero ? _mm_set1_epi16(-1) : zero;
+    __m128i vmn = _mm_set1_epi16(0x7FFF);
+    __m128i vmx = bias;
+    __m128i vsum_sq = zero;
+
+    const size_t n = w & ~size_t(7);
+    for(size_t x0=0; x0 < n; x0 += stats_sse_chunk) {
+        const size_t x1 = std::min(n, x0 + stats_sse_chunk);
+        __m128i vsum = zero;
+        __m128i vzeros = zero;
+        for(size_t x=x0; x < x1; x += 8) {
+            const __m128i v = _mm_loadu_si128((const __m128i*)(p + x));
+            const __m128i is_zero = _mm_cmpeq_epi16(v, zero);
+            const __m128i vmin_in = _mm_or_si128(v, _mm_and_si128(is_zero, zero_to_max));
+            vmn = _mm_min_epi16(vmn, _mm_xor_si128(vmin_in, bias));
+            vmx = _mm_max_epi16(vmx, _mm_xor_si128(v, bias));
+            vsum = _mm_add_epi32(vsum, _mm_add_epi32(_mm_unpacklo_epi16(v, zero), _mm_unpackhi_epi16(v, zero)));
+            vzeros = _mm_sub_epi16(vzeros, is_zero);
+            const __m128i sq_lo = _mm_mullo_epi16(v, v);
+            const __m128i sq_hi = _mm_mulhi_epu16(v, v);
+            const __m128i sq0 = _mm_unpacklo_epi16(sq_lo, sq_hi);
+            const __m128i sq1 = _mm_unpackhi_epi16(sq_lo, sq_hi);
+            vsum_sq = _mm_add_epi64(vsum_sq, _mm_add_epi64(
+                _mm_add_epi64(_mm_unpacklo_epi32(sq0, zero), _mm_unpackhi_epi32(sq0, zero)),
+                _mm_add_epi64(_mm_unpacklo_epi32(sq1, zero), _mm_unpackhi_epi32(sq1, zero))
+            ));
+        }
+        uint32_t lanes_sum[4];
+        uint16_t lanes_zeros[8];
+        _mm_storeu_si128((__m128i*)lanes_sum, vsum);
+        _mm_storeu_si128((__m128i*)lanes_zeros, vzeros);
+        s.sum += (uint64_t)lanes_sum[0] + lanes_sum[1] + lanes_sum[2] + lanes_sum[3];
+        for(int l=0; l < 8; ++l) {
+            s.zeros += lanes_zeros[l];
+        }
+    }
+
+    uint16_t lanes_mn[8], lanes_mx[8];
+    uint64_t lanes_sum_sq[2];
+    _mm_storeu_si128((__m128i*)lanes_mn, _mm_xor_si128(vmn, bias));
+    _mm_storeu_si128((__m128i*)lanes_mx, _mm_xor_si128(vmx, bias));
+    _mm_storeu_si128((__m128i*)lanes_sum_sq, vsum_sq);
+    for(int l=0; l < 8; ++l) {
+        s.mn = std::min(s.mn, lanes_mn[l]);
+        s.mx = std::max(s.mx, lanes_mx[l]);
+    }
+    s.sum_sq += lanes_sum_sq[0] + lanes_sum_sq[1];
+    return n;
+}
+#endif
+
+template<typename T>
+void AccumulateRow(StatsAccum& a, const T* p, size_t w, bool ignore_zero)
+{
+    IntRowSums<T> sums;
+    size_t x = 0;
+#ifdef PANGOLIN_STATS_SSE2
+    x = AccumulateRowSse2(sums, p, w, ignore_zero);
+#endif
+    sums.Add(p, x, w, ignore_zero);
+    sums.Finish(a, w, ignore_zero);
+}
+
+// Float rows, accumulating sums in double lanes to limit rounding.
+template<>
+void AccumulateRow<float>(StatsAccum& a, const float* p, size_t w, bool ignore_zero)
+{
+    float mn = std::numeric_limits<float>::infinity();
+    float mx = -std::numeric_limits<float>::infinity();
+    double sum = 0;
+    double sum_sq = 0;
+    size_t n = 0;
+    size_t x = 0;
+
+#ifdef PANGOLIN_STATS_SSE2
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 pinf = _mm_set1_ps(mn);
+    const __m128 ninf = _mm_set1_ps(mx);
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    __m128 vmn = pinf;
+    __m128 vmx = ninf;
+    __m128d vsum = _mm_setzero_pd();
+    __m128d vsum_sq = _mm_setzero_pd();
+    __m128i vn = _mm_setzero_si128();
+
+    for(; x + 4 <= w; x += 4) {
+        const __m128 v = _mm_loadu_ps(p + x);
+        // Finite if |v| < inf, which is false for NaN too
+        __m128 valid = _mm_cmplt_ps(_mm_and_ps(v, abs_mask), pinf);
+        if(ignore_zero) {
+            valid = _mm_and_ps(valid, _mm_cmpneq_ps(v, zero));
+        }
+        const __m128 vv = _mm_and_ps(valid, v);
+        vmn = _mm_min_ps(vmn, _mm_or_ps(vv, _mm_andnot_ps(valid, pinf)));
+        vmx = _mm_max_ps(vmx, _mm_or_ps(vv, _mm_andnot_ps(valid, ninf)));
+        const __m128d lo = _mm_cvtps_pd(vv);
+        const __m128d hi = _mm_cvtps_pd(_mm_movehl_ps(vv, vv));
+        vsum = _mm_add_pd(vsum, _mm_add_pd(lo, hi));
+        vsum_sq = _mm_add_pd(vsum_sq, _mm_add_pd(_mm_mul_pd(lo, lo), _mm_mul_pd(hi, hi)));
+        vn = _mm_sub_epi32(vn, _mm_castps_si128(valid));
+    }
+
+    float lanes_mn[4], lanes_mx[4];
+    double lanes_sum[2], lanes_sum_sq[2];
+    int32_t lanes_n[4];
+    _mm_storeu_ps(lanes_mn, vmn);
+    _mm_storeu_ps(lanes_mx, vmx);
+    _mm_storeu_pd(lanes_sum, vsum);
+    _mm_storeu_pd(lanes_sum_sq, vsum_sq);
+    _mm_storeu_si128((__m128i*)lanes_n, vn);
+    for(int l=0; l < 4; ++l) {
+        mn = std::min(mn, lanes_mn[l]);
+        mx = std::max(mx, lanes_mx[l]);
+        n += lanes_n[l];
+    }
+    sum = lanes_sum[0] + lanes_sum[1];
+    sum_sq = lanes_sum_sq[0] + lanes_sum_sq[1];
+#endif
+
+    for(; x < w; ++x) {
+        const float v = p[x];
+        if(ValidPixel(v, ignore_zero)) {
+            mn = std::min(mn, v);
+            mx = std::max(mx, v);
+            sum += v;
+            sum_sq += (double)v * v;
+            ++n;
+        }
+    }
+
+    if(n) {
+        a.count += n;
+        a.min = std::min(a.min, (double)mn);
+        a.max = std::max(a.max, (double)mx);
+        a.sum += sum;
+        a.sum_sq += sum_sq;
+    }
+}
+
+template<typename T>
+struct StatsWorker
+{
+    Image<T> img;
+    size_t rows_per_block;
+    bool ignore_zero;
+    std::vector<StatsAccum>* partials;
+
+    void operator()(size_t b) const
+    {
+        const size_t y_end = std::min(img.h, (b+1) * rows_per_block);
+        StatsAccum& a = (*partials)[b];
+        for(size_t y = b * rows_per_block; y < y_end; ++y) {
+            AccumulateRow(a, (const T*)((unsigned char*)img.ptr + y*img.pitch), img.w, ignore_zero);
+        }
+    }
+};
+
+template<typename T>
+ImageStats GetImageStats(const Image<T>& image, const ImageRoi& roi, bool ignore_zero)
+{
+    const Image<T> img = ClampedRoi(image, roi);
+    const size_t num_blocks = NumRowBlocks(img.w, img.h);
+
+    std::vector<StatsAccum> partials(num_blocks);
+    StatsWorker<T> worker;
+    worker.img = img;
+    worker.rows_per_block = (img.h + num_blocks - 1) / num_blocks;
+    worker.ignore_zero = ignore_zero;
+    worker.partials = &partials;
+
+    if(num_blocks > 1) {
+        DefaultThreadPool().ParallelFor(num_blocks, worker);
+    }else{
+        worker(0);
+    }
+
+    StatsAccum total;
+    for(size_t b=0; b < num_blocks; ++b) {
+        total.Merge(partials[b]);
+    }
+
+    ImageStats stats;
+    if(total.count) {
+        stats.count = total.count;
+        stats.min = total.min;
+        stats.max = total.max;
+        stats.mean = total.sum / total.count;
+        stats.variance = std::max(0.0, total.sum_sq / total.count - stats.mean * stats.mean);
+    }
+    return stats;
+}
+
+template<typename T>
+struct HistogramWorker
+{
+    Image<T> img;
+    size_t rows_per_block;
+    bool ignore_zero;
+    double min;
+    double bins_per_unit;
+    size_t num_bins;
+    std::vector<ImageHistogram>* partials;
+
+    void operator()(size_t b) const
+    {
+        const size_t y_end = std::min(img.h, (b+1) * rows_per_block);
+        ImageHistogram& hist = (*partials)[b];
+        hist.bins.assign(num_bins, 0);
+        size_t* bins = &hist.bins[0];
+        const double last = (double)(num_bins - 1);
+
+        for(size_t y = b * rows_per_block; y < y_end; ++y) {
+            const T* p = (const T*)((unsigned char*)img.ptr + y*img.pitch);
+            for(size_t x=0; x < img.w; ++x) {
+                const T v = p[x];
+                if(ValidPixel(v, ignore_zero)) {
+                    // Written so that NaN, from infinite min, falls in the first bin
+                    const double f = ((double)v - min) * bins_per_unit;
+                    ++bins[f > 0 ? (size_t)std::min(f, last) : 0];
+                    ++hist.count;
+                }
+            }
+        }
+    }
+};
+
+template<typename T>
+void GetImageHistogram(ImageHistogram& hist, const Image<T>& image, double min, double max, size_t num_bins, const ImageRoi& roi, bool ignore_zero)
+{
+    num_bins = std::max(num_bins, (size_t)1);
+    const Image<T> img = ClampedRoi(image, roi);
+    const size_t num_blocks = NumRowBlocks(img.w, img.h);
+
+    std::vector<ImageHistogram> partials(num_blocks);
+    HistogramWorker<T> worker;
+    worker.img = img;
+    worker.rows_per_block = (img.h + num_blocks - 1) / num_blocks;
+    worker.ignore_zero = ignore_zero;
+    worker.min = min;
+    const double range = max - min;
+    worker.bins_per_unit = (range > 0 && range < std::numeric_limits<double>::infinity()) ? num_bins / range : 0.0;
+    worker.num_bins = num_bins;
+    worker.partials = &partials;
+
+    if(num_blocks > 1) {
+        DefaultThreadPool().ParallelFor(num_blocks, worker);
+    }else{
+        worker(0);
+    }
+
+    hist.min = min;
+    hist.max = max;
+    hist.count = 0;
+    hist.bins.assign(num_bins, 0);
+    for(size_t b=0; b < num_blocks; ++b) {
+        hist.count += partials[b].count;
+        for(size_t i=0; i < num_bins; ++i) {
+            hist.bins[i] += partials[b].bins[i];
+        }
+    }
+}
+
+template<typename T>
+std::pair<double,double> GetImagePercentiles(const Image<T>& img, double lo, double hi, const ImageRoi& roi, bool ignore_zero)
+{
+    const ImageStats stats = GetImageStats(img, roi, ignore_zero);
+    if(!stats.count) {
+        return std::pair<double,double>(0.0, 0.0);
+    }
+
+    // Integer values get a bin each where the range allows
+    const double range = stats.max - stats.min;
+    const bool integral = std::numeric_limits<T>::is_integer;
+    const size_t num_bins = (integral && range < 4096) ? (size_t)range + 1 : 4096;
+    const double max = integral && range < 4096 ? stats.max + 1 : stats.max;
+
+    ImageHistogram hist;
+    GetImageHistogram(hist, img, stats.min, max, num_bins, roi, ignore_zero);
+    return std::pair<double,double>(
+        std::max(stats.min, hist.Percentile(lo)),
+        std::min(stats.max, hist.Percentile(hi))
+    );
+}
+
+double ImageHistogram::BinWidth() const
+{
+    return bins.empty() ? 0.0 : (max - min) / bins.size();
+}
+
+double ImageHistogram::Percentile(double p) const
+{
+    if(!count) {
+        return min;
+    }
+
+    const double target = std::min(std::max(p, 0.0), 1.0) * count;
+    const double width = BinWidth();
+    size_t cumulative = 0;
+    for(size_t i=0; i < bins.size(); ++i) {
+        if(bins[i] && cumulative + bins[i] >= target) {
+            return min + width * (i + (target - cumulative) / bins[i]);
+        }
+        cumulative += bins[i];
+    }
+    return max;
+}
+
+#define PANGOLIN_INSTANTIATE_IMAGE_STATS(T) \
+    template PANGOLIN_EXPORT ImageStats GetImageStats<T>(const Image<T>&, const ImageRoi&, bool); \
+    template PANGOLIN_EXPORT void GetImageHistogram<T>(ImageHistogram&, const Image<T>&, double, double, size_t, const ImageRoi&, bool); \
+    template PANGOLIN_EXPORT std::pair<double,double> GetImagePercentiles<T>(const Image<T>&, double, double, const ImageRoi&, bool);
+
+PANGOLIN_INSTANTIATE_IMAGE_STATS(uint8_t)
+PANGOLIN_INSTANTIATE_IMAGE_STATS(uint16_t)
+PANGOLIN_INSTANTIATE_IMAGE_STATS(float)
+
+#undef PANGOLIN_INSTANTIATE_IMAGE_STATS
+
+}
@@ -0,0 +1,221 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <pangolin/image/image_writer.h>
+#include <pangolin/utils/thread_pool.h>
+#include <pangolin/utils/file_extension.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace pangolin
+{
+
+// Distinguishes temporary files of concurrent saves, across all writers
+boostd::mutex temp_mutex;
+size_t temp_count = 0;
+
+std::string TempFilename(const std::string& filename)
+{
+    boostd::unique_lock<boostd::mutex> lock(temp_mutex);
+    std::ostringstream ss;
+    ss << filename << "." << temp_count++ << ".tmp";
+    return ss.str();
+}
+
+// Owns image buffer until written on a worker thread
+struct ImageWriteJob
+{
+    ImageWriter* writer;
+    Image<unsigned char> image;
+    VideoPixelFormat fmt;
+    std::string filename;
+    std::string temp_filename;
+    bool top_line_first;
+    ImageWriteOptions options;
+    ImageWriter::Callback done;
+
+    void WriteFile(const std::string& path, ImageFileType file_type)
+    {
+        if(file_type == ImageFileTypePng || file_type == ImageFileTypeJpg) {
+            std::ofstream out(path.c_str(), std::ios::out | std::ios::binary);
+            if (!out.is_open()) {
+                throw std::runtime_error( "Could not open file '" + path + "' for writing" );
+            }
+            if(file_type == ImageFileTypePng) {
+                SavePng(image, fmt, out, top_line_first, options.png_compression_level, options.png_filters);
+            }else{
+                SaveJpg(image, fmt, out, options.jpeg_quality, top_line_first);
+            }
+            out.close();
+            if(out.fail()) {
+                throw std::runtime_error( "Could not write file '" + path + "'" );
+            }
+        }else{
+            SaveImage(image, fmt, path, file_type, top_line_first);
+        }
+    }
+
+    // Write to a temporary file and move it into place, so that readers and
+    // concurrent saves to the same filename never see a partial image.
+    void Write()
+    {
+        const ImageFileType file_type = FileTypeExtension(FileLowercaseExtention(filename));
+        if(file_type != ImageFileTypePng && file_type != ImageFileTypeJpg && file_type != ImageFileTypePpm &&
+           file_type != ImageFileTypeExr && file_type != ImageFileTypeTiff) {
+            throw std::runtime_error("Unsupported image file type, '" + filename + "'");
+        }
+
+        try {
+            WriteFile(temp_filename, file_type);
+        }catch(...) {
+            std::remove(temp_filename.c_str());
+            throw;
+        }
+
+#ifdef _WIN_
+        // rename won't replace an existing file on Windows
+        std::remove(filename.c_str());
+#endif
+        if(std::rename(temp_filename.c_str(), filename.c_str()) != 0) {
+            std::remove(temp_filename.c_str());
+            throw std::runtime_error( "Could not move image into place at '" + filename + "'" );
+        }
+    }
+
+    void operator()()
+    {
+        std::string error;
+        try {
+            Write();
+        }catch(const std::exception& e) {
+            error = e.what();
+        }
+        image.Dealloc();
+
+        if(done) {
+            try {
+                done(filename, error);
+            }catch(const std::exception& e) {
+                pango_print_error("ImageWriter: completion callback threw: %s\n", e.what());
+            }
+        }else if(!error.empty()) {
+            pango_print_error("Unable to save image '%s': %s\n", filename.c_str(), error.c_str());
+        }
+
+        writer->Finished();
+    }
+};
+
+ImageWriter::ImageWriter(size_t max_pending, const ImageWriteOptions& options)
+    : options(options), max_pending(std::max(max_pending, (size_t)1)), pending(0)
+{
+    // Make sure pool outlives any default writer
+    DefaultThreadPool();
+}
+
+ImageWriter::~ImageWriter()
+{
+    Wait();
+}
+
+void ImageWriter::SetOptions(const ImageWriteOptions& options)
+{
+    boostd::unique_lock<boostd::mutex> lock(pending_mutex);
+    this->options = options;
+}
+
+ImageWriteOptions ImageWriter::Options() const
+{
+    boostd::unique_lock<boostd::mutex> lock(pending_mutex);
+    return options;
+}
+
+void ImageWriter::Save(Image<unsigned char>& image, const VideoPixelFormat& fmt, const std::string& filename, bool top_line_first, const Callback& done)
+{
+    ImageWriteJob job;
+    job.writer = this;
+    job.image = image;
+    job.fmt = fmt;
+    job.filename = filename;
+    job.temp_filename = TempFilename(filename);
+    job.top_line_first = top_line_first;
+    job.done = done;
+    image.ptr = 0;
+
+    {
+        boostd::unique_lock<boostd::mutex> lock(pending_mutex);
+        while(pending >= max_pending) {
+            cond_finished.wait(lock);
+        }
+        ++pending;
+        job.options = options;
+    }
+
+    DefaultThreadPool().Enqueue(job);
+}
+
+void ImageWriter::Save(TypedImage& image, const std::string& filename, bool top_line_first, const Callback& done)
+{
+    Save(image, image.fmt, filename, top_line_first, done);
+}
+
+size_t ImageWriter::NumPending() const
+{
+    boostd::unique_lock<boostd::mutex> lock(pending_mutex);
+    return pending;
+}
+
+void ImageWriter::Wait()
+{
+    boostd::unique_lock<boostd::mutex> lock(pending_mutex);
+    while(pending > 0) {
+        cond_finished.wait(lock);
+    }
+}
+
+void ImageWriter::Finished()
+{
+    {
+        boostd::unique_lock<boostd::mutex> lock(pending_mutex);
+        --pending;
+    }
+    cond_finished.notify_all();
+}
+
+ImageWriter& DefaultImageWriter()
+{
+    // Constructed after DefaultThreadPool, so destroyed (and waited on) first
+    static ImageWriter writer;
+    return writer;
+}
+
+}
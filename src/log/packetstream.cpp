@@ -30,9 +30,13 @@
 #include <pangolin/compat/thread.h>
 #include <pangolin/utils/file_utils.h>
 
+#include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <string>
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 
 namespace pangolin
@@ -87,13 +91,18 @@ void WaitUntilPlaybackTime_us(int64_t time_us)
 // PacketStreamWriter
 //////////////////////////////////////////////////////////////////////////
 
+// Number of staged packet buffers kept for reuse
+const size_t max_free_packets = 16;
+
 PacketStreamWriter::PacketStreamWriter()
-    : writer(&buffer), bytes_written(0)
+    : writer(&buffer), bytes_written(0), next_sequence(0),
+      newest_time_us(std::numeric_limits<int64_t>::min()), reorder_window_us(0)
 {
 }
 
 PacketStreamWriter::PacketStreamWriter(const std::string& filename, unsigned int buffer_size_bytes )
-    : buffer(pangolin::PathExpand(filename), buffer_size_bytes), writer(&buffer), bytes_written(0)
+    : buffer(pangolin::PathExpand(filename), buffer_size_bytes), writer(&buffer), bytes_written(0),
+      next_sequence(0), newest_time_us(std::numeric_limits<int64_t>::min()), reorder_window_us(0)
 {
     // Start of file magic
     writer.write(PANGO_MAGIC.c_str(), PANGO_MAGIC.size());
@@ -114,7 +123,17 @@ void PacketStreamWriter::Open(const std::string& filename, unsigned int buffer_s
 
 PacketStreamWriter::~PacketStreamWriter()
 {
+    try {
+        Flush();
+    }catch(const std::exception& e) {
+        pango_print_error("PacketStreamWriter: %s\n", e.what());
+    }
+
     WriteStats();
+
+    for(size_t i=0; i < free_packets.size(); ++i) {
+        delete free_packets[i];
+    }
 }
 
 PacketStreamSourceId PacketStreamWriter::AddSource(
@@ -122,8 +141,17 @@ PacketStreamSourceId PacketStreamWriter::AddSource(
     const std::string& source_uri,
     const json::value& source_info,
     const size_t       packet_size_bytes,
-    const std::string& packet_definitions
+    const std::string& packet_definitions,
+    const size_t       packet_alignment_bytes
 ) {
+    if(packet_alignment_bytes == 0) {
+        throw std::runtime_error("Packet alignment must be at least 1 byte.");
+    }
+
+    // Sources are only added while holding both locks
+    boostd::unique_lock<boostd::mutex> write_lock(write_mutex);
+    boostd::unique_lock<boostd::mutex> queue_lock(queue_mutex);
+
     PacketStreamSource pss;
 
     pss.driver = source_driver;
@@ -133,7 +161,7 @@ PacketStreamSourceId PacketStreamWriter::AddSource(
     pss.data_size_bytes = packet_size_bytes;
     pss.data_definitions = packet_definitions;
     pss.version = 1;
-    pss.data_alignment_bytes = 1;
+    pss.data_alignment_bytes = packet_alignment_bytes;
 
     json::value json_src;
     json_src[json_src_driver] = pss.driver;
@@ -156,32 +184,258 @@ PacketStreamSourceId PacketStreamWriter::AddSource(
 
 void PacketStreamWriter::WriteSourcePacketMeta(PacketStreamSourceId src, const json::value& json)
 {
-    WriteTag(TAG_SRC_JSON);
-    WriteCompressedUnsignedInt(src);
-    json.serialize(std::ostream_iterator<char>(writer), false);
+    StagedPacket* packet = StagePacket(PlaybackTime_us());
+    AppendTag(packet->bytes, TAG_SRC_JSON);
+    AppendCompressedUnsignedInt(packet->bytes, src);
+    packet->prefix_bytes = packet->bytes.size();
+    packet->alignment_bytes = 1;
+    packet->payload_bytes = 0;
+    json.serialize(std::back_inserter(packet->bytes), false);
+    CommitPacket(packet);
 }
 
 void PacketStreamWriter::WriteSourcePacket(PacketStreamSourceId src, const char* data, size_t n)
 {
-    // Write SOURCE_PACKET tag and source id
-    WriteTag(TAG_SRC_PACKET);
-    WriteTimestamp();
-    WriteCompressedUnsignedInt(src);
+    WriteSourcePacket(src, 0, 0, data, n);
+}
 
-    // Write packet size if dynamic so it can be skipped over easily
-    size_t packet_size = sources[src].data_size_bytes;
-    if(packet_size == 0) {
-        WriteCompressedUnsignedInt(n);
-    }else if(packet_size != n) {
+void PacketStreamWriter::WriteSourcePacket(PacketStreamSourceId src, const char* header, size_t header_n, const char* data, size_t n)
+{
+    const int64_t time_us = PlaybackTime_us();
+
+    size_t packet_size;
+    size_t alignment_bytes;
+    {
+        boostd::unique_lock<boostd::mutex> lock(queue_mutex);
+        if(src >= sources.size()) {
+            throw std::runtime_error("Attempting to write packet for unknown source");
+        }
+        packet_size = sources[src].data_size_bytes;
+        alignment_bytes = sources[src].data_alignment_bytes;
+    }
+
+    const size_t total_n = header_n + n;
+    if(packet_size != 0 && packet_size != total_n) {
         throw std::runtime_error("Attempting to write packet of wrong size");
     }
 
-    // Write data
-    writer.write(data, n);
+    if(WriteSourcePacketDirect(src, time_us, packet_size, alignment_bytes, header, header_n, data, n)) {
+        return;
+    }
+
+    StagedPacket* packet = StagePacket(time_us);
+
+    // SOURCE_PACKET tag, timestamp and source id
+    AppendTag(packet->bytes, TAG_SRC_PACKET);
+    packet->bytes.insert(packet->bytes.end(), (const char*)&time_us, (const char*)&time_us + sizeof(int64_t));
+    AppendCompressedUnsignedInt(packet->bytes, src);
+
+    // Packet size if dynamic so it can be skipped over easily
+    if(packet_size == 0) {
+        AppendCompressedUnsignedInt(packet->bytes, total_n);
+    }
+    packet->prefix_bytes = packet->bytes.size();
+    packet->alignment_bytes = alignment_bytes;
+    packet->payload_bytes = total_n;
+
+    // Copy payload outside of any lock
+    packet->bytes.resize(packet->prefix_bytes + total_n);
+    if(header_n) {
+        memcpy(&packet->bytes[packet->prefix_bytes], header, header_n);
+    }
+    if(n) {
+        memcpy(&packet->bytes[packet->prefix_bytes + header_n], data, n);
+    }
+
+    CommitPacket(packet);
+}
+
+bool PacketStreamWriter::WriteSourcePacketDirect(PacketStreamSourceId src, int64_t time_us, size_t packet_size, size_t alignment_bytes, const char* header, size_t header_n, const char* data, size_t n)
+{
+    // Only without a reorder window, and if no other thread is writing
+    if(!write_mutex.try_lock()) {
+        return false;
+    }
+
+    bool direct;
+    {
+        boostd::unique_lock<boostd::mutex> lock(queue_mutex);
+        direct = reorder_window_us == 0 && pending.empty();
+        if(direct) {
+            newest_time_us = std::max(newest_time_us, time_us);
+        }
+    }
+
+    if(direct) {
+        try {
+            // Prefix scratch is guarded by write_mutex
+            direct_prefix.clear();
+            AppendTag(direct_prefix, TAG_SRC_PACKET);
+            direct_prefix.insert(direct_prefix.end(), (const char*)&time_us, (const char*)&time_us + sizeof(int64_t));
+            AppendCompressedUnsignedInt(direct_prefix, src);
+            if(packet_size == 0) {
+                AppendCompressedUnsignedInt(direct_prefix, header_n + n);
+            }
+
+            writer.write(&direct_prefix[0], direct_prefix.size());
+            WritePadding(alignment_bytes);
+            if(header_n) writer.write(header, header_n);
+            if(n) writer.write(data, n);
+            if(writer.bad()) {
+                throw std::runtime_error("Error writing data.");
+            }
+            bytes_written += header_n + n;
+        }catch(...) {
+            write_mutex.unlock();
+            throw;
+        }
+    }
+    write_mutex.unlock();
+
+    if(direct) {
+        // Packets committed whilst we held the lock are left to us
+        bool more;
+        {
+            boostd::unique_lock<boostd::mutex> lock(queue_mutex);
+            more = !pending.empty();
+        }
+        if(more) {
+            WritePending(false);
+        }
+    }
+    return direct;
+}
+
+void PacketStreamWriter::SetReorderWindow_us(int64_t window_us)
+{
+    {
+        boostd::unique_lock<boostd::mutex> lock(queue_mutex);
+        reorder_window_us = std::max(window_us, (int64_t)0);
+    }
+    WritePending(false);
+}
+
+void PacketStreamWriter::Flush()
+{
+    WritePending(true);
+}
+
+PacketStreamWriter::StagedPacket* PacketStreamWriter::StagePacket(int64_t time_us)
+{
+    StagedPacket* packet = 0;
+    {
+        boostd::unique_lock<boostd::mutex> lock(queue_mutex);
+        if(!free_packets.empty()) {
+            packet = free_packets.back();
+            free_packets.pop_back();
+        }
+    }
+
+    if(!packet) {
+        packet = new StagedPacket();
+    }
+
+    packet->time_us = time_us;
+    packet->bytes.clear();
+    return packet;
+}
+
+void PacketStreamWriter::CommitPacket(StagedPacket* packet)
+{
+    {
+        boostd::unique_lock<boostd::mutex> lock(queue_mutex);
+        packet->sequence = next_sequence++;
+        newest_time_us = std::max(newest_time_us, packet->time_us);
+        pending.push(packet);
+    }
+    WritePending(false);
+}
+
+void PacketStreamWriter::RecyclePacket(StagedPacket* packet)
+{
+    {
+        boostd::unique_lock<boostd::mutex> lock(queue_mutex);
+        if(free_packets.size() < max_free_packets) {
+            free_packets.push_back(packet);
+            return;
+        }
+    }
+    delete packet;
+}
+
+void PacketStreamWriter::WritePending(bool all)
+{
+    while(true) {
+        // Whichever thread holds the write lock writes all ready packets,
+        // so others needn't wait for it.
+        if(all) {
+            write_mutex.lock();
+        }else if(!write_mutex.try_lock()) {
+            return;
+        }
+
+        try {
+            while(true) {
+                StagedPacket* packet = 0;
+                {
+                    boostd::unique_lock<boostd::mutex> lock(queue_mutex);
+                    if(!pending.empty() && (all || pending.top()->time_us + reorder_window_us <= newest_time_us)) {
+                        packet = pending.top();
+                        pending.pop();
+                    }
+                }
+                if(!packet) break;
+
+                try {
+                    WriteStaged(*packet);
+                }catch(...) {
+                    RecyclePacket(packet);
+                    throw;
+                }
+                RecyclePacket(packet);
+            }
+        }catch(...) {
+            write_mutex.unlock();
+            throw;
+        }
+        write_mutex.unlock();
+
+        // Packets committed as we released the lock are left to us
+        boostd::unique_lock<boostd::mutex> lock(queue_mutex);
+        if(pending.empty() || (!all && pending.top()->time_us + reorder_window_us > newest_time_us)) {
+            return;
+        }
+    }
+}
+
+void PacketStreamWriter::WriteStaged(const StagedPacket& packet)
+{
+    writer.write(&packet.bytes[0], packet.prefix_bytes);
+    WritePadding(packet.alignment_bytes);
+    if(packet.bytes.size() > packet.prefix_bytes) {
+        writer.write(&packet.bytes[packet.prefix_bytes], packet.bytes.size() - packet.prefix_bytes);
+    }
     if(writer.bad()) {
         throw std::runtime_error("Error writing data.");
     }
-    bytes_written += n;
+    bytes_written += packet.payload_bytes;
+}
+
+void PacketStreamWriter::WritePadding(size_t alignment_bytes)
+{
+    if(alignment_bytes > 1) {
+        const std::streamoff pos = writer.tellp();
+        if(pos < 0) {
+            throw std::runtime_error("Unable to determine position for packet alignment.");
+        }
+        static const char zeros[256] = {0};
+        size_t pad = (alignment_bytes - (size_t)pos % alignment_bytes) % alignment_bytes;
+        while(pad) {
+            const size_t n = std::min(pad, sizeof(zeros));
+            writer.write(zeros, n);
+            pad -= n;
+        }
+    }
 }
 
 const std::string CurrentTimeStr() {
@@ -207,6 +461,7 @@ void PacketStreamWriter::WritePangoHeader()
 
 void PacketStreamWriter::WriteStats()
 {
+    boostd::unique_lock<boostd::mutex> lock(write_mutex);
     WriteTag(TAG_PANGO_STATS);
     json::value stat;
     stat["num_sources"]   = sources.size();
@@ -216,6 +471,7 @@ void PacketStreamWriter::WriteStats()
 
 void PacketStreamWriter::WriteSync()
 {
+    boostd::unique_lock<boostd::mutex> lock(write_mutex);
     for(int i=0; i<10; ++i) {
         WriteTag(TAG_PANGO_SYNC);
     }
@@ -236,12 +492,12 @@ std::string TagName(int v)
 }
 
 PacketStreamReader::PacketStreamReader()
-    : next_tag(0), packets(0)
+    : next_tag(0), packets(0), packet_size_bytes(0), locked_src_id(0)
 {
 }
 
 PacketStreamReader::PacketStreamReader(const std::string& filename, bool realtime)
-    : next_tag(0), packets(0)
+    : next_tag(0), packets(0), packet_size_bytes(0), locked_src_id(0)
 {
     Open(filename, realtime);
 }
@@ -313,6 +569,11 @@ bool PacketStreamReader::ReadToSourcePacketAndLock(PacketStreamSourceId src_id)
         ProcessMessagesUntilSourcePacket(nxt_src_id, time_us);
     }
 
+    locked_src_id = src_id;
+    const PacketStreamSource& src = sources[src_id];
+    packet_size_bytes = src.data_size_bytes > 0 ? (size_t)src.data_size_bytes : ReadCompressedUnsignedInt();
+    ReadOverPadding(src);
+
     // Sync time to start of stream if there are no other playback devices
     if(packets == 0 && playback_devices == 1) {
         SetCurrentPlaybackTime_us(time_us);
@@ -357,6 +618,7 @@ void PacketStreamReader::ProcessMessage()
     }
     case TAG_SRC_PACKET:
     {
+        ReadTimestamp();
         const size_t src_id = ReadCompressedUnsignedInt();
         if(src_id >= sources.size()) {
             throw std::runtime_error("Invalid Packet Source ID.");
@@ -487,12 +749,24 @@ void PacketStreamReader::ReadOverSourcePacket(PacketStreamSourceId src_id)
     const PacketStreamSource& src = sources[src_id];
 
     if(src.data_size_bytes > 0) {
+        ReadOverPadding(src);
         reader.ignore(src.data_size_bytes);
     }else{
         size_t size_bytes = ReadCompressedUnsignedInt();
+        ReadOverPadding(src);
         reader.ignore(size_bytes);
     }
 }
 
+void PacketStreamReader::ReadOverPadding(const PacketStreamSource& src)
+{
+    // Logs written without alignment use 1, needing no padding
+    if(src.data_alignment_bytes > 1) {
+        const std::streamoff pos = reader.tellg();
+        const size_t alignment = (size_t)src.data_alignment_bytes;
+        reader.ignore((alignment - (size_t)pos % alignment) % alignment);
+    }
+}
+
 
 }
@@ -75,7 +75,7 @@ ImageFileType FileTypeMagic(const unsigned char data[], size_t bytes)
             return ImageFileTypeExr;
         }else if( !strncmp((char*)data, (char*)magic_pango,5) ) {
             return ImageFileTypePango;
-        }else if( data[0] == 'P' && '0' < data[1] && data[1] < '9') {
+        }else if( data[0] == 'P' && (('0' < data[1] && data[1] < '9') || data[1] == 'f' || data[1] == 'F') ) {
             return ImageFileTypePpm;
         }
     }
@@ -96,7 +96,7 @@ ImageFileType FileTypeExtension(const std::string& ext)
         return ImageFileTypeTiff;
     } else if( ext == ".exr"  ) {
         return ImageFileTypeExr;
-    } else if( ext == ".ppm" || ext == ".pgm" || ext == ".pbm" || ext == ".pxm" || ext == ".pdm" ) {
+    } else if( ext == ".ppm" || ext == ".pgm" || ext == ".pbm" || ext == ".pxm" || ext == ".pdm" || ext == ".pfm" ) {
         return ImageFileTypePpm;
     } else if( ext == ".pvn"  ) {
         return ImageFileTypePvn;
@@ -0,0 +1,205 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <pangolin/utils/thread_pool.h>
+#include <pangolin/compat/bind.h>
+#include <pangolin/compat/memory.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+
+namespace pangolin
+{
+
+ThreadPool::ThreadPool(size_t num_threads)
+    : active(0), should_run(true)
+{
+    if(num_threads == 0) {
+        num_threads = std::max(boostd::thread::hardware_concurrency(), 1u);
+    }
+
+    for(size_t i=0; i < num_threads; ++i) {
+        threads.push_back(new boostd::thread(boostd::ref(*this)));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        boostd::unique_lock<boostd::mutex> lock(tasks_mutex);
+        should_run = false;
+    }
+    cond_queued.notify_all();
+
+    for(size_t i=0; i < threads.size(); ++i) {
+        threads[i]->join();
+        delete threads[i];
+    }
+}
+
+size_t ThreadPool::NumThreads() const
+{
+    return threads.size();
+}
+
+void ThreadPool::Enqueue(const Task& task)
+{
+    {
+        boostd::unique_lock<boostd::mutex> lock(tasks_mutex);
+        tasks.push_back(task);
+    }
+    cond_queued.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+    boostd::unique_lock<boostd::mutex> lock(tasks_mutex);
+    while(!tasks.empty() || active > 0) {
+        cond_done.wait(lock);
+    }
+}
+
+void ThreadPool::operator()()
+{
+    while(true) {
+        Task task;
+        {
+            boostd::unique_lock<boostd::mutex> lock(tasks_mutex);
+            while(tasks.empty() && should_run) {
+                cond_queued.wait(lock);
+            }
+            // Finish remaining tasks before exiting
+            if(tasks.empty()) {
+                return;
+            }
+            task = tasks.front();
+            tasks.pop_front();
+            ++active;
+        }
+
+        try {
+            task();
+        }catch(const std::exception& e) {
+            std::cerr << "ThreadPool: task threw exception: " << e.what() << std::endl;
+        }
+
+        {
+            boostd::unique_lock<boostd::mutex> lock(tasks_mutex);
+            --active;
+        }
+        cond_done.notify_all();
+    }
+}
+
+// Shared between caller and helper tasks of ParallelFor. Helpers which
+// only start once all indices have been taken do nothing, so the caller
+// never waits on tasks still sat in the queue.
+struct ParallelForJob
+{
+    ParallelForJob(size_t n, const boostd::function<void(size_t)>& f)
+        : f(f), n(n), next(0), in_flight(0)
+    {
+    }
+
+    void Run()
+    {
+        while(true) {
+            size_t i;
+            {
+                boostd::unique_lock<boostd::mutex> lock(mutex);
+                if(next >= n) return;
+                i = next++;
+                ++in_flight;
+            }
+
+            std::string err;
+            try {
+                f(i);
+            }catch(const std::exception& e) {
+                err = e.what();
+            }
+
+            {
+                boostd::unique_lock<boostd::mutex> lock(mutex);
+                if(!err.empty() && error.empty()) {
+                    error = err;
+                }
+                --in_flight;
+                if(in_flight == 0 && next >= n) {
+                    cond_done.notify_all();
+                }
+            }
+        }
+    }
+
+    void WaitForCompletion()
+    {
+        boostd::unique_lock<boostd::mutex> lock(mutex);
+        while(in_flight > 0 || next < n) {
+            cond_done.wait(lock);
+        }
+    }
+
+    boostd::function<void(size_t)> f;
+    size_t n;
+    size_t next;
+    size_t in_flight;
+    std::string error;
+    boostd::mutex mutex;
+    boostd::condition_variable cond_done;
+};
+
+void ThreadPool::ParallelFor(size_t n, const boostd::function<void(size_t)>& f)
+{
+    if(n == 0) {
+        return;
+    }
+
+    boostd::shared_ptr<ParallelForJob> job(new ParallelForJob(n, f));
+
+    const size_t helpers = std::min(n-1, threads.size());
+    for(size_t i=0; i < helpers; ++i) {
+        Enqueue(boostd::bind(&ParallelForJob::Run, job));
+    }
+
+    job->Run();
+    job->WaitForCompletion();
+
+    if(!job->error.empty()) {
+        throw std::runtime_error(job->error);
+    }
+}
+
+ThreadPool& DefaultThreadPool()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+}
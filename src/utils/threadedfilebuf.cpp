@@ -36,12 +36,12 @@ namespace pangolin
 {
 
 threadedfilebuf::threadedfilebuf()
-    : mem_buffer(0), mem_size(0), mem_max_size(0), mem_start(0), mem_end(0), should_run(false)
+    : mem_buffer(0), mem_size(0), mem_max_size(0), mem_start(0), mem_end(0), input_pos(0), should_run(false)
 {
 }
 
 threadedfilebuf::threadedfilebuf( const std::string& filename, unsigned int buffer_size_bytes )
-    : mem_buffer(0), mem_size(0), mem_max_size(0), mem_start(0), mem_end(0), should_run(false)
+    : mem_buffer(0), mem_size(0), mem_max_size(0), mem_start(0), mem_end(0), input_pos(0), should_run(false)
 {
     open(filename, buffer_size_bytes);
 }
@@ -61,6 +61,7 @@ void threadedfilebuf::open(const std::string& filename, unsigned int buffer_size
     mem_size = 0;
     mem_start = 0;
     mem_end = 0;
+    input_pos = 0;
     mem_max_size = buffer_size_bytes;
     mem_buffer = new char[(size_t)mem_max_size];
 
@@ -129,6 +130,8 @@ std::streamsize threadedfilebuf::xsputn(const char* data, std::streamsize num_by
         
         if(mem_end == mem_max_size)
             mem_end = 0;
+
+        input_pos += num_bytes;
     }
     
     cond_queued.notify_one();
@@ -155,6 +158,8 @@ int threadedfilebuf::overflow(int c)
 
         if(mem_end == mem_max_size)
             mem_end = 0;
+
+        input_pos += num_bytes;
     }
 
     cond_queued.notify_one();
@@ -162,6 +167,15 @@ int threadedfilebuf::overflow(int c)
     return num_bytes;
 }
 
+std::streampos threadedfilebuf::seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode which)
+{
+    if(off == 0 && way == ios_base::cur && (which & ios_base::out)) {
+        // Data is only ever appended, so current position is bytes queued
+        return input_pos;
+    }
+    return std::streampos(std::streamoff(-1));
+}
+
 void threadedfilebuf::operator()()
 {
     std::streamsize data_to_write = 0;
@@ -26,6 +26,7 @@
  */
 
 #include <pangolin/video/drivers/debayer.h>
+#include "driver_kernels.h"
 
 #ifdef HAVE_DC1394
 #include <dc1394/conversions.h>
@@ -125,6 +126,7 @@ bool DebayerVideo::GrabNext( unsigned char* image, bool wait )
             DownsampleDebayer(img_out, img_in);
 #endif
         }
+        UpdateFrameInfoFromSource(frame_info, videoin[0]);
         return true;
     }else{
         return false;
@@ -142,5 +144,11 @@ std::vector<VideoInterface*>& DebayerVideo::InputStreams()
     return videoin;
 }
 
+//! Implement VideoFrameInfoInterface::FrameInfo()
+const VideoFrameInfo& DebayerVideo::FrameInfo() const
+{
+    return frame_info;
+}
+
 
 }
@@ -596,6 +596,7 @@ bool DepthSenseVideo::GrabNext( unsigned char* image, bool wait )
             gotColor = 0;
         }
         fill_image = 0;
+        frame_info.Arrived( (int64_t)(enableDepth ? depthTs : colorTs) );
     }
 
     //printf("Delta time: %.1f\n", fabs(GetDeltaTime()));
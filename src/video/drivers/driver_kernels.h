@@ -0,0 +1,51 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef PANGOLIN_VIDEO_DRIVER_KERNELS_H
+#define PANGOLIN_VIDEO_DRIVER_KERNELS_H
+
+// Kernels of the debayer and shift video filters. Not installed; declared
+// here for the benchmarks.
+
+#include <pangolin/platform.h>
+#include <pangolin/image/image.h>
+
+namespace pangolin
+{
+
+//! Half-resolution BGGR debayer of 8 bit in into packed RGB24 out
+PANGOLIN_EXPORT
+void DownsampleDebayer(Image<unsigned char>& out, const Image<unsigned char>& in);
+
+//! Convert 16 bit in to 8 bit out, masking then shifting right each pixel
+PANGOLIN_EXPORT
+void DoShift16to8(Image<unsigned char>& out, const Image<unsigned char>& in, int shift_right_bits, unsigned int mask);
+
+}
+
+#endif // PANGOLIN_VIDEO_DRIVER_KERNELS_H
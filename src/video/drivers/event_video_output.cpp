@@ -0,0 +1,202 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <pangolin/video/drivers/event_video_output.h>
+#include <pangolin/utils/timer.h>
+
+#include <algorithm>
+#include <string.h>
+
+namespace pangolin
+{
+
+EventVideoOutput::EventVideoOutput(const Uri& output_uri, double preroll_s, double postroll_s, bool detect_motion, const MotionDetector& detector)
+    : output_uri(output_uri), output(0), frame_size_bytes(0),
+      preroll_us((int64_t)(preroll_s * 1E6)), postroll_us((int64_t)(postroll_s * 1E6)),
+      detect_motion(detect_motion), detector(detector),
+      trigger_pending(false), committing(false), last_activity_us(0),
+      events(0), frames_committed(0), frames_discarded(0)
+{
+    if(preroll_s < 0 || postroll_s < 0) {
+        throw VideoException("event: pre-roll and post-roll must not be negative");
+    }
+}
+
+EventVideoOutput::~EventVideoOutput()
+{
+    delete output;
+    for(size_t i=0; i < ring.size(); ++i) delete ring[i];
+    for(size_t i=0; i < pool.size(); ++i) delete pool[i];
+}
+
+const std::vector<StreamInfo>& EventVideoOutput::Streams() const
+{
+    return streams;
+}
+
+void EventVideoOutput::SetStreams(const std::vector<StreamInfo>& st, const std::string& uri, const json::value& properties)
+{
+    if(!streams.empty()) {
+        throw std::runtime_error("Unable to add new streams");
+    }
+
+    streams = st;
+    input_uri = uri;
+    device_properties = properties;
+
+    frame_size_bytes = 0;
+    for(size_t i=0; i<st.size(); ++i) {
+        frame_size_bytes = std::max(frame_size_bytes, (size_t)st[i].Offset() + st[i].SizeBytes());
+    }
+}
+
+int EventVideoOutput::WriteStreams(unsigned char* data, const json::value& frame_properties)
+{
+    VideoFrameInfo info;
+    info.Arrived();
+    return WriteStreams(data, frame_properties, info);
+}
+
+int EventVideoOutput::WriteStreams(unsigned char* data, const json::value& frame_properties, const VideoFrameInfo& frame_info)
+{
+    if(streams.empty()) {
+        throw VideoException("event: SetStreams must be called before WriteStreams");
+    }
+
+    const int64_t now_us = frame_info.host_time_us ? frame_info.host_time_us : Time_us(TimeNow());
+
+    bool activity;
+    {
+        boostd::unique_lock<boostd::mutex> l(trigger_mutex);
+        activity = trigger_pending;
+        trigger_pending = false;
+    }
+
+    if(detect_motion) {
+        const StreamInfo& si = streams[0];
+        const size_t bytes_per_pixel = std::max(si.PixFormat().bpp / 8, 1u);
+        activity |= detector.Process(si.StreamImage(data), bytes_per_pixel);
+    }
+
+    if(activity) {
+        last_activity_us = now_us;
+        if(!committing) {
+            BeginEvent();
+        }
+    }
+
+    if(committing) {
+        output->WriteStreams(data, frame_properties, frame_info);
+        ++frames_committed;
+        if(now_us - last_activity_us > postroll_us) {
+            committing = false;
+        }
+    }else{
+        Buffer(data, frame_properties, frame_info, now_us);
+    }
+
+    return 0;
+}
+
+void EventVideoOutput::BeginEvent()
+{
+    if(!output) {
+        output = OpenVideoOutput(output_uri);
+        output->SetStreams(streams, input_uri, device_properties);
+    }
+
+    // Flush pre-roll, oldest first
+    while(!ring.empty()) {
+        BufferedFrame* frame = ring.front();
+        ring.pop_front();
+        output->WriteStreams(&frame->data[0], frame->frame_properties, frame->frame_info);
+        ++frames_committed;
+        Recycle(frame);
+    }
+
+    committing = true;
+    ++events;
+}
+
+void EventVideoOutput::Buffer(unsigned char* data, const json::value& frame_properties, const VideoFrameInfo& frame_info, int64_t time_us)
+{
+    BufferedFrame* frame;
+    if(pool.empty()) {
+        frame = new BufferedFrame();
+        frame->data.resize(frame_size_bytes);
+    }else{
+        frame = pool.back();
+        pool.pop_back();
+    }
+
+    memcpy(&frame->data[0], data, frame_size_bytes);
+    frame->frame_properties = frame_properties;
+    frame->frame_info = frame_info;
+    frame->time_us = time_us;
+    ring.push_back(frame);
+
+    // Age out frames beyond pre-roll window
+    while(!ring.empty() && time_us - ring.front()->time_us > preroll_us) {
+        Recycle(ring.front());
+        ring.pop_front();
+        ++frames_discarded;
+    }
+}
+
+void EventVideoOutput::Recycle(BufferedFrame* frame)
+{
+    pool.push_back(frame);
+}
+
+void EventVideoOutput::Trigger()
+{
+    boostd::unique_lock<boostd::mutex> l(trigger_mutex);
+    trigger_pending = true;
+}
+
+bool EventVideoOutput::IsCommitting() const
+{
+    return committing;
+}
+
+size_t EventVideoOutput::Events() const
+{
+    return events;
+}
+
+size_t EventVideoOutput::FramesCommitted() const
+{
+    return frames_committed;
+}
+
+size_t EventVideoOutput::FramesDiscarded() const
+{
+    return frames_discarded;
+}
+
+}
@@ -330,6 +330,7 @@ bool FfmpegVideo::GrabNext(unsigned char* image, bool /*wait*/)
         if(gotFrame) {
             sws_scale(img_convert_ctx, pFrame->data, pFrame->linesize, 0, pVidCodecCtx->height, pFrameOut->data, pFrameOut->linesize);
             memcpy(image,pFrameOut->data[0],numBytesOut);
+            frame_info.Arrived();
         }
         
         // Free the packet that was allocated by av_read_frame
@@ -344,6 +345,11 @@ bool FfmpegVideo::GrabNewest(unsigned char *image, bool wait)
     return GrabNext(image,wait);
 }
 
+const VideoFrameInfo& FfmpegVideo::FrameInfo() const
+{
+    return frame_info;
+}
+
 FfmpegConverter::FfmpegConverter(VideoInterface* videoin, const std::string sfmtdst, FfmpegMethod method )
     :videoin(videoin)
 {
@@ -429,6 +435,7 @@ bool FfmpegConverter::GrabNext( unsigned char* image, bool wait )
                     avdst->data, avdst->linesize
                     );
         memcpy(image,avdst->data[0],numbytesdst);
+        UpdateFrameInfoFromSource(frame_info, videoin);
         return true;
     }
     return false;
@@ -444,11 +451,17 @@ bool FfmpegConverter::GrabNewest( unsigned char* image, bool wait )
                     avdst->data, avdst->linesize
                     );
         memcpy(image,avdst->data[0],numbytesdst);
+        UpdateFrameInfoFromSource(frame_info, videoin);
         return true;
     }
     return false;
 }
 
+const VideoFrameInfo& FfmpegConverter::FrameInfo() const
+{
+    return frame_info;
+}
+
 // Based on this example
 // http://cekirdek.pardus.org.tr/~ismail/ffmpeg-docs/output-example_8c-source.html
 static AVStream* CreateStream(AVFormatContext *oc, CodecID codec_id, uint64_t frame_rate, int bit_rate, PixelFormat EncoderFormat, int width, int height)
@@ -521,6 +521,7 @@ bool FirewireVideo::GrabNext( unsigned char* image, bool wait )
     if( frame )
     {
         memcpy(image,frame->image,frame->image_bytes);
+        frame_info.Arrived( (int64_t)frame->timestamp );
         dc1394_capture_enqueue(camera,frame);
         return true;
     }
@@ -551,6 +552,7 @@ bool FirewireVideo::GrabNewest( unsigned char* image, bool wait )
             }
         }
         memcpy(image,f->image,f->image_bytes);
+        frame_info.Arrived( (int64_t)f->timestamp );
         err=dc1394_capture_enqueue(camera,f);
         return true;
     }else if(wait){
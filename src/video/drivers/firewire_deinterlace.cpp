@@ -78,6 +78,7 @@ void FirewireDeinterlace::Stop()
 bool FirewireDeinterlace::GrabNext( unsigned char* image, bool wait )
 {
     if(videoin->GrabNext(buffer, wait)) {
+        UpdateFrameInfoFromSource(frame_info, videoin);
         return ( dc1394_deinterlace_stereo(buffer,image, videoin->Streams()[0].Width(), 2*videoin->Streams()[0].Height() ) == DC1394_SUCCESS );
     }
     return false;
@@ -86,11 +87,15 @@ bool FirewireDeinterlace::GrabNext( unsigned char* image, bool wait )
 bool FirewireDeinterlace::GrabNewest( unsigned char* image, bool wait )
 {
     if(videoin->GrabNewest(buffer, wait)) {
+        UpdateFrameInfoFromSource(frame_info, videoin);
         return ( dc1394_deinterlace_stereo(buffer,image, videoin->Streams()[0].Width(), 2*videoin->Streams()[0].Height() ) == DC1394_SUCCESS );
     }
     return false;
 }
 
-
+const VideoFrameInfo& FirewireDeinterlace::FrameInfo() const
+{
+    return frame_info;
+}
 
 }
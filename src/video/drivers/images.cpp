@@ -33,24 +33,9 @@
 namespace pangolin
 {
 
-bool ImagesVideo::QueueFrame()
-{
-    if(num_loaded < num_files) {
-        Frame frame;
-        for(size_t c=0; c< num_channels; ++c) {
-            const std::string& filename = Filename(num_loaded,c);
-            frame.push_back( LoadImage( filename ) );
-        }
-        loaded.push_back(frame);
-        ++num_loaded;
-        return true;
-    }
-    return false;
-}
-
-ImagesVideo::ImagesVideo(const std::string& wildcard_path)
+ImagesVideo::ImagesVideo(const std::string& wildcard_path, const ImageLoadOptions& load_options)
     : num_files(-1), num_channels(0),
-      num_loaded(0)
+      next_frame(0), load_options(load_options)
 {
     const std::vector<std::string> wildcards = Expand(wildcard_path, '[', ']', ',');
     num_channels = wildcards.size();
@@ -73,18 +58,14 @@ ImagesVideo::ImagesVideo(const std::string& wildcard_path)
         }
     }
     
-    // Load first image in order to determine stream sizes etc
-    QueueFrame();
-    
+    // Read headers of first frame in order to determine stream sizes etc
     size_bytes = 0;
     for(size_t c=0; c < num_channels; ++c) {
-        const TypedImage& img = loaded[0][c];
+        const TypedImage img = ProbeImage( Filename(0,c), load_options );
         const StreamInfo stream_info(img.fmt, img.w, img.h, img.pitch, (unsigned char*)0 + size_bytes);
         streams.push_back(stream_info);        
         size_bytes += img.h*img.pitch;
     }
-    
-    // TODO: Queue frames in another thread.
 }
 
 ImagesVideo::~ImagesVideo()
@@ -119,20 +100,16 @@ const std::vector<StreamInfo>& ImagesVideo::Streams() const
 //! Implement VideoInput::GrabNext()
 bool ImagesVideo::GrabNext( unsigned char* image, bool wait )
 {
-    QueueFrame();
-        
-    if(!loaded.size()) return false;
-    
-    Frame frame = loaded.front();
-    loaded.pop_front();
-            
+    if(next_frame >= num_files) return false;
+
+    // Decode each channel directly into the caller's buffer
     for(size_t c=0; c < num_channels; ++c){
-        TypedImage& img = frame[c];
-        if(!img.ptr) return false;
         const StreamInfo& si = streams[c];
-        std::memcpy(image + (size_t)si.Offset(), img.ptr, si.SizeBytes());
-        img.Dealloc();
+        Image<unsigned char> dst = si.StreamImage(image);
+        LoadImage( Filename(next_frame,c), dst, si.PixFormat(), load_options );
     }
+    ++next_frame;
+    frame_info.Arrived();
     return true;
 }
 
@@ -142,4 +119,10 @@ bool ImagesVideo::GrabNewest( unsigned char* image, bool wait )
     return GrabNext(image,wait);
 }
 
+//! Implement VideoFrameInfoInterface::FrameInfo()
+const VideoFrameInfo& ImagesVideo::FrameInfo() const
+{
+    return frame_info;
+}
+
 }
@@ -0,0 +1,192 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <pangolin/video/drivers/images_video_output.h>
+#include <pangolin/utils/file_utils.h>
+#include <pangolin/utils/file_extension.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+namespace pangolin
+{
+
+std::string FormatFrameFilename(const std::string& filename_pattern, size_t frame)
+{
+    std::ostringstream out;
+    bool formatted = false;
+
+    for(size_t i=0; i < filename_pattern.size(); ++i) {
+        const char c = filename_pattern[i];
+        if(c != '%') {
+            out << c;
+        }else if(i+1 < filename_pattern.size() && filename_pattern[i+1] == '%') {
+            out << '%';
+            ++i;
+        }else{
+            // Expect optional zero flag and width, then d, i or u
+            size_t j = i+1;
+            while(j < filename_pattern.size() && std::isdigit((unsigned char)filename_pattern[j])) ++j;
+            const char conversion = j < filename_pattern.size() ? filename_pattern[j] : '\0';
+            if(formatted || (conversion != 'd' && conversion != 'i' && conversion != 'u')) {
+                throw VideoException("files: filename pattern should contain one integer conversion such as %06d", filename_pattern);
+            }
+            const std::string spec = filename_pattern.substr(i+1, j-i-1);
+            const int width = spec.empty() ? 0 : atoi(spec.c_str());
+            out << std::setfill(spec.size() > 1 && spec[0] == '0' ? '0' : ' ') << std::setw(width) << frame;
+            formatted = true;
+            i = j;
+        }
+    }
+
+    if(!formatted) {
+        throw VideoException("files: filename pattern should contain one integer conversion such as %06d", filename_pattern);
+    }
+    return out.str();
+}
+
+// Routes ImageWriter completions back to the output which queued them
+struct ImagesVideoOutputWritten
+{
+    ImagesVideoOutput* output;
+
+    void operator()(const std::string& filename, const std::string& error) const
+    {
+        output->ImageWritten(filename, error);
+    }
+};
+
+// One validated pattern per stream, from [a,b] expansion of filename_pattern
+std::vector<std::string> ExpandFramePatterns(const std::string& filename_pattern)
+{
+    const std::vector<std::string> patterns = Expand(PathExpand(filename_pattern), '[', ']', ',');
+    for(size_t i=0; i < patterns.size(); ++i) {
+        // Validate pattern and extension up front rather than on first frame
+        FormatFrameFilename(patterns[i], 0);
+        if(FileTypeExtension(FileLowercaseExtention(patterns[i])) == ImageFileTypeUnknown) {
+            throw VideoException("files: unrecognised image extension", patterns[i]);
+        }
+    }
+    return patterns;
+}
+
+// The writer counts images, of which each frame has one per pattern
+ImagesVideoOutput::ImagesVideoOutput(const std::string& filename_pattern, size_t first_frame, size_t max_pending, const ImageWriteOptions& options)
+    : patterns(ExpandFramePatterns(filename_pattern)), next_frame(first_frame), error_thrown(false),
+      writer(std::max(max_pending, (size_t)1) * patterns.size(), options)
+{
+}
+
+ImagesVideoOutput::~ImagesVideoOutput()
+{
+    writer.Wait();
+    if(!error.empty() && !error_thrown) {
+        pango_print_error("files: %s\n", error.c_str());
+    }
+}
+
+const std::vector<StreamInfo>& ImagesVideoOutput::Streams() const
+{
+    return streams;
+}
+
+void ImagesVideoOutput::SetStreams(const std::vector<StreamInfo>& st, const std::string& /*uri*/, const json::value& /*device_properties*/)
+{
+    if(st.size() != patterns.size()) {
+        std::ostringstream ss;
+        ss << st.size() << " streams but " << patterns.size() << " filename patterns. Give one per stream, e.g. dir/[left,right]_%06d.png";
+        throw VideoException("files: number of streams and filename patterns differ", ss.str());
+    }
+    streams = st;
+}
+
+int ImagesVideoOutput::WriteStreams(unsigned char* data, const json::value& /*frame_properties*/)
+{
+    if(streams.empty()) {
+        throw VideoException("files: SetStreams must be called before WriteStreams");
+    }
+
+    ThrowIfFailed();
+
+    ImagesVideoOutputWritten done;
+    done.output = this;
+
+    for(size_t s=0; s < streams.size(); ++s) {
+        const StreamInfo& si = streams[s];
+        const Image<unsigned char> src = si.StreamImage(data);
+        const size_t row_bytes = (si.Width() * si.PixFormat().bpp + 7) / 8;
+
+        // Writer takes ownership of a packed copy, since data is only ours during this call
+        Image<unsigned char> img;
+        img.Alloc(si.Width(), si.Height(), row_bytes);
+        for(size_t r=0; r < img.h; ++r) {
+            std::memcpy(img.ptr + r*img.pitch, src.ptr + r*src.pitch, row_bytes);
+        }
+
+        writer.Save(img, si.PixFormat(), FormatFrameFilename(patterns[s], next_frame), true, done);
+    }
+
+    ++next_frame;
+    return 0;
+}
+
+void ImagesVideoOutput::Flush()
+{
+    writer.Wait();
+    ThrowIfFailed();
+}
+
+size_t ImagesVideoOutput::NextFrame() const
+{
+    return next_frame;
+}
+
+void ImagesVideoOutput::ImageWritten(const std::string& filename, const std::string& err)
+{
+    if(!err.empty()) {
+        boostd::unique_lock<boostd::mutex> lock(error_mutex);
+        if(error.empty()) {
+            error = "Unable to save image '" + filename + "': " + err;
+        }
+    }
+}
+
+void ImagesVideoOutput::ThrowIfFailed()
+{
+    boostd::unique_lock<boostd::mutex> lock(error_mutex);
+    if(!error.empty()) {
+        error_thrown = true;
+        throw VideoException("files: writing failed", error);
+    }
+}
+
+}
@@ -80,11 +80,26 @@ bool VideoJoiner::GrabNext( unsigned char* image, bool wait )
 {
     bool grabbed_any = false;
     size_t offset = 0;
+    int64_t device_time_us = -1;
+    int64_t dropped = 0;
+
     for(size_t s=0; s< src.size(); ++s)
     {
         VideoInterface& vid = *src[s];
         grabbed_any |= vid.GrabNext(image+offset,wait);
         offset += vid.SizeBytes();
+
+        VideoFrameInfoInterface* vid_info = dynamic_cast<VideoFrameInfoInterface*>(src[s]);
+        if(vid_info) {
+            const VideoFrameInfo& fi = vid_info->FrameInfo();
+            if(device_time_us < 0) device_time_us = fi.device_time_us;
+            dropped += fi.dropped;
+        }
+    }
+
+    if(grabbed_any) {
+        // Joined frame arrives once its last component has arrived
+        frame_info.Arrived(device_time_us, dropped - frame_info.dropped);
     }
     return grabbed_any;
 }
@@ -99,4 +114,9 @@ std::vector<VideoInterface*>& VideoJoiner::InputStreams()
     return src;
 }
 
+const VideoFrameInfo& VideoJoiner::FrameInfo() const
+{
+    return frame_info;
+}
+
 }
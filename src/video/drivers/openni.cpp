@@ -253,6 +253,7 @@ bool OpenNiVideo::GrabNext( unsigned char* image, bool wait )
             out_img += streams[i].SizeBytes();
         }
         
+        frame_info.Arrived();
         return true;
     }
 }
@@ -575,6 +575,10 @@ bool OpenNiVideo2::GrabNext( unsigned char* image, bool wait )
 
     current_frame_index = video_frame[0].getFrameIndex();
 
+    if(rc == openni::STATUS_OK) {
+        frame_info.Arrived( video_frame[0].isValid() ? (int64_t)video_frame[0].getTimestamp() : -1 );
+    }
+
     return rc == openni::STATUS_OK;
 }
 
@@ -28,14 +28,20 @@
 #include <pangolin/video/drivers/pango_video.h>
 
 #include <pangolin/compat/bind.h>
+#include <pangolin/utils/thread_pool.h>
+
+#include <string.h>
 
 namespace pangolin
 {
 
 const std::string pango_video_type = "raw_video";
 
+// Number of int64 fields of VideoFrameInfo stored before each frame
+const size_t pango_frame_info_fields = 4;
+
 PangoVideo::PangoVideo(const std::string& filename, bool realtime)
-    : reader(filename, realtime), frame_id(-1)
+    : reader(filename, realtime), has_frame_info(false), frame_info_bytes(0), variable_packets(false), frame_id(-1)
 {
     src_id = FindSource();
 
@@ -46,6 +52,9 @@ PangoVideo::PangoVideo(const std::string& filename, bool realtime)
 
 PangoVideo::~PangoVideo()
 {
+    for(size_t i=0; i < codecs.size(); ++i) {
+        delete codecs[i];
+    }
 }
 
 size_t PangoVideo::SizeBytes() const
@@ -71,6 +80,33 @@ void PangoVideo::Stop()
 bool PangoVideo::GrabNext( unsigned char* image, bool /*wait*/ )
 {
     if(reader.ReadToSourcePacketAndLock(src_id)) {
+        if(variable_packets) {
+            try {
+                ReadEncodedPacket(image);
+            }catch(...) {
+                reader.ReleaseSourcePacketLock(src_id);
+                throw;
+            }
+            reader.ReleaseSourcePacketLock(src_id);
+            ++frame_id;
+            return true;
+        }
+
+        if(has_frame_info) {
+            int64_t info[pango_frame_info_fields];
+            reader.Read((char*)info, sizeof(info));
+            frame_info.host_time_us   = info[0];
+            frame_info.device_time_us = info[1];
+            frame_info.sequence       = info[2];
+            frame_info.dropped        = info[3];
+            if(frame_info_bytes > sizeof(info)) {
+                reader.Skip(frame_info_bytes - sizeof(info));
+            }
+        }else{
+            // Older logs don't store frame information
+            frame_info.Arrived();
+        }
+
         // read this frames actual data
         reader.Read((char*)image, size_bytes);
         reader.ReleaseSourcePacketLock(src_id);
@@ -81,6 +117,68 @@ bool PangoVideo::GrabNext( unsigned char* image, bool /*wait*/ )
     }
 }
 
+struct PangoStreamDecoder
+{
+    void operator()(size_t i) const
+    {
+        const StreamInfo& si = (*streams)[i];
+        if((*codecs)[i]) {
+            Image<unsigned char> img = si.StreamImage(image);
+            (*codecs)[i]->Decode(img, stream_data[i], stream_bytes[i]);
+        }else{
+            if(stream_bytes[i] != si.SizeBytes()) {
+                throw VideoException("pango: raw stream has unexpected size");
+            }
+            memcpy(image + (size_t)si.Offset(), stream_data[i], stream_bytes[i]);
+        }
+    }
+
+    const std::vector<StreamInfo>* streams;
+    const std::vector<PangoVideoCodec*>* codecs;
+    std::vector<const unsigned char*> stream_data;
+    std::vector<size_t> stream_bytes;
+    unsigned char* image;
+};
+
+void PangoVideo::ReadEncodedPacket(unsigned char* image)
+{
+    packet.resize(reader.PacketSizeBytes());
+    if(packet.size()) {
+        reader.Read((char*)&packet[0], packet.size());
+    }
+
+    const size_t info_bytes = pango_frame_info_fields*sizeof(int64_t);
+    const size_t header_bytes = info_bytes + streams.size()*sizeof(uint32_t);
+    if(packet.size() < header_bytes) {
+        throw VideoException("pango: truncated frame");
+    }
+
+    int64_t info[pango_frame_info_fields];
+    memcpy(info, &packet[0], info_bytes);
+    frame_info.host_time_us   = info[0];
+    frame_info.device_time_us = info[1];
+    frame_info.sequence       = info[2];
+    frame_info.dropped        = info[3];
+
+    PangoStreamDecoder decoder;
+    decoder.streams = &streams;
+    decoder.codecs = &codecs;
+    decoder.image = image;
+    size_t offset = header_bytes;
+    for(size_t i=0; i < streams.size(); ++i) {
+        uint32_t n;
+        memcpy(&n, &packet[info_bytes + i*sizeof(uint32_t)], sizeof(uint32_t));
+        if(offset + n > packet.size()) {
+            throw VideoException("pango: truncated frame");
+        }
+        decoder.stream_data.push_back(&packet[0] + offset);
+        decoder.stream_bytes.push_back(n);
+        offset += n;
+    }
+
+    DefaultThreadPool().ParallelFor(streams.size(), decoder);
+}
+
 bool PangoVideo::GrabNewest( unsigned char* image, bool wait )
 {
     return GrabNext(image, wait);
@@ -104,6 +202,11 @@ const json::value& PangoVideo::FrameProperties() const
     }
 }
 
+const VideoFrameInfo& PangoVideo::FrameInfo() const
+{
+    return frame_info;
+}
+
 int PangoVideo::GetCurrentFrameId() const
 {
     return frame_id;
@@ -132,6 +235,9 @@ int PangoVideo::FindSource()
                 size_bytes = 0;
 
                 device_properties = src.info["device"];
+                has_frame_info = src.info.contains("frame_info") && src.info["frame_info"].get<bool>();
+                frame_info_bytes = src.info.contains("frame_info_bytes") ?
+                    (size_t)src.info["frame_info_bytes"].get<int64_t>() : pango_frame_info_fields*sizeof(int64_t);
                 const json::value& json_streams = src.info["streams"];
                 const size_t num_streams = json_streams.size();
                 for(size_t i=0; i<num_streams; ++i) {
@@ -148,6 +254,10 @@ int PangoVideo::FindSource()
 
                     size_bytes += si.SizeBytes();
                     streams.push_back(si);
+
+                    const std::string codec = json_stream.contains("codec") ? json_stream["codec"].get<std::string>() : "";
+                    codecs.push_back(CreatePangoVideoCodec(codec, si));
+                    variable_packets |= (codecs.back() != 0);
                 }
 
                 return src_id;
@@ -0,0 +1,572 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <pangolin/video/drivers/pango_video_codec.h>
+#include <pangolin/image/image_io.h>
+#include <pangolin/utils/memstreambuf.h>
+#include <pangolin/utils/thread_pool.h>
+#include <pangolin/compat/bind.h>
+
+#include <iostream>
+#include <algorithm>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#  include <emmintrin.h>
+#  define PANGOLIN_DELTA_SSE2
+#endif
+
+namespace pangolin
+{
+
+//////////////////////////////////////////////////////////////////////////
+// Depth codec
+//
+// Stream encoding:
+//   uint32 band_rows, uint32 num_bands, uint32 band_bytes[num_bands], band data...
+// Band encoding, for each row a sequence of control bytes:
+//   0..16     : block of 16 residuals packed with this many bits each
+//   0x80 | k  : k+1 blocks of zero residuals
+//////////////////////////////////////////////////////////////////////////
+
+const size_t depth_block = 16;
+const unsigned char depth_zero_run = 0x80;
+const size_t depth_max_zero_run = 128;
+
+inline uint16_t ZigZag16(uint16_t d)
+{
+    return (uint16_t)((d << 1) ^ (uint16_t)(-(int16_t)(d >> 15)));
+}
+
+inline uint16_t UnZigZag16(uint16_t z)
+{
+    return (uint16_t)((z >> 1) ^ (uint16_t)(-(int16_t)(z & 1)));
+}
+
+inline unsigned int BitsRequired(uint16_t v)
+{
+    unsigned int bits = 0;
+    while(v) { ++bits; v >>= 1; }
+    return bits;
+}
+
+// Pack 16 values of bits each into exactly 2*bits bytes
+inline void PackBlock(std::vector<unsigned char>& out, const uint16_t* z, unsigned int bits)
+{
+    uint64_t acc = 0;
+    unsigned int acc_bits = 0;
+    for(size_t i=0; i < depth_block; ++i) {
+        acc |= (uint64_t)z[i] << acc_bits;
+        acc_bits += bits;
+        while(acc_bits >= 8) {
+            out.push_back((unsigned char)acc);
+            acc >>= 8;
+            acc_bits -= 8;
+        }
+    }
+}
+
+inline const unsigned char* UnpackBlock(uint16_t* z, const unsigned char* in, unsigned int bits)
+{
+    const uint16_t mask = (uint16_t)((1u << bits) - 1);
+    uint64_t acc = 0;
+    unsigned int acc_bits = 0;
+    for(size_t i=0; i < depth_block; ++i) {
+        while(acc_bits < bits) {
+            acc |= (uint64_t)(*in++) << acc_bits;
+            acc_bits += 8;
+        }
+        z[i] = (uint16_t)(acc & mask);
+        acc >>= bits;
+        acc_bits -= bits;
+    }
+    return in;
+}
+
+void EncodeDepthRows(std::vector<unsigned char>& out, const Image<unsigned char>& img, size_t r0, size_t r1)
+{
+    const size_t w = img.w;
+    const size_t blocks = (w + depth_block - 1) / depth_block;
+    std::vector<uint16_t> z(blocks * depth_block, 0);
+
+    out.clear();
+    for(size_t r=r0; r < r1; ++r) {
+        const uint16_t* row = (const uint16_t*)(img.ptr + r*img.pitch);
+
+        // Residual from left neighbour. Kept as simple array
+        // arithmetic so that the compiler can vectorise it.
+        z[0] = ZigZag16(row[0]);
+        for(size_t x=1; x < w; ++x) {
+            z[x] = ZigZag16((uint16_t)(row[x] - row[x-1]));
+        }
+
+        size_t zero_run = 0;
+        for(size_t b=0; b < blocks; ++b) {
+            const uint16_t* zb = &z[b*depth_block];
+            uint16_t any = 0;
+            for(size_t i=0; i < depth_block; ++i) any |= zb[i];
+
+            if(any == 0) {
+                ++zero_run;
+                if(zero_run == depth_max_zero_run) {
+                    out.push_back(depth_zero_run | (unsigned char)(zero_run-1));
+                    zero_run = 0;
+                }
+                continue;
+            }
+
+            if(zero_run) {
+                out.push_back(depth_zero_run | (unsigned char)(zero_run-1));
+                zero_run = 0;
+            }
+
+            const unsigned int bits = BitsRequired(any);
+            out.push_back((unsigned char)bits);
+            PackBlock(out, zb, bits);
+        }
+        if(zero_run) {
+            out.push_back(depth_zero_run | (unsigned char)(zero_run-1));
+        }
+
+        // Padding of final block must be zero for next row
+        std::fill(z.begin() + w, z.end(), 0);
+    }
+}
+
+void DecodeDepthRows(Image<unsigned char>& img, size_t r0, size_t r1, const unsigned char* data, size_t n)
+{
+    const size_t w = img.w;
+    const size_t blocks = (w + depth_block - 1) / depth_block;
+    std::vector<uint16_t> z(blocks * depth_block);
+    const unsigned char* in = data;
+    const unsigned char* end = data + n;
+
+    for(size_t r=r0; r < r1; ++r) {
+        size_t b = 0;
+        while(b < blocks) {
+            if(in >= end) {
+                throw VideoException("depth codec: truncated data");
+            }
+            const unsigned char ctrl = *in++;
+            if(ctrl & depth_zero_run) {
+                const size_t run = (ctrl & 0x7F) + 1;
+                if(b + run > blocks) {
+                    throw VideoException("depth codec: corrupt data");
+                }
+                std::fill(&z[b*depth_block], &z[0] + (b+run)*depth_block, 0);
+                b += run;
+            }else{
+                const unsigned int bits = ctrl;
+                if(bits > 16 || in + 2*bits > end) {
+                    throw VideoException("depth codec: corrupt data");
+                }
+                in = UnpackBlock(&z[b*depth_block], in, bits);
+                ++b;
+            }
+        }
+
+        uint16_t* row = (uint16_t*)img.RowPtr((int)r);
+        uint16_t v = 0;
+        for(size_t x=0; x < w; ++x) {
+            v = (uint16_t)(v + UnZigZag16(z[x]));
+            row[x] = v;
+        }
+    }
+}
+
+inline void PutUint32(std::vector<unsigned char>& out, uint32_t v)
+{
+    const unsigned char* p = (const unsigned char*)&v;
+    out.insert(out.end(), p, p + sizeof(uint32_t));
+}
+
+inline uint32_t GetUint32(const unsigned char* p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(uint32_t));
+    return v;
+}
+
+PangoDepthCodec::PangoDepthCodec(size_t band_rows)
+    : band_rows(std::max(band_rows, (size_t)1))
+{
+}
+
+std::string PangoDepthCodec::Name() const
+{
+    return "depth";
+}
+
+struct DepthBandEncoder
+{
+    void operator()(size_t band) const
+    {
+        const size_t r0 = band * band_rows;
+        EncodeDepthRows((*bands)[band], *img, r0, std::min(r0 + band_rows, img->h));
+    }
+    std::vector<std::vector<unsigned char> >* bands;
+    const Image<unsigned char>* img;
+    size_t band_rows;
+};
+
+struct DepthBandDecoder
+{
+    void operator()(size_t band) const
+    {
+        const size_t r0 = band * band_rows;
+        DecodeDepthRows(*img, r0, std::min(r0 + band_rows, img->h), band_data[band], band_bytes[band]);
+    }
+    std::vector<const unsigned char*> band_data;
+    std::vector<size_t> band_bytes;
+    Image<unsigned char>* img;
+    size_t band_rows;
+};
+
+void PangoDepthCodec::Encode(std::vector<unsigned char>& out, const Image<unsigned char>& img)
+{
+    const size_t num_bands = (img.h + band_rows - 1) / band_rows;
+    std::vector<std::vector<unsigned char> > bands(num_bands);
+
+    DepthBandEncoder encoder;
+    encoder.bands = &bands;
+    encoder.img = &img;
+    encoder.band_rows = band_rows;
+    DefaultThreadPool().ParallelFor(num_bands, encoder);
+
+    PutUint32(out, (uint32_t)band_rows);
+    PutUint32(out, (uint32_t)num_bands);
+    for(size_t i=0; i < num_bands; ++i) {
+        PutUint32(out, (uint32_t)bands[i].size());
+    }
+    for(size_t i=0; i < num_bands; ++i) {
+        out.insert(out.end(), bands[i].begin(), bands[i].end());
+    }
+}
+
+void PangoDepthCodec::Decode(Image<unsigned char>& img, const unsigned char* data, size_t n)
+{
+    if(n < 2*sizeof(uint32_t)) {
+        throw VideoException("depth codec: truncated data");
+    }
+
+    // Band layout is chosen by the encoder
+    const size_t coded_band_rows = GetUint32(data);
+    const size_t num_bands = GetUint32(data + sizeof(uint32_t));
+    const size_t table_bytes = (2 + num_bands) * sizeof(uint32_t);
+    if(coded_band_rows == 0 || num_bands != (img.h + coded_band_rows - 1) / coded_band_rows || n < table_bytes) {
+        throw VideoException("depth codec: band layout doesn't match stream");
+    }
+
+    DepthBandDecoder decoder;
+    decoder.img = &img;
+    decoder.band_rows = coded_band_rows;
+    size_t offset = table_bytes;
+    for(size_t i=0; i < num_bands; ++i) {
+        const size_t bytes = GetUint32(data + (2+i)*sizeof(uint32_t));
+        if(offset + bytes > n) {
+            throw VideoException("depth codec: truncated data");
+        }
+        decoder.band_data.push_back(data + offset);
+        decoder.band_bytes.push_back(bytes);
+        offset += bytes;
+    }
+
+    DefaultThreadPool().ParallelFor(num_bands, decoder);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Delta codec
+//
+// Stream encoding:
+//   uint32 type (0 keyframe, 1 delta), uint32 tile_bytes, uint32 tile_rows
+// Keyframe: packed rows of the image.
+// Delta: bitmask of changed tiles in raster order (1 bit each, LSB first),
+//   then for each changed tile its rows XOR'd with the previous frame.
+//////////////////////////////////////////////////////////////////////////
+
+const uint32_t delta_keyframe = 0;
+const uint32_t delta_frame = 1;
+const size_t delta_header_bytes = 3*sizeof(uint32_t);
+
+// dst[i] = a[i] ^ b[i]
+inline void XorBytes(unsigned char* dst, const unsigned char* a, const unsigned char* b, size_t n)
+{
+    size_t i = 0;
+#ifdef PANGOLIN_DELTA_SSE2
+    for(; i + 16 <= n; i += 16) {
+        const __m128i va = _mm_loadu_si128((const __m128i*)(a+i));
+        const __m128i vb = _mm_loadu_si128((const __m128i*)(b+i));
+        _mm_storeu_si128((__m128i*)(dst+i), _mm_xor_si128(va, vb));
+    }
+#endif
+    for(; i < n; ++i) {
+        dst[i] = a[i] ^ b[i];
+    }
+}
+
+PangoDeltaCodec::PangoDeltaCodec(const VideoPixelFormat& fmt, size_t keyframe_interval, size_t tile_pixels)
+    : fmt(fmt), keyframe_interval(keyframe_interval),
+      tile_pixels(std::max(tile_pixels, (size_t)1)), frames_since_keyframe(0),
+      has_previous(false)
+{
+}
+
+std::string PangoDeltaCodec::Name() const
+{
+    return "delta";
+}
+
+bool PangoDeltaCodec::InterFrame() const
+{
+    return true;
+}
+
+void PangoDeltaCodec::Encode(std::vector<unsigned char>& out, const Image<unsigned char>& img)
+{
+    const size_t row_bytes = img.w * fmt.bpp / 8;
+    const size_t tile_bytes = std::max(tile_pixels * fmt.bpp / 8, (size_t)1);
+    const size_t tile_rows = tile_pixels;
+    const size_t tiles_x = (row_bytes + tile_bytes - 1) / tile_bytes;
+    const size_t tiles_y = (img.h + tile_rows - 1) / tile_rows;
+
+    const bool keyframe = !has_previous || previous.size() != row_bytes*img.h ||
+            (keyframe_interval > 0 && frames_since_keyframe + 1 >= keyframe_interval);
+
+    PutUint32(out, keyframe ? delta_keyframe : delta_frame);
+    PutUint32(out, (uint32_t)tile_bytes);
+    PutUint32(out, (uint32_t)tile_rows);
+
+    if(keyframe) {
+        previous.resize(row_bytes*img.h);
+        for(size_t r=0; r < img.h; ++r) {
+            memcpy(&previous[r*row_bytes], img.ptr + r*img.pitch, row_bytes);
+        }
+        out.insert(out.end(), previous.begin(), previous.end());
+        has_previous = true;
+        frames_since_keyframe = 0;
+        return;
+    }
+
+    const size_t mask_offset = out.size();
+    out.resize(mask_offset + (tiles_x*tiles_y + 7) / 8, 0);
+
+    std::vector<bool> changed(tiles_x);
+    for(size_t ty=0; ty < tiles_y; ++ty) {
+        const size_t r0 = ty*tile_rows;
+        const size_t r1 = std::min(r0 + tile_rows, img.h);
+
+        // Find changed tiles in this band of rows
+        std::fill(changed.begin(), changed.end(), false);
+        for(size_t r=r0; r < r1; ++r) {
+            const unsigned char* cur = img.ptr + r*img.pitch;
+            const unsigned char* prev = &previous[r*row_bytes];
+            for(size_t tx=0; tx < tiles_x; ++tx) {
+                if(!changed[tx]) {
+                    const size_t x0 = tx*tile_bytes;
+                    const size_t n = std::min(tile_bytes, row_bytes - x0);
+                    changed[tx] = memcmp(cur + x0, prev + x0, n) != 0;
+                }
+            }
+        }
+
+        // Emit residual of changed tiles and update reference
+        for(size_t tx=0; tx < tiles_x; ++tx) {
+            if(!changed[tx]) continue;
+            const size_t t = ty*tiles_x + tx;
+            out[mask_offset + t/8] |= (unsigned char)(1 << (t%8));
+
+            const size_t x0 = tx*tile_bytes;
+            const size_t n = std::min(tile_bytes, row_bytes - x0);
+            for(size_t r=r0; r < r1; ++r) {
+                const unsigned char* cur = img.ptr + r*img.pitch + x0;
+                unsigned char* prev = &previous[r*row_bytes + x0];
+                const size_t o = out.size();
+                out.resize(o + n);
+                XorBytes(&out[o], cur, prev, n);
+                memcpy(prev, cur, n);
+            }
+        }
+    }
+
+    ++frames_since_keyframe;
+}
+
+void PangoDeltaCodec::Decode(Image<unsigned char>& img, const unsigned char* data, size_t n)
+{
+    if(n < delta_header_bytes) {
+        throw VideoException("delta codec: truncated data");
+    }
+
+    const uint32_t type = GetUint32(data);
+    const size_t tile_bytes = GetUint32(data + sizeof(uint32_t));
+    const size_t tile_rows = GetUint32(data + 2*sizeof(uint32_t));
+    const size_t row_bytes = img.w * fmt.bpp / 8;
+    const unsigned char* in = data + delta_header_bytes;
+    const unsigned char* end = data + n;
+
+    if(type == delta_keyframe) {
+        if((size_t)(end - in) != row_bytes*img.h) {
+            throw VideoException("delta codec: keyframe has unexpected size");
+        }
+        previous.assign(in, end);
+        has_previous = true;
+    }else if(type == delta_frame) {
+        if(!has_previous || previous.size() != row_bytes*img.h) {
+            throw VideoException("delta codec: frame has no preceding keyframe");
+        }
+        if(tile_bytes == 0 || tile_rows == 0) {
+            throw VideoException("delta codec: invalid tile size");
+        }
+        const size_t tiles_x = (row_bytes + tile_bytes - 1) / tile_bytes;
+        const size_t tiles_y = (img.h + tile_rows - 1) / tile_rows;
+        const unsigned char* mask = in;
+        in += (tiles_x*tiles_y + 7) / 8;
+        if(in > end) {
+            throw VideoException("delta codec: truncated data");
+        }
+
+        for(size_t t=0; t < tiles_x*tiles_y; ++t) {
+            if( !(mask[t/8] & (1 << (t%8))) ) continue;
+            const size_t r0 = (t / tiles_x) * tile_rows;
+            const size_t r1 = std::min(r0 + tile_rows, img.h);
+            const size_t x0 = (t % tiles_x) * tile_bytes;
+            const size_t w = std::min(tile_bytes, row_bytes - x0);
+            if((size_t)(end - in) < (r1-r0)*w) {
+                throw VideoException("delta codec: truncated data");
+            }
+            for(size_t r=r0; r < r1; ++r) {
+                unsigned char* prev = &previous[r*row_bytes + x0];
+                XorBytes(prev, prev, in, w);
+                in += w;
+            }
+        }
+    }else{
+        throw VideoException("delta codec: unknown frame type");
+    }
+
+    for(size_t r=0; r < img.h; ++r) {
+        memcpy(img.RowPtr(r), &previous[r*row_bytes], row_bytes);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Image file codecs
+//////////////////////////////////////////////////////////////////////////
+
+PangoPngCodec::PangoPngCodec(const VideoPixelFormat& fmt, int zlib_level)
+    : fmt(fmt), zlib_level(zlib_level)
+{
+}
+
+std::string PangoPngCodec::Name() const
+{
+    return "png";
+}
+
+void PangoPngCodec::Encode(std::vector<unsigned char>& out, const Image<unsigned char>& img)
+{
+    vectorstreambuf buf(out);
+    std::ostream os(&buf);
+    SavePng(img, fmt, os, true, zlib_level);
+}
+
+void PangoPngCodec::Decode(Image<unsigned char>& img, const unsigned char* data, size_t n)
+{
+    memstreambuf buf(data, n);
+    std::istream is(&buf);
+    LoadPng(is, img, fmt);
+}
+
+PangoJpegCodec::PangoJpegCodec(const VideoPixelFormat& fmt, int quality)
+    : fmt(fmt), quality(quality)
+{
+}
+
+std::string PangoJpegCodec::Name() const
+{
+    return "jpeg";
+}
+
+void PangoJpegCodec::Encode(std::vector<unsigned char>& out, const Image<unsigned char>& img)
+{
+    vectorstreambuf buf(out);
+    std::ostream os(&buf);
+    SaveJpg(img, fmt, os, quality);
+}
+
+void PangoJpegCodec::Decode(Image<unsigned char>& img, const unsigned char* data, size_t n)
+{
+    memstreambuf buf(data, n);
+    std::istream is(&buf);
+    LoadJpg(is, img, fmt);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Factory
+//////////////////////////////////////////////////////////////////////////
+
+PangoVideoCodec* CreatePangoVideoCodec(const std::string& name, const StreamInfo& stream, const Params& options)
+{
+    const VideoPixelFormat& fmt = stream.PixFormat();
+
+    if(name.empty() || name == "raw") {
+        return 0;
+    }else if(name == "depth") {
+        if(fmt.channels != 1 || fmt.bpp != 16) {
+            throw VideoException("pango: 'depth' codec requires 16 bit single channel stream, not " + fmt.format);
+        }
+        return new PangoDepthCodec();
+    }else if(name == "delta") {
+        if(fmt.bpp % 8) {
+            throw VideoException("pango: 'delta' codec requires whole bytes per pixel, not " + fmt.format);
+        }
+        return new PangoDeltaCodec(fmt, options.Get<size_t>("keyframe", 30), options.Get<size_t>("tile", 16));
+    }else if(name == "png") {
+        for(unsigned int c=1; c < fmt.channels; ++c) {
+            if(fmt.channel_bits[c] != fmt.channel_bits[0]) {
+                throw VideoException("pango: 'png' codec requires equal bits per channel, not " + fmt.format);
+            }
+        }
+        // 16 bit PNGs are only read back as GRAY16LE
+        const bool supported = (fmt.channels >= 1 && fmt.channels <= 4 && fmt.channel_bits[0] == 8) ||
+                               (fmt.channels == 1 && fmt.channel_bits[0] == 16);
+        if(!supported) {
+            throw VideoException("pango: 'png' codec requires 8 bit channels or single 16 bit channel, not " + fmt.format);
+        }
+        return new PangoPngCodec(fmt, options.Get<int>("level", 1));
+    }else if(name == "jpeg") {
+        if( !(fmt.channels == 1 && fmt.bpp == 8) && !(fmt.channels == 3 && fmt.bpp == 24) ) {
+            throw VideoException("pango: 'jpeg' codec requires GRAY8 or RGB24 stream, not " + fmt.format);
+        }
+        return new PangoJpegCodec(fmt, options.Get<int>("quality", 90));
+    }else{
+        throw VideoException("pango: unknown stream codec '" + name + "'");
+    }
+}
+
+}
@@ -27,20 +27,128 @@
 
 #include <pangolin/video/drivers/pango_video_output.h>
 #include <pangolin/utils/picojson.h>
+#include <pangolin/utils/thread_pool.h>
+#include <pangolin/compat/bind.h>
+#include <pangolin/compat/mutex.h>
+#include <pangolin/compat/condition_variable.h>
+#include <algorithm>
 #include <set>
+#include <string.h>
 
 namespace pangolin
 {
 
 const std::string pango_video_type = "raw_video";
 
-PangoVideoOutput::PangoVideoOutput(const std::string& filename)
-    : packetstream(filename), packetstreamsrcid(-1)
+// Number of int64 fields of VideoFrameInfo stored before each frame
+const size_t pango_frame_info_fields = 4;
+
+struct PangoStreamEncoder
+{
+    void operator()(size_t i) const
+    {
+        // Inter-frame streams are encoded in order as frames are queued
+        if((*codecs)[i] && (*codecs)[i]->InterFrame()) {
+            return;
+        }
+
+        std::vector<unsigned char>& out = (*encoded)[i];
+        out.clear();
+        const StreamInfo& si = (*streams)[i];
+        if((*codecs)[i]) {
+            (*codecs)[i]->Encode(out, si.StreamImage(data));
+        }else{
+            const unsigned char* raw = data + (size_t)si.Offset();
+            out.assign(raw, raw + si.SizeBytes());
+        }
+    }
+
+    const std::vector<StreamInfo>* streams;
+    const std::vector<PangoVideoCodec*>* codecs;
+    std::vector<std::vector<unsigned char> >* encoded;
+    unsigned char* data;
+};
+
+// Copy of one frame, encoded on a pool thread
+struct PangoEncodeJob
+{
+    PangoEncodeJob() : done(true) {}
+
+    void Run()
+    {
+        std::string err;
+        try {
+            PangoStreamEncoder encoder;
+            encoder.streams = streams;
+            encoder.codecs = codecs;
+            encoder.encoded = &encoded;
+            encoder.data = &frame[0];
+            DefaultThreadPool().ParallelFor(streams->size(), encoder);
+        }catch(const std::exception& e) {
+            err = e.what();
+        }
+
+        {
+            boostd::unique_lock<boostd::mutex> lock(mutex);
+            error = err;
+            done = true;
+        }
+        cond_done.notify_all();
+    }
+
+    bool IsDone()
+    {
+        boostd::unique_lock<boostd::mutex> lock(mutex);
+        return done;
+    }
+
+    void Wait()
+    {
+        boostd::unique_lock<boostd::mutex> lock(mutex);
+        while(!done) {
+            cond_done.wait(lock);
+        }
+    }
+
+    const std::vector<StreamInfo>* streams;
+    const std::vector<PangoVideoCodec*>* codecs;
+
+    std::vector<unsigned char> frame;
+    json::value frame_properties;
+    int64_t info[pango_frame_info_fields];
+    std::vector<std::vector<unsigned char> > encoded;
+
+    std::string error;
+    bool done;
+    boostd::mutex mutex;
+    boostd::condition_variable cond_done;
+};
+
+PangoVideoOutput::PangoVideoOutput(const std::string& filename, const std::string& default_codec, const std::map<size_t,std::string>& stream_codecs, const Params& codec_options, size_t data_alignment_bytes)
+    : packetstream(filename), packetstreamsrcid(-1),
+      default_codec(default_codec), stream_codecs(stream_codecs), codec_options(codec_options),
+      data_alignment_bytes(std::max(data_alignment_bytes, (size_t)1)),
+      frame_info_bytes(0), variable_packets(false), frame_size_bytes(0),
+      max_jobs(2*DefaultThreadPool().NumThreads())
 {
 }
 
 PangoVideoOutput::~PangoVideoOutput()
 {
+    // Codecs must outlive any frames still being encoded
+    for(size_t i=0; i < jobs.size(); ++i) {
+        jobs[i]->Wait();
+    }
+
+    try {
+        WriteEncodedFrames(true);
+    }catch(const std::exception& e) {
+        pango_print_error("PangoVideoOutput: %s\n", e.what());
+    }
+
+    for(size_t i=0; i < codecs.size(); ++i) {
+        delete codecs[i];
+    }
 }
 
 const std::vector<StreamInfo>& PangoVideoOutput::Streams() const
@@ -66,6 +174,20 @@ void PangoVideoOutput::SetStreams(const std::vector<StreamInfo>& st, const std::
     }else{
         throw std::runtime_error("Unable to add new streams");
     }
+
+    // Create codecs now so that incompatible streams are reported early
+    for(size_t i=0; i < codecs.size(); ++i) {
+        delete codecs[i];
+    }
+    codecs.assign(streams.size(), (PangoVideoCodec*)0);
+    variable_packets = false;
+    frame_size_bytes = 0;
+    for(size_t i=0; i < streams.size(); ++i) {
+        std::map<size_t,std::string>::const_iterator c = stream_codecs.find(i);
+        codecs[i] = CreatePangoVideoCodec(c != stream_codecs.end() ? c->second : default_codec, streams[i], codec_options);
+        variable_packets |= (codecs[i] != 0);
+        frame_size_bytes = std::max(frame_size_bytes, (size_t)streams[i].Offset() + streams[i].SizeBytes());
+    }
 }
 
 void PangoVideoOutput::WriteHeader()
@@ -73,6 +195,13 @@ void PangoVideoOutput::WriteHeader()
     json::value json_header(json::object_type,false);
     json::value& json_streams = json_header["streams"];
     json_header["device"] = device_properties;
+    json_header["frame_info"] = true;
+
+    // Pad frame information so that raw image data shares packet alignment
+    const size_t info_bytes = pango_frame_info_fields*sizeof(int64_t);
+    frame_info_bytes = ((info_bytes + data_alignment_bytes - 1) / data_alignment_bytes) * data_alignment_bytes;
+    frame_header.assign(frame_info_bytes, 0);
+    json_header["frame_info_bytes"] = frame_info_bytes;
 
     total_frame_size = 0;
     for(unsigned int i=0; i< streams.size(); ++i) {
@@ -85,29 +214,154 @@ void PangoVideoOutput::WriteHeader()
         json_stream["height"] =   si.Height();
         json_stream["pitch"] =    si.Pitch();
         json_stream["offset"] =   (size_t)si.Offset();
+        if(codecs[i]) {
+            json_stream["codec"] = codecs[i]->Name();
+        }
+    }
+
+    if(variable_packets) {
+        // Each packet records the encoded size of every stream
+        packetstreamsrcid = packetstream.AddSource(
+            pango_video_type, input_uri, json_header, 0,
+            "struct Frame{"
+            " int64 host_time_us;"
+            " int64 device_time_us;"
+            " int64 sequence;"
+            " int64 dropped;"
+            " uint32 stream_bytes[" + pangolin::Convert<std::string,size_t>::Do(streams.size()) + "];"
+            " uint8 stream_data[];"
+            "};",
+            data_alignment_bytes
+        );
+        return;
     }
 
+    const std::string padding = frame_info_bytes > info_bytes ?
+        " uint8 padding[" + pangolin::Convert<std::string,size_t>::Do(frame_info_bytes - info_bytes) + "];" : "";
+
     packetstreamsrcid = packetstream.AddSource(
         pango_video_type, input_uri, json_header,
-        total_frame_size,
+        frame_info_bytes + total_frame_size,
         "struct Frame{"
+        " int64 host_time_us;"
+        " int64 device_time_us;"
+        " int64 sequence;"
+        " int64 dropped;" + padding +
         " uint8 stream_data[" + pangolin::Convert<std::string,size_t>::Do(total_frame_size) + "];"
-        "};"
+        "};",
+        data_alignment_bytes
     );
 }
 
+void PangoVideoOutput::QueueEncodedFrame(unsigned char* data, const json::value& frame_properties, const int64_t* info)
+{
+    // Limit frames in flight, writing any which are complete
+    WriteEncodedFrames(false);
+    while(jobs.size() >= max_jobs) {
+        jobs.front()->Wait();
+        WriteEncodedFrames(false);
+    }
+
+    boostd::shared_ptr<PangoEncodeJob> job;
+    if(free_jobs.empty()) {
+        job = boostd::shared_ptr<PangoEncodeJob>(new PangoEncodeJob());
+        job->streams = &streams;
+        job->codecs = &codecs;
+        job->frame.resize(frame_size_bytes);
+        job->encoded.resize(streams.size());
+    }else{
+        job = free_jobs.back();
+        free_jobs.pop_back();
+    }
+
+    memcpy(&job->frame[0], data, frame_size_bytes);
+    job->frame_properties = frame_properties;
+    memcpy(job->info, info, sizeof(job->info));
+
+    for(size_t i=0; i < streams.size(); ++i) {
+        if(codecs[i] && codecs[i]->InterFrame()) {
+            job->encoded[i].clear();
+            codecs[i]->Encode(job->encoded[i], streams[i].StreamImage(&job->frame[0]));
+        }
+    }
+
+    job->done = false;
+    jobs.push_back(job);
+    DefaultThreadPool().Enqueue(boostd::bind(&PangoEncodeJob::Run, job));
+}
+
+void PangoVideoOutput::WriteEncodedFrames(bool wait)
+{
+    while(!jobs.empty()) {
+        boostd::shared_ptr<PangoEncodeJob> job = jobs.front();
+        if(wait) {
+            job->Wait();
+        }else if(!job->IsDone()) {
+            break;
+        }
+        jobs.pop_front();
+        free_jobs.push_back(job);
+
+        if(!job->error.empty()) {
+            throw VideoException("pango: unable to encode frame", job->error);
+        }
+
+        if(!job->frame_properties.is<json::null>()) {
+            packetstream.WriteSourcePacketMeta(packetstreamsrcid, job->frame_properties);
+        }
+
+        const size_t info_bytes = pango_frame_info_fields*sizeof(int64_t);
+        const size_t header_bytes = info_bytes + streams.size()*sizeof(uint32_t);
+        size_t packet_bytes = header_bytes;
+        for(size_t i=0; i < streams.size(); ++i) {
+            packet_bytes += job->encoded[i].size();
+        }
+
+        packet.resize(packet_bytes);
+        memcpy(&packet[0], job->info, info_bytes);
+        size_t offset = header_bytes;
+        for(size_t i=0; i < streams.size(); ++i) {
+            const uint32_t n = (uint32_t)job->encoded[i].size();
+            memcpy(&packet[info_bytes + i*sizeof(uint32_t)], &n, sizeof(uint32_t));
+            if(n) memcpy(&packet[offset], &job->encoded[i][0], n);
+            offset += n;
+        }
+
+        packetstream.WriteSourcePacket(packetstreamsrcid, &packet[0], packet.size());
+    }
+}
+
 int PangoVideoOutput::WriteStreams(unsigned char* data, const json::value& frame_properties)
+{
+    // No information provided by caller, so use time of writing.
+    local_frame_info.Arrived();
+    return WriteStreams(data, frame_properties, local_frame_info);
+}
+
+int PangoVideoOutput::WriteStreams(unsigned char* data, const json::value& frame_properties, const VideoFrameInfo& frame_info)
 {
     if(packetstreamsrcid == -1) {
         WriteHeader();
     }
 
+    const int64_t info[pango_frame_info_fields] = {
+        frame_info.host_time_us, frame_info.device_time_us,
+        frame_info.sequence, frame_info.dropped
+    };
+
+    if(variable_packets) {
+        QueueEncodedFrame(data, frame_properties, info);
+        return 0;
+    }
+
     if(!frame_properties.is<json::null>()) {
         packetstream.WriteSourcePacketMeta(packetstreamsrcid, frame_properties);
     }
 
+    memcpy(&frame_header[0], info, sizeof(info));
     packetstream.WriteSourcePacket(
         packetstreamsrcid,
+        &frame_header[0], frame_header.size(),
         (char*)data, total_frame_size
     );
 
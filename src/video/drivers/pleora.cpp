@@ -288,6 +288,7 @@ bool PleoraVideo::GrabNext( unsigned char* image, bool /*wait*/ )
         {
             PvImage *lImage = lBuffer->GetImage();
             std::memcpy(image, lImage->GetDataPointer(), size_bytes);
+            frame_info.Arrived( (int64_t)lBuffer->GetTimestamp() / 1000 );
             good = true;
         }
     } else {
@@ -337,6 +338,7 @@ bool PleoraVideo::GrabNewest( unsigned char* image, bool wait )
     {
         PvImage *lImage = lBuffer->GetImage();
         std::memcpy(image, lImage->GetDataPointer(), size_bytes);
+        frame_info.Arrived( (int64_t)lBuffer->GetTimestamp() / 1000 );
         good = true;
     }
 
@@ -344,6 +346,11 @@ bool PleoraVideo::GrabNewest( unsigned char* image, bool wait )
     return good;
 }
 
+const VideoFrameInfo& PleoraVideo::FrameInfo() const
+{
+    return frame_info;
+}
+
 template<typename T>
 T PleoraVideo::DeviceParam(const char* name)
 {
@@ -104,6 +104,9 @@ bool PvnVideo::GrabNext( unsigned char* image, bool /*wait*/ )
     }
     
     last_frame = TimeNow();
+    if(file.good()) {
+        frame_info.Arrived();
+    }
     return file.good();
 }
 
@@ -112,4 +115,9 @@ bool PvnVideo::GrabNewest( unsigned char* image, bool wait )
     return GrabNext(image,wait);
 }
 
+const VideoFrameInfo& PvnVideo::FrameInfo() const
+{
+    return frame_info;
+}
+
 }
@@ -0,0 +1,100 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <pangolin/video/drivers/shared_memory.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+namespace pangolin
+{
+
+std::string SharedMemoryName(const std::string& name)
+{
+    if(name.empty()) {
+        throw VideoException("shm: no name specified");
+    }
+    return (name[0] == '/') ? name : "/" + name;
+}
+
+SharedMemoryBuffer::SharedMemoryBuffer(const std::string& shm_name, bool owner, size_t size)
+    : name(SharedMemoryName(shm_name)), owner(owner), fd(-1), ptr(0), size_bytes(size)
+{
+    if(owner) {
+        // Remove region left behind by a writer that didn't exit cleanly
+        shm_unlink(name.c_str());
+
+        fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH);
+        if(fd == -1) {
+            throw VideoException("shm: unable to create '" + name + "'", strerror(errno));
+        }
+
+        if(ftruncate(fd, size_bytes) == -1) {
+            const std::string err = strerror(errno);
+            close(fd);
+            shm_unlink(name.c_str());
+            throw VideoException("shm: unable to size '" + name + "'", err);
+        }
+    }else{
+        fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if(fd == -1) {
+            throw VideoException("shm: unable to open '" + name + "'", strerror(errno));
+        }
+
+        struct stat st;
+        if(fstat(fd, &st) == -1 || (size_t)st.st_size < sizeof(SharedMemoryHeader)) {
+            close(fd);
+            throw VideoException("shm: '" + name + "' is not a valid video region");
+        }
+        size_bytes = st.st_size;
+    }
+
+    void* p = mmap(0, size_bytes, owner ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    if(p == MAP_FAILED) {
+        const std::string err = strerror(errno);
+        close(fd);
+        if(owner) shm_unlink(name.c_str());
+        throw VideoException("shm: unable to map '" + name + "'", err);
+    }
+    ptr = (unsigned char*)p;
+}
+
+SharedMemoryBuffer::~SharedMemoryBuffer()
+{
+    munmap(ptr, size_bytes);
+    close(fd);
+    if(owner) {
+        // Existing readers keep their mapping; new readers can't attach.
+        shm_unlink(name.c_str());
+    }
+}
+
+}
@@ -0,0 +1,187 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <pangolin/video/drivers/shared_memory_video.h>
+
+#include <string.h>
+#include <unistd.h>
+
+namespace pangolin
+{
+
+// Polling interval whilst waiting for the writer
+const useconds_t shm_poll_us = 200;
+
+SharedMemoryVideo::SharedMemoryVideo(const std::string& name)
+    : shm(name, false), size_bytes(0), next_seq(0), lapped(0)
+{
+    SharedMemoryHeader& h = shm.Header();
+
+    if(__atomic_load_n(&h.magic, __ATOMIC_ACQUIRE) != shm_magic || h.version != shm_version) {
+        throw VideoException("shm: '" + name + "' is not a compatible video region");
+    }
+
+    if(h.num_streams > shm_max_streams || shm.SizeBytes() < ShmHeaderBytes() + h.num_slots * h.slot_stride_bytes) {
+        throw VideoException("shm: '" + name + "' has corrupt header");
+    }
+
+    for(size_t i=0; i<h.num_streams; ++i) {
+        const SharedMemoryStream& s = h.streams[i];
+        const std::string fmt(s.format, strnlen(s.format, shm_format_len));
+        streams.push_back( StreamInfo(VideoFormatFromString(fmt), s.width, s.height, s.pitch, (unsigned char*)0 + s.offset) );
+    }
+    size_bytes = h.frame_size_bytes;
+
+    Start();
+}
+
+SharedMemoryVideo::~SharedMemoryVideo()
+{
+}
+
+size_t SharedMemoryVideo::SizeBytes() const
+{
+    return size_bytes;
+}
+
+const std::vector<StreamInfo>& SharedMemoryVideo::Streams() const
+{
+    return streams;
+}
+
+void SharedMemoryVideo::Start()
+{
+    // Begin with the most recently published frame
+    const uint64_t w = ShmLoadAcquire(&shm.Header().write_seq);
+    next_seq = w > 0 ? w - 1 : 0;
+}
+
+void SharedMemoryVideo::Stop()
+{
+}
+
+bool SharedMemoryVideo::WaitForFrame(bool wait)
+{
+    SharedMemoryHeader& h = shm.Header();
+
+    while(true) {
+        const uint64_t w = ShmLoadAcquire(&h.write_seq);
+
+        if(next_seq < w) {
+            // Slot of frame w may be mid-write, so frames older than
+            // w+1-num_slots are unrecoverable.
+            const uint64_t oldest = (w + 1 > h.num_slots) ? w + 1 - h.num_slots : 0;
+            if(next_seq < oldest) {
+                lapped += oldest - next_seq;
+                next_seq = oldest;
+            }
+            return true;
+        }
+
+        if(!wait || __atomic_load_n(&h.closed, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+
+        usleep(shm_poll_us);
+    }
+}
+
+bool SharedMemoryVideo::CopyFrame(uint64_t seq, unsigned char* image)
+{
+    const size_t i = seq % shm.Header().num_slots;
+    SharedMemorySlot& slot = shm.Slot(i);
+
+    if(ShmLoadAcquire(&slot.seq) != seq) {
+        return false;
+    }
+
+    memcpy(image, shm.SlotFrame(i), size_bytes);
+    VideoFrameInfo info;
+    info.host_time_us = slot.host_time_us;
+    info.device_time_us = slot.device_time_us;
+    info.sequence = slot.sequence;
+    info.dropped = slot.dropped + lapped;
+
+    if(!IsValid(seq)) {
+        return false;
+    }
+
+    frame_info = info;
+    return true;
+}
+
+bool SharedMemoryVideo::GrabNext( unsigned char* image, bool wait )
+{
+    while(WaitForFrame(wait)) {
+        if(CopyFrame(next_seq, image)) {
+            ++next_seq;
+            return true;
+        }
+        // Overwritten whilst copying; WaitForFrame will skip ahead.
+        ++lapped;
+        ++next_seq;
+    }
+    return false;
+}
+
+bool SharedMemoryVideo::GrabNewest( unsigned char* image, bool wait )
+{
+    const uint64_t w = ShmLoadAcquire(&shm.Header().write_seq);
+    if(w > next_seq) {
+        next_seq = w - 1;
+    }
+    return GrabNext(image, wait);
+}
+
+const VideoFrameInfo& SharedMemoryVideo::FrameInfo() const
+{
+    return frame_info;
+}
+
+const unsigned char* SharedMemoryVideo::MapNext(uint64_t& seq, bool wait)
+{
+    while(WaitForFrame(wait)) {
+        const size_t i = next_seq % shm.Header().num_slots;
+        if(ShmLoadAcquire(&shm.Slot(i).seq) == next_seq) {
+            seq = next_seq++;
+            return shm.SlotFrame(i);
+        }
+        ++lapped;
+        ++next_seq;
+    }
+    return 0;
+}
+
+bool SharedMemoryVideo::IsValid(uint64_t seq)
+{
+    // Order preceding reads of frame data before re-checking the slot
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    const size_t i = seq % shm.Header().num_slots;
+    return __atomic_load_n(&shm.Slot(i).seq, __ATOMIC_RELAXED) == seq;
+}
+
+}
@@ -0,0 +1,145 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <pangolin/video/drivers/shared_memory_video_output.h>
+
+#include <algorithm>
+#include <set>
+#include <string.h>
+
+namespace pangolin
+{
+
+SharedMemoryVideoOutput::SharedMemoryVideoOutput(const std::string& name, size_t num_slots)
+    : name(name), num_slots(num_slots), shm(0)
+{
+    if(num_slots < 2) {
+        throw VideoException("shm: at least two slots are required");
+    }
+}
+
+SharedMemoryVideoOutput::~SharedMemoryVideoOutput()
+{
+    if(shm) {
+        __atomic_store_n(&shm->Header().closed, 1u, __ATOMIC_RELEASE);
+        delete shm;
+    }
+}
+
+const std::vector<StreamInfo>& SharedMemoryVideoOutput::Streams() const
+{
+    return streams;
+}
+
+void SharedMemoryVideoOutput::SetStreams(const std::vector<StreamInfo>& st, const std::string& /*uri*/, const json::value& /*properties*/)
+{
+    if(shm) {
+        throw std::runtime_error("Unable to add new streams");
+    }
+
+    if(st.size() == 0 || st.size() > shm_max_streams) {
+        throw VideoException("shm: unsupported number of streams");
+    }
+
+    std::set<unsigned char*> unique_ptrs;
+    size_t frame_size_bytes = 0;
+    for(size_t i=0; i<st.size(); ++i) {
+        unique_ptrs.insert(st[i].Offset());
+        frame_size_bytes = std::max(frame_size_bytes, (size_t)st[i].Offset() + st[i].SizeBytes());
+        if(st[i].PixFormat().format.size() >= shm_format_len) {
+            throw VideoException("shm: pixel format name too long", st[i].PixFormat().format);
+        }
+    }
+
+    if(unique_ptrs.size() < st.size()) {
+        throw std::invalid_argument("Each image must have unique offset into buffer.");
+    }
+
+    streams = st;
+
+    const size_t slot_stride = ShmSlotHeaderBytes() + ShmAlign(frame_size_bytes);
+    shm = new SharedMemoryBuffer(name, true, ShmHeaderBytes() + num_slots * slot_stride);
+
+    SharedMemoryHeader& h = shm->Header();
+    h.version = shm_version;
+    h.num_slots = num_slots;
+    h.num_streams = streams.size();
+    h.frame_size_bytes = frame_size_bytes;
+    h.slot_stride_bytes = slot_stride;
+    h.write_seq = 0;
+    h.closed = 0;
+    for(size_t i=0; i<streams.size(); ++i) {
+        SharedMemoryStream& s = h.streams[i];
+        strncpy(s.format, streams[i].PixFormat().format.c_str(), shm_format_len);
+        s.width = streams[i].Width();
+        s.height = streams[i].Height();
+        s.pitch = streams[i].Pitch();
+        s.offset = (size_t)streams[i].Offset();
+    }
+    for(size_t i=0; i<num_slots; ++i) {
+        shm->Slot(i).seq = shm_invalid_seq;
+    }
+
+    // Readers only trust the header once the magic number is visible
+    __atomic_store_n(&h.magic, shm_magic, __ATOMIC_RELEASE);
+}
+
+int SharedMemoryVideoOutput::WriteStreams(unsigned char* data, const json::value& frame_properties)
+{
+    // No information provided by caller, so use time of writing.
+    local_frame_info.Arrived();
+    return WriteStreams(data, frame_properties, local_frame_info);
+}
+
+int SharedMemoryVideoOutput::WriteStreams(unsigned char* data, const json::value& /*frame_properties*/, const VideoFrameInfo& frame_info)
+{
+    if(!shm) {
+        throw std::runtime_error("shm: SetStreams must be called before WriteStreams");
+    }
+
+    SharedMemoryHeader& h = shm->Header();
+    const uint64_t seq = h.write_seq;
+    SharedMemorySlot& slot = shm->Slot(seq % num_slots);
+
+    // Invalidate slot before touching frame so that readers still holding
+    // the previous occupant notice it has been overwritten.
+    __atomic_store_n(&slot.seq, shm_invalid_seq, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    memcpy(shm->SlotFrame(seq % num_slots), data, h.frame_size_bytes);
+    slot.host_time_us = frame_info.host_time_us;
+    slot.device_time_us = frame_info.device_time_us;
+    slot.sequence = frame_info.sequence;
+    slot.dropped = frame_info.dropped;
+
+    ShmStoreRelease(&slot.seq, seq);
+    ShmStoreRelease(&h.write_seq, seq + 1);
+
+    return 0;
+}
+
+}
@@ -26,6 +26,7 @@
  */
 
 #include <pangolin/video/drivers/shift.h>
+#include "driver_kernels.h"
 
 namespace pangolin
 {
@@ -112,6 +113,7 @@ bool ShiftVideo::GrabNext( unsigned char* image, bool wait )
             Image<unsigned char> img_out = Streams()[s].StreamImage(image);
             DoShift16to8(img_out, img_in, shift_right_bits, mask);
         }
+        UpdateFrameInfoFromSource(frame_info, videoin[0]);
         return true;
     }else{
         return false;
@@ -129,5 +131,11 @@ std::vector<VideoInterface*>& ShiftVideo::InputStreams()
     return videoin;
 }
 
+//! Implement VideoFrameInfoInterface::FrameInfo()
+const VideoFrameInfo& ShiftVideo::FrameInfo() const
+{
+    return frame_info;
+}
+
 
 }
@@ -167,7 +167,10 @@ bool TeliVideo::GrabNext(unsigned char* image, bool wait)
         Teli::CAM_IMAGE_INFO sImageInfo;
         uint32_t uiPyldSize = size_bytes;
         Teli::CAM_API_STATUS uiStatus = Teli::Strm_ReadCurrentImage(strm, image, &uiPyldSize, &sImageInfo);
-        return (uiStatus == Teli::CAM_API_STS_SUCCESS);
+        if(uiStatus == Teli::CAM_API_STS_SUCCESS) {
+            frame_info.Arrived();
+            return true;
+        }
     }
 
     return false;
@@ -26,28 +26,90 @@
  */
 
 #include <pangolin/video/drivers/test.h>
+#include <pangolin/utils/timer.h>
+#include <pangolin/compat/thread.h>
+
+#include <algorithm>
+#include <string.h>
 
 namespace pangolin
 {
 
-void setRandomData(unsigned char * arr, int size){
-  for(int i = 0 ; i < size;i++) {
-//      arr[i] = (unsigned char)(i * 255.0 / size);
-      arr[i] = (unsigned char)(rand()/(RAND_MAX/255.0));
-  }
+// Width of TestVideoBars bars in pixels, and their speed in pixels per frame
+const size_t test_bar_width = 32;
+const size_t test_bar_speed = 4;
+
+// Size in pixels of each counter bit block
+const size_t test_counter_block = 8;
+
+TestVideoPattern TestVideoPatternFromString(const std::string& pattern)
+{
+    if(pattern == "random") return TestVideoRandom;
+    if(pattern == "gradient") return TestVideoGradient;
+    if(pattern == "bars") return TestVideoBars;
+    if(pattern == "bayer") return TestVideoBayer;
+    throw VideoException("Unknown test pattern '" + pattern + "'", "Use random, gradient, bars or bayer.");
+}
+
+// Deterministic well-mixed 64 bit value for n (splitmix64)
+inline uint64_t TestHash(uint64_t n)
+{
+    uint64_t z = n + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Row of RGGB mosaic: red varies with x, green with y, blue moves with frame
+template<typename T>
+void FillBayerRow(T* row, size_t w, size_t h, size_t y, int64_t phase)
+{
+    // Scale 8 bit value to fill type
+    const unsigned scale = (sizeof(T) == 1) ? 1 : 257;
+    const T g = (T)(scale * ((y * 256) / h));
+
+    if( (y & 1) == 0 ) {
+        // 16.16 fixed point red ramp
+        const size_t step = (256 << 16) / w;
+        for(size_t x=0, r=0; x < w; x += 2, r += 2*step) {
+            row[x] = (T)(scale * (r >> 16));
+            if(x+1 < w) row[x+1] = g;
+        }
+    }else{
+        const size_t b = (size_t)(y + phase);
+        for(size_t x=0; x < w; x += 2) {
+            row[x] = g;
+            if(x+1 < w) row[x+1] = (T)(scale * ((b + x + 1) & 0xff));
+        }
+    }
 }
 
-TestVideo::TestVideo(size_t w, size_t h, size_t n, std::string pix_fmt)
+TestVideo::TestVideo(size_t w, size_t h, size_t n, std::string pix_fmt,
+                     TestVideoPattern pattern, double fps, int64_t jitter_us, bool counter)
+    : pattern(pattern), period_us(fps > 0.0 ? (int64_t)(1E6 / fps) : 0),
+      jitter_us(jitter_us), counter(counter), next_frame(0)
 {
     const VideoPixelFormat pfmt = VideoFormatFromString(pix_fmt);
-    
+
+    if(pattern == TestVideoBayer && pfmt.bpp != 8 && pfmt.bpp != 16) {
+        throw VideoException("Bayer test pattern requires 8 or 16 bit format");
+    }
+
     size_bytes = 0;
     
     for(size_t c=0; c < n; ++c) {
-        const StreamInfo stream_info(pfmt, w, h, (w*pfmt.bpp)/8, 0);
+        const StreamInfo stream_info(pfmt, w, h, (w*pfmt.bpp)/8, (unsigned char*)0 + size_bytes);
         streams.push_back(stream_info);        
         size_bytes += w*h*(pfmt.bpp)/8;
     }
+
+    // Byte ramp long enough to copy any row from any starting phase
+    ramp.resize((w*pfmt.bpp)/8 + 256);
+    for(size_t i=0; i < ramp.size(); ++i) {
+        ramp[i] = (unsigned char)i;
+    }
+
+    start_us = Time_us(TimeNow());
 }
 
 TestVideo::~TestVideo()
@@ -58,7 +120,7 @@ TestVideo::~TestVideo()
 //! Implement VideoInput::Start()
 void TestVideo::Start()
 {
-    
+    start_us = Time_us(TimeNow()) - next_frame * period_us;
 }
 
 //! Implement VideoInput::Stop()
@@ -79,17 +141,142 @@ const std::vector<StreamInfo>& TestVideo::Streams() const
     return streams;
 }
 
+void TestVideo::Generate(unsigned char* image, int64_t frame)
+{
+    for(size_t c=0; c < streams.size(); ++c) {
+        Image<unsigned char> img = streams[c].StreamImage(image);
+        const size_t bpp = streams[c].PixFormat().bpp;
+        const size_t Bpp = std::max(bpp / 8, (size_t)1);
+        const size_t row_bytes = (img.w * bpp) / 8;
+        // Offset streams from one another so that they are distinguishable
+        const int64_t phase = frame + 64*c;
+
+        switch(pattern) {
+        case TestVideoRandom:
+        {
+            uint64_t state = TestHash((uint64_t)phase);
+            for(size_t y=0; y < img.h; ++y) {
+                unsigned char* row = img.RowPtr(y);
+                size_t x = 0;
+                for(; x + sizeof(uint64_t) <= row_bytes; x += sizeof(uint64_t)) {
+                    // xorshift64
+                    state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+                    memcpy(row + x, &state, sizeof(uint64_t));
+                }
+                for(; x < row_bytes; ++x) {
+                    row[x] = (unsigned char)(state >> (8*(x%8)));
+                }
+            }
+            break;
+        }
+        case TestVideoGradient:
+            for(size_t y=0; y < img.h; ++y) {
+                memcpy(img.RowPtr(y), &ramp[(y + phase) & 0xff], row_bytes);
+            }
+            break;
+        case TestVideoBars:
+        {
+            unsigned char* row0 = img.RowPtr(0);
+            const size_t shift = (size_t)phase * test_bar_speed;
+            for(size_t x=0; x < row_bytes; ++x) {
+                row0[x] = (((x / Bpp + shift) / test_bar_width) & 1) ? 0xff : 0x00;
+            }
+            for(size_t y=1; y < img.h; ++y) {
+                memcpy(img.RowPtr(y), row0, row_bytes);
+            }
+            break;
+        }
+        case TestVideoBayer:
+            for(size_t y=0; y < img.h; ++y) {
+                if(bpp == 8) {
+                    FillBayerRow(img.RowPtr(y), img.w, img.h, y, phase);
+                }else{
+                    FillBayerRow((uint16_t*)img.RowPtr(y), img.w, img.h, y, phase);
+                }
+            }
+            break;
+        }
+
+        if(counter) {
+            BurnCounter(img, bpp, frame);
+        }
+    }
+}
+
+void TestVideo::BurnCounter(Image<unsigned char>& img, size_t bpp, int64_t frame)
+{
+    const size_t Bpp = std::max(bpp / 8, (size_t)1);
+    const size_t b = test_counter_block;
+
+    for(size_t bit=0; bit < 64; ++bit) {
+        const size_t bx = (bit % 16) * b;
+        const size_t by = (bit / 16) * b;
+        if(bx + b > img.w || by + b > img.h) continue;
+
+        const int val = (((uint64_t)frame >> (63 - bit)) & 1) ? 0xff : 0x00;
+        for(size_t y = by; y < by + b; ++y) {
+            memset(img.RowPtr(y) + bx*Bpp, val, b*Bpp);
+        }
+    }
+}
+
+bool TestVideo::WaitForFrame(int64_t frame, bool wait)
+{
+    if(period_us <= 0) {
+        return true;
+    }
+
+    int64_t due_us = start_us + frame * period_us;
+    if(jitter_us > 0) {
+        due_us += TestHash((uint64_t)frame) % (uint64_t)(jitter_us + 1);
+    }
+
+    const int64_t wait_us = due_us - Time_us(TimeNow());
+    if(wait_us > 0) {
+        if(!wait) {
+            return false;
+        }
+#if defined(CPP11_NO_BOOST) || BOOST_VERSION >= 104500
+        boostd::this_thread::sleep_for(boostd::chrono::microseconds(wait_us));
+#else
+        while(Time_us(TimeNow()) < due_us);
+#endif
+    }
+    return true;
+}
+
 //! Implement VideoInput::GrabNext()
 bool TestVideo::GrabNext( unsigned char* image, bool wait )
 {
-    setRandomData(image, size_bytes);
+    const int64_t frame = next_frame;
+    if(!WaitForFrame(frame, wait)) {
+        return false;
+    }
+
+    Generate(image, frame);
+    ++next_frame;
+
+    frame_info.Arrived(period_us > 0 ? start_us + frame * period_us : -1, frame - (frame_info.sequence + 1));
+    // We know the true sequence number of the frame
+    frame_info.sequence = frame;
     return true;
 }
 
 //! Implement VideoInput::GrabNewest()
 bool TestVideo::GrabNewest( unsigned char* image, bool wait )
 {
+    if(period_us > 0) {
+        // Skip to most recent frame that would have been captured by now
+        const int64_t latest = (Time_us(TimeNow()) - start_us) / period_us;
+        next_frame = std::max(next_frame, latest);
+    }
     return GrabNext(image,wait);
 }
 
+//! Implement VideoFrameInfoInterface::FrameInfo()
+const VideoFrameInfo& TestVideo::FrameInfo() const
+{
+    return frame_info;
+}
+
 }
@@ -53,6 +53,13 @@ UnpackVideo::UnpackVideo(VideoInterface* src, VideoPixelFormat out_fmt)
             throw VideoException("UnpackVideo: Only supports one channel input.");
         }
 
+        // Resolve kernel once so GrabNext needn't inspect formats per frame
+        const PixelConvertFunc convert = FindPixelConversion(in_fmt, out_fmt);
+        if(!convert) {
+            throw VideoException("UnpackVideo: Unsupported conversion", in_fmt.format + " to " + out_fmt.format);
+        }
+        converters.push_back(convert);
+
         const size_t pitch = (w*out_fmt.bpp)/ 8;
         streams.push_back(pangolin::StreamInfo( out_fmt, w, h, pitch, (unsigned char*)0 + size_bytes ));
         size_bytes += h*pitch;
@@ -91,48 +98,6 @@ const std::vector<StreamInfo>& UnpackVideo::Streams() const
     return streams;
 }
 
-template<typename T>
-void ConvertFrom10bit(
-    Image<unsigned char>& out,
-    const Image<unsigned char>& in
-) {
-    for(size_t r=0; r<out.h; ++r) {
-        T* pout = (T*)(out.ptr + r*out.pitch);
-        uint8_t* pin = in.ptr + r*in.pitch;
-        const uint8_t* pin_end = in.ptr + (r+1)*in.pitch;
-        while(pin != pin_end) {
-            uint64_t val = *(pin++);
-            val |= uint64_t(*(pin++)) << 8;
-            val |= uint64_t(*(pin++)) << 16;
-            val |= uint64_t(*(pin++)) << 24;
-            val |= uint64_t(*(pin++)) << 32;
-            *(pout++) = T( val & 0x00000003FF);
-            *(pout++) = T((val & 0x00000FFC00) >> 10);
-            *(pout++) = T((val & 0x003FF00000) >> 20);
-            *(pout++) = T((val & 0xFFC0000000) >> 30);
-        }
-    }
-}
-
-template<typename T>
-void ConvertFrom12bit(
-    Image<unsigned char>& out,
-    const Image<unsigned char>& in
-) {
-    for(size_t r=0; r<out.h; ++r) {
-        T* pout = (T*)(out.ptr + r*out.pitch);
-        uint8_t* pin = in.ptr + r*in.pitch;
-        const uint8_t* pin_end = in.ptr + (r+1)*in.pitch;
-        while(pin != pin_end) {
-            uint32_t val = *(pin++);
-            val |= uint32_t(*(pin++)) << 8;
-            val |= uint32_t(*(pin++)) << 16;
-            *(pout++) = T( val & 0x000FFF);
-            *(pout++) = T((val & 0xFFF000) >> 12);
-        }
-    }
-}
-
 //! Implement VideoInput::GrabNext()
 bool UnpackVideo::GrabNext( unsigned char* image, bool wait )
 {    
@@ -141,27 +106,9 @@ bool UnpackVideo::GrabNext( unsigned char* image, bool wait )
             Image<unsigned char> img_in  = videoin[0]->Streams()[s].StreamImage(buffer);
             Image<unsigned char> img_out = Streams()[s].StreamImage(image);
 
-            const int bits_in  = videoin[0]->Streams()[s].PixFormat().bpp;
-
-            if(Streams()[s].PixFormat().format == "GRAY32F") {
-                if( bits_in == 10) {
-                    ConvertFrom10bit<float>(img_out, img_in);
-                }else if( bits_in == 12){
-                    ConvertFrom12bit<float>(img_out, img_in);
-                }else{
-                    throw pangolin::VideoException("Unsupported bitdepths.");
-                }
-            }else if(Streams()[s].PixFormat().format == "GRAY16LE") {
-                if( bits_in == 10) {
-                    ConvertFrom10bit<uint16_t>(img_out, img_in);
-                }else if( bits_in == 12){
-                    ConvertFrom12bit<uint16_t>(img_out, img_in);
-                }else{
-                    throw pangolin::VideoException("Unsupported bitdepths.");
-                }
-            }else{
-            }
+            converters[s](img_out, img_in);
         }
+        UpdateFrameInfoFromSource(frame_info, videoin[0]);
         return true;
     }else{
         return false;
@@ -179,5 +126,11 @@ std::vector<VideoInterface*>& UnpackVideo::InputStreams()
     return videoin;
 }
 
+//! Implement VideoFrameInfoInterface::FrameInfo()
+const VideoFrameInfo& UnpackVideo::FrameInfo() const
+{
+    return frame_info;
+}
+
 
 }
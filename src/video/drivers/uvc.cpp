@@ -230,6 +230,7 @@ bool UvcVideo::GrabNext( unsigned char* image, bool wait )
     }else{
         if(frame) {
             memcpy(image, frame->data, frame->data_bytes );
+            frame_info.Arrived();
             return true;
         }else{
             std::cerr << "No data..." << std::endl;
@@ -243,6 +244,11 @@ bool UvcVideo::GrabNewest( unsigned char* image, bool wait )
     return GrabNext(image, wait);
 }
 
+const VideoFrameInfo& UvcVideo::FrameInfo() const
+{
+    return frame_info;
+}
+
 int UvcVideo::IoCtrl(uint8_t unit, uint8_t ctrl, unsigned char* data, int len, UvcRequestCode req_code)
 {
     if(req_code == UVC_SET_CUR) {
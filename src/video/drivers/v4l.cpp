@@ -75,7 +75,7 @@ inline std::string V4lToString(int32_t v)
 }
 
 V4lVideo::V4lVideo(const char* dev_name, io_method io, unsigned iwidth, unsigned iheight)
-    : io(io), fd(-1), buffers(0), n_buffers(0), running(false)
+    : io(io), fd(-1), buffers(0), n_buffers(0), running(false), last_device_sequence(-1)
 {
     open_device(dev_name);
     init_device(dev_name,iwidth,iheight,0);
@@ -240,10 +240,25 @@ int V4lVideo::ReadFrame(unsigned char* image)
         
         break;
     }
+
+    if(io == IO_METHOD_READ) {
+        frame_info.Arrived();
+    }else{
+        // Gaps in the driver sequence number indicate dropped frames
+        const int64_t dropped = (last_device_sequence >= 0 && buf.sequence > last_device_sequence) ?
+                    buf.sequence - last_device_sequence - 1 : 0;
+        last_device_sequence = buf.sequence;
+        frame_info.Arrived( (int64_t)buf.timestamp.tv_sec * 1000000 + buf.timestamp.tv_usec, dropped );
+    }
     
     return 1;
 }
 
+const VideoFrameInfo& V4lVideo::FrameInfo() const
+{
+    return frame_info;
+}
+
 void V4lVideo::Stop()
 {
     enum v4l2_buf_type type;
@@ -71,12 +71,16 @@ void VideoSplitter::Stop()
 
 bool VideoSplitter::GrabNext( unsigned char* image, bool wait )
 {
-    return videoin[0]->GrabNext(image, wait);
+    const bool success = videoin[0]->GrabNext(image, wait);
+    if(success) UpdateFrameInfoFromSource(frame_info, videoin[0]);
+    return success;
 }
 
 bool VideoSplitter::GrabNewest( unsigned char* image, bool wait )
 {
-    return videoin[0]->GrabNewest(image, wait);
+    const bool success = videoin[0]->GrabNewest(image, wait);
+    if(success) UpdateFrameInfoFromSource(frame_info, videoin[0]);
+    return success;
 }
 
 std::vector<VideoInterface*>& VideoSplitter::InputStreams()
@@ -84,6 +88,11 @@ std::vector<VideoInterface*>& VideoSplitter::InputStreams()
     return videoin;
 }
 
+const VideoFrameInfo& VideoSplitter::FrameInfo() const
+{
+    return frame_info;
+}
+
 
 
 }
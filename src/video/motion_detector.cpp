@@ -0,0 +1,125 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <pangolin/video/motion_detector.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#  include <emmintrin.h>
+#  define PANGOLIN_MOTION_SSE2
+#endif
+
+namespace pangolin
+{
+
+const size_t motion_block_bytes = 16;
+
+inline size_t BlockSad16(const unsigned char* a, const unsigned char* b)
+{
+#ifdef PANGOLIN_MOTION_SSE2
+    const __m128i va = _mm_loadu_si128((const __m128i*)a);
+    const __m128i vb = _mm_loadu_si128((const __m128i*)b);
+    const __m128i sad = _mm_sad_epu8(va, vb);
+    return (size_t)_mm_cvtsi128_si32(sad) + (size_t)_mm_cvtsi128_si32(_mm_srli_si128(sad, 8));
+#else
+    size_t sum = 0;
+    for(size_t i=0; i < motion_block_bytes; ++i) {
+        sum += (size_t)std::abs((int)a[i] - (int)b[i]);
+    }
+    return sum;
+#endif
+}
+
+size_t SumAbsDiff(const unsigned char* a, const unsigned char* b, size_t n)
+{
+    size_t sum = 0;
+    size_t i = 0;
+    for(; i + motion_block_bytes <= n; i += motion_block_bytes) {
+        sum += BlockSad16(a+i, b+i);
+    }
+    for(; i < n; ++i) {
+        sum += (size_t)std::abs((int)a[i] - (int)b[i]);
+    }
+    return sum;
+}
+
+MotionDetector::MotionDetector(double level, double area, size_t row_step)
+    : level(level), area(area), row_step(std::max(row_step, (size_t)1)),
+      ref_w(0), ref_h(0), score(0.0)
+{
+}
+
+void MotionDetector::Reset()
+{
+    reference.clear();
+    ref_w = 0;
+    ref_h = 0;
+    score = 0.0;
+}
+
+bool MotionDetector::Process(const Image<unsigned char>& img, size_t bytes_per_pixel)
+{
+    // Only whole blocks are compared, ignoring any trailing row padding
+    const size_t row_bytes = std::min(img.pitch, img.w * bytes_per_pixel);
+    const size_t blocks_per_row = row_bytes / motion_block_bytes;
+    const size_t rows = (img.h + row_step - 1) / row_step;
+
+    if(ref_w != row_bytes || ref_h != img.h || reference.empty()) {
+        // New or changed geometry, just take reference
+        ref_w = row_bytes;
+        ref_h = img.h;
+        reference.resize(rows * blocks_per_row * motion_block_bytes);
+        for(size_t r=0; r < rows; ++r) {
+            memcpy(&reference[r*blocks_per_row*motion_block_bytes], img.ptr + r*row_step*img.pitch, blocks_per_row*motion_block_bytes);
+        }
+        score = 0.0;
+        return false;
+    }
+
+    const size_t block_threshold = (size_t)(level * motion_block_bytes);
+    size_t changed = 0;
+    for(size_t r=0; r < rows; ++r) {
+        const unsigned char* row = img.ptr + r*row_step*img.pitch;
+        unsigned char* ref = &reference[r*blocks_per_row*motion_block_bytes];
+        for(size_t b=0; b < blocks_per_row; ++b) {
+            if(BlockSad16(row + b*motion_block_bytes, ref + b*motion_block_bytes) > block_threshold) {
+                ++changed;
+            }
+        }
+        memcpy(ref, row, blocks_per_row*motion_block_bytes);
+    }
+
+    const size_t total = rows * blocks_per_row;
+    score = total ? (double)changed / total : 0.0;
+    return score > area;
+}
+
+}
@@ -36,6 +36,10 @@
 #include <pangolin/video/drivers/v4l.h>
 #endif
 
+#ifdef HAVE_POSIX_SHM
+#include <pangolin/video/drivers/shared_memory_video.h>
+#endif
+
 #ifdef HAVE_FFMPEG
 #include <pangolin/video/drivers/ffmpeg.h>
 #endif
@@ -66,6 +70,7 @@
 
 #include <pangolin/utils/file_utils.h>
 #include <pangolin/utils/file_extension.h>
+#include <pangolin/utils/timer.h>
 #include <pangolin/video/drivers/test.h>
 #include <pangolin/video/drivers/images.h>
 #include <pangolin/video/drivers/pvn_video.h>
@@ -76,9 +81,29 @@
 #include <pangolin/video/drivers/unpack.h>
 #include <pangolin/video/drivers/join.h>
 
+#include <sstream>
+
 namespace pangolin
 {
 
+void VideoFrameInfo::Arrived(int64_t device_time_us, int64_t dropped_since_last)
+{
+    this->host_time_us = Time_us(TimeNow());
+    this->device_time_us = device_time_us;
+    this->dropped += dropped_since_last;
+    ++sequence;
+}
+
+void UpdateFrameInfoFromSource(VideoFrameInfo& info, VideoInterface* src)
+{
+    VideoFrameInfoInterface* src_info = dynamic_cast<VideoFrameInfoInterface*>(src);
+    if(src_info) {
+        info = src_info->FrameInfo();
+    }else{
+        info.Arrived();
+    }
+}
+
 std::istream& operator>> (std::istream &is, ImageDim &dim)
 {
     if(std::isdigit(is.peek()) ) {
@@ -348,12 +373,30 @@ VideoInterface* OpenVideo(const Uri& uri)
         const ImageDim dim = uri.Get<ImageDim>("size", ImageDim(640,480));
         const int n = uri.Get<int>("n", 1);
         std::string fmt  = uri.Get<std::string>("fmt","RGB24");        
-        video = new TestVideo(dim.x,dim.y,n,fmt);
+        const TestVideoPattern pattern = TestVideoPatternFromString(uri.Get<std::string>("pattern","random"));
+        const double fps = uri.Get<double>("fps", 0.0);
+        const int64_t jitter_us = uri.Get<int64_t>("jitter", 0);
+        const bool counter = uri.Get<bool>("counter", false);
+        video = new TestVideo(dim.x,dim.y,n,fmt,pattern,fps,jitter_us,counter);
     }else
     // '%' printf specifier used with ffmpeg
     if(!uri.scheme.compare("files") && uri.url.find('%') == std::string::npos)
     {
-        video = new ImagesVideo(uri.url);
+        ImageLoadOptions load_options;
+        load_options.fast_dct = uri.Get<bool>("fast", false);
+
+        // Expect e.g. 1/4
+        std::istringstream scale(uri.Get<std::string>("scale", "1/1"));
+        scale >> load_options.scale_num;
+        if(!scale.eof() && scale.peek() == '/') {
+            scale.get();
+            scale >> load_options.scale_denom;
+        }
+        if(scale.fail() || load_options.scale_num == 0 || load_options.scale_denom == 0) {
+            throw VideoException("files: invalid scale '" + uri.Get<std::string>("scale", "") + "', expected e.g. 1/4");
+        }
+
+        video = new ImagesVideo(uri.url, load_options);
     }else
     if(!uri.scheme.compare("file") || !uri.scheme.compare("pango") || !uri.scheme.compare("pvn") )
     {
@@ -495,6 +538,11 @@ VideoInterface* OpenVideo(const Uri& uri)
         video = new V4lVideo(uri.url.c_str(), method, desired_dim.x, desired_dim.y );
     }else
 #endif // HAVE_V4L
+#ifdef HAVE_POSIX_SHM
+    if(!uri.scheme.compare("shm")) {
+        video = new SharedMemoryVideo(uri.url);
+    }else
+#endif // HAVE_POSIX_SHM
 #ifdef HAVE_DC1394
     if(!uri.scheme.compare("firewire") || !uri.scheme.compare("dc1394") ) {
         std::string desired_format = uri.Get<std::string>("fmt","RGB24");
@@ -678,6 +726,7 @@ VideoInput::~VideoInput()
 void VideoInput::Open(const std::string& sUri)
 {
     uri = ParseUri(sUri);
+    frame_info = VideoFrameInfo();
     
     if(video) {
         delete video;
@@ -690,6 +739,8 @@ void VideoInput::Open(const std::string& sUri)
 
 void VideoInput::Reset()
 {
+    frame_info = VideoFrameInfo();
+
     if(video) {
         delete video;
         video = 0;
@@ -749,13 +800,22 @@ void VideoInput::Stop()
 bool VideoInput::GrabNext( unsigned char* image, bool wait )
 {
     if( !video ) throw VideoException("No video source open");
-    return video->GrabNext(image,wait);
+    const bool success = video->GrabNext(image,wait);
+    if(success) UpdateFrameInfoFromSource(frame_info, video);
+    return success;
 }
 
 bool VideoInput::GrabNewest( unsigned char* image, bool wait )
 {
     if( !video ) throw VideoException("No video source open");
-    return video->GrabNewest(image,wait);
+    const bool success = video->GrabNewest(image,wait);
+    if(success) UpdateFrameInfoFromSource(frame_info, video);
+    return success;
+}
+
+const VideoFrameInfo& VideoInput::FrameInfo() const
+{
+    return frame_info;
 }
 
 bool VideoInput::Grab( unsigned char* buffer, std::vector<Image<unsigned char> >& images, bool wait, bool newest)
@@ -28,11 +28,17 @@
 #include <pangolin/video/video_output.h>
 
 #include <pangolin/video/drivers/pango_video_output.h>
+#include <pangolin/video/drivers/event_video_output.h>
+#include <pangolin/video/drivers/images_video_output.h>
 
 #ifdef HAVE_FFMPEG
 #include <pangolin/video/drivers/ffmpeg.h>
 #endif
 
+#ifdef HAVE_POSIX_SHM
+#include <pangolin/video/drivers/shared_memory_video_output.h>
+#endif
+
 #include <pangolin/utils/file_utils.h>
 
 namespace pangolin
@@ -76,7 +82,40 @@ VideoOutputInterface* OpenVideoOutput(const Uri& uri)
     if(!uri.scheme.compare("pango"))
     {
         const std::string filename = uri.url;
-        recorder = new PangoVideoOutput(filename);
+
+        // codec applies to all streams, codecN to stream N only
+        std::map<size_t,std::string> stream_codecs;
+        for(Params::ParamMap::const_iterator i = uri.params.begin(); i != uri.params.end(); ++i) {
+            if(i->first.size() > 5 && i->first.compare(0, 5, "codec") == 0) {
+                stream_codecs[Convert<size_t,std::string>::Do(i->first.substr(5))] = i->second;
+            }
+        }
+        recorder = new PangoVideoOutput(filename, uri.Get<std::string>("codec",""), stream_codecs, uri, uri.Get<size_t>("alignment", 1));
+    }else
+    if(!uri.scheme.compare("event"))
+    {
+        Uri inner = ParseUri(uri.url);
+        if(inner.scheme == "file") {
+            inner.scheme = "pango";
+        }
+        const MotionDetector detector(
+            uri.Get<double>("level", 16.0),
+            uri.Get<double>("area", 0.01),
+            uri.Get<size_t>("row_step", 4)
+        );
+        recorder = new EventVideoOutput(
+            inner, uri.Get<double>("preroll", 5.0), uri.Get<double>("postroll", 2.0),
+            uri.Get<bool>("motion", true), detector
+        );
+    }else
+    if(!uri.scheme.compare("files"))
+    {
+        ImageWriteOptions options;
+        options.jpeg_quality = uri.Get<int>("quality", options.jpeg_quality);
+        options.png_compression_level = uri.Get<int>("level", options.png_compression_level);
+        recorder = new ImagesVideoOutput(
+            uri.url, uri.Get<size_t>("start", 0), uri.Get<size_t>("pending", 16), options
+        );
     }else
 #ifdef HAVE_FFMPEG    
     if(!uri.scheme.compare("ffmpeg") )
@@ -91,6 +130,13 @@ VideoOutputInterface* OpenVideoOutput(const Uri& uri)
         
         recorder = new FfmpegVideoOutput(filename, desired_frame_rate, desired_bit_rate);
     }else
+#endif
+#ifdef HAVE_POSIX_SHM
+    if(!uri.scheme.compare("shm") )
+    {
+        const size_t slots = uri.Get<size_t>("slots", 4);
+        recorder = new SharedMemoryVideoOutput(uri.url, slots);
+    }else
 #endif
     {
         throw VideoException("Unable to open recorder URI");
@@ -156,5 +202,10 @@ int VideoOutput::WriteStreams(unsigned char* data, const json::value& frame_prop
     return recorder->WriteStreams(data, frame_properties);
 }
 
+int VideoOutput::WriteStreams(unsigned char* data, const json::value& frame_properties, const VideoFrameInfo& frame_info)
+{
+    return recorder->WriteStreams(data, frame_properties, frame_info);
+}
+
 
 }
@@ -0,0 +1,191 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <pangolin/video/video_output_async.h>
+
+#include <algorithm>
+#include <string.h>
+
+namespace pangolin
+{
+
+AsyncVideoOutput::AsyncVideoOutput(VideoOutputInterface* output, size_t queue_depth, AsyncVideoOutputPolicy policy)
+    : output(output), frame_size_bytes(0), depth(std::max(queue_depth, (size_t)1)), policy(policy),
+      max_queued(0), written(0), dropped(0), should_run(false)
+{
+    if(!output) {
+        throw VideoException("AsyncVideoOutput: no output specified");
+    }
+}
+
+AsyncVideoOutput::~AsyncVideoOutput()
+{
+    if(should_run) {
+        {
+            boostd::unique_lock<boostd::mutex> lock(queue_mutex);
+            should_run = false;
+        }
+        cond_pushed.notify_all();
+        write_thread.join();
+    }
+
+    for(size_t i=0; i < queue.size(); ++i) delete queue[i];
+    for(size_t i=0; i < pool.size(); ++i) delete pool[i];
+    delete output;
+}
+
+const std::vector<StreamInfo>& AsyncVideoOutput::Streams() const
+{
+    return output->Streams();
+}
+
+void AsyncVideoOutput::SetStreams(const std::vector<StreamInfo>& streams, const std::string& uri, const json::value& device_properties)
+{
+    if(should_run) {
+        throw std::runtime_error("Unable to add new streams");
+    }
+
+    output->SetStreams(streams, uri, device_properties);
+
+    frame_size_bytes = 0;
+    for(size_t i=0; i<streams.size(); ++i) {
+        frame_size_bytes = std::max(frame_size_bytes, (size_t)streams[i].Offset() + streams[i].SizeBytes());
+    }
+
+    should_run = true;
+    write_thread = boostd::thread(boostd::ref(*this));
+}
+
+int AsyncVideoOutput::WriteStreams(unsigned char* data, const json::value& frame_properties)
+{
+    VideoFrameInfo info;
+    info.Arrived();
+    return WriteStreams(data, frame_properties, info);
+}
+
+int AsyncVideoOutput::WriteStreams(unsigned char* data, const json::value& frame_properties, const VideoFrameInfo& frame_info)
+{
+    if(!should_run) {
+        throw VideoException("AsyncVideoOutput: SetStreams must be called before WriteStreams");
+    }
+
+    QueuedFrame* frame = 0;
+    {
+        boostd::unique_lock<boostd::mutex> lock(queue_mutex);
+
+        if(!error.empty()) {
+            const std::string msg = error;
+            error.clear();
+            throw VideoException("AsyncVideoOutput: error writing frame", msg);
+        }
+
+        if(queue.size() >= depth) {
+            if(policy == AsyncVideoOutputDrop) {
+                ++dropped;
+                return 0;
+            }
+            while(queue.size() >= depth) {
+                cond_popped.wait(lock);
+            }
+        }
+
+        if(!pool.empty()) {
+            frame = pool.back();
+            pool.pop_back();
+        }
+    }
+
+    // Copy outside of lock so writer isn't held up
+    if(!frame) {
+        frame = new QueuedFrame();
+        frame->data.resize(frame_size_bytes);
+    }
+    memcpy(&frame->data[0], data, frame_size_bytes);
+    frame->frame_properties = frame_properties;
+    frame->frame_info = frame_info;
+
+    {
+        boostd::unique_lock<boostd::mutex> lock(queue_mutex);
+        queue.push_back(frame);
+        max_queued = std::max(max_queued, queue.size());
+    }
+    cond_pushed.notify_one();
+
+    return 0;
+}
+
+AsyncVideoOutputStats AsyncVideoOutput::Stats() const
+{
+    boostd::unique_lock<boostd::mutex> lock(queue_mutex);
+    AsyncVideoOutputStats stats;
+    stats.queued = queue.size();
+    stats.max_queued = max_queued;
+    stats.depth = depth;
+    stats.written = written;
+    stats.dropped = dropped;
+    return stats;
+}
+
+void AsyncVideoOutput::operator()()
+{
+    while(true) {
+        QueuedFrame* frame = 0;
+        {
+            boostd::unique_lock<boostd::mutex> lock(queue_mutex);
+            while(queue.empty() && should_run) {
+                cond_pushed.wait(lock);
+            }
+            // Drain remaining frames before exiting
+            if(queue.empty()) {
+                return;
+            }
+            frame = queue.front();
+        }
+
+        std::string frame_error;
+        try {
+            output->WriteStreams(&frame->data[0], frame->frame_properties, frame->frame_info);
+        }catch(const std::exception& e) {
+            frame_error = e.what();
+        }
+
+        {
+            boostd::unique_lock<boostd::mutex> lock(queue_mutex);
+            queue.pop_front();
+            pool.push_back(frame);
+            if(frame_error.empty()) {
+                ++written;
+            }else{
+                error = frame_error;
+            }
+        }
+        cond_popped.notify_all();
+    }
+}
+
+}
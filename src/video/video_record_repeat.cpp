@@ -28,12 +28,14 @@
 #include <pangolin/video/video_record_repeat.h>
 #include <pangolin/video/drivers/pango_video.h>
 #include <pangolin/video/drivers/pango_video_output.h>
+#include <pangolin/video/drivers/event_video_output.h>
 
 namespace pangolin
 {
 
 VideoRecordRepeat::VideoRecordRepeat() 
     : video_src(0), video_src_props(0), video_file(0), video_recorder(0),
+    video_recorder_async(0), record_queue_depth(32), record_policy(AsyncVideoOutputBlock),
     buffer_size_bytes(0), frame_num(0)
 {
 }
@@ -43,6 +45,7 @@ VideoRecordRepeat::VideoRecordRepeat(
     const std::string& output_uri,
     int buffer_size_bytes
     ) : video_src(0), video_src_props(0), video_file(0), video_recorder(0),
+    video_recorder_async(0), record_queue_depth(32), record_policy(AsyncVideoOutputBlock),
     buffer_size_bytes(0), frame_num(0)
 {
     Open(input_uri, output_uri, buffer_size_bytes);
@@ -64,6 +67,12 @@ void VideoRecordRepeat::Open(
         uri_output.scheme = "pango";
     }
 
+    // Event recordings wrap the output which is played back
+    log_filename = uri_output.url;
+    if (uri_output.scheme == "event") {
+        log_filename = ParseUri(uri_output.url).url;
+    }
+
     video_src = OpenVideo(input_uri);
     video_src_props = dynamic_cast<VideoPropertiesInterface*>(video_src);
 }
@@ -73,6 +82,7 @@ void VideoRecordRepeat::Close()
     if (video_recorder) {
         delete video_recorder;
         video_recorder = 0;
+        video_recorder_async = 0;
     }
     if (video_src) {
         delete video_src;
@@ -92,7 +102,7 @@ VideoRecordRepeat::~VideoRecordRepeat()
 
 const std::string& VideoRecordRepeat::LogFilename() const
 {
-    return uri_output.url;
+    return log_filename;
 }
 
 bool VideoRecordRepeat::Grab( unsigned char* buffer, std::vector<Image<unsigned char> >& images, bool wait, bool newest)
@@ -123,6 +133,7 @@ void VideoRecordRepeat::Record()
         video_src->Stop();
         delete video_recorder;
         video_recorder = 0;
+        video_recorder_async = 0;
     }
 
     if(video_file) {
@@ -131,6 +142,11 @@ void VideoRecordRepeat::Record()
     }
 
     video_recorder = OpenVideoOutput(uri_output);
+    if(record_queue_depth > 0) {
+        // Keep slow outputs from stalling capture
+        video_recorder_async = new AsyncVideoOutput(video_recorder, record_queue_depth, record_policy);
+        video_recorder = video_recorder_async;
+    }
     video_recorder->SetStreams(
         video_src->Streams(), str_uri_input, video_src_props ?
             video_src_props->DeviceProperties() : json::value()
@@ -152,11 +168,12 @@ void VideoRecordRepeat::Play(bool realtime)
     if(video_recorder) {
         delete video_recorder;
         video_recorder = 0;
+        video_recorder_async = 0;
     }
 
     video_file = OpenVideo(
-        realtime ? "file:[realtime]//" + uri_output.url :
-                   uri_output.url
+        realtime ? "file:[realtime]//" + log_filename :
+                   log_filename
     );
     video_file_props = dynamic_cast<VideoPropertiesInterface*>(video_file);
 
@@ -173,12 +190,34 @@ void VideoRecordRepeat::Source()
     if(video_recorder) {
         delete video_recorder;
         video_recorder = 0;
+        video_recorder_async = 0;
     }
 
     video_src->Start();
     frame_num = 0;
 }
 
+void VideoRecordRepeat::Trigger()
+{
+    EventVideoOutput* event_recorder = dynamic_cast<EventVideoOutput*>(
+        video_recorder_async ? video_recorder_async->Output() : video_recorder
+    );
+    if(event_recorder) {
+        event_recorder->Trigger();
+    }
+}
+
+void VideoRecordRepeat::SetRecordQueue(size_t queue_depth, AsyncVideoOutputPolicy policy)
+{
+    record_queue_depth = queue_depth;
+    record_policy = policy;
+}
+
+AsyncVideoOutputStats VideoRecordRepeat::RecordStats() const
+{
+    return video_recorder_async ? video_recorder_async->Stats() : AsyncVideoOutputStats();
+}
+
 size_t VideoRecordRepeat::SizeBytes() const
 {
     if( !video_src ) throw VideoException("No video source open");
@@ -202,6 +241,7 @@ void VideoRecordRepeat::Stop()
     if(video_recorder) {
         delete video_recorder;
         video_recorder = 0;
+        video_recorder_async = 0;
     }
 }
 
@@ -212,15 +252,18 @@ bool VideoRecordRepeat::GrabNext( unsigned char* image, bool wait )
     if( video_recorder != 0 ) {
         bool success = video_src->GrabNext(image, wait);
         if( success ) {
+            UpdateFrameInfoFromSource(frame_info, video_src);
             video_recorder->WriteStreams(image, video_src_props ?
-                video_src_props->FrameProperties() : json::value()
+                video_src_props->FrameProperties() : json::value(),
+                frame_info
             );
         }
         return success;
-    }else if( video_file != 0 ) {
-        return video_file->GrabNext(image,wait);
     }else{
-        return video_src->GrabNext(image,wait);
+        VideoInterface* video = video_file ? video_file : video_src;
+        const bool success = video->GrabNext(image,wait);
+        if(success) UpdateFrameInfoFromSource(frame_info, video);
+        return success;
     }
 }
 
@@ -232,15 +275,18 @@ bool VideoRecordRepeat::GrabNewest( unsigned char* image, bool wait )
     {
         bool success = video_src->GrabNewest(image,wait);
         if( success ) {
+            UpdateFrameInfoFromSource(frame_info, video_src);
             video_recorder->WriteStreams(image, video_src_props ?
-                video_src_props->FrameProperties() : json::value()
+                video_src_props->FrameProperties() : json::value(),
+                frame_info
             );
         }
         return success;
-    }else if( video_file != 0 ) {
-        return video_file->GrabNewest(image,wait);
     }else{
-        return video_src->GrabNewest(image,wait);
+        VideoInterface* video = video_file ? video_file : video_src;
+        const bool success = video->GrabNewest(image,wait);
+        if(success) UpdateFrameInfoFromSource(frame_info, video);
+        return success;
     }
 }
 
@@ -262,6 +308,11 @@ const json::value& VideoRecordRepeat::FrameProperties() const
     }
 }
 
+const VideoFrameInfo& VideoRecordRepeat::FrameInfo() const
+{
+    return frame_info;
+}
+
 int VideoRecordRepeat::FrameId()
 {
     return frame_num;
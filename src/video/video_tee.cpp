@@ -0,0 +1,341 @@
+/* This file is part of the Pangolin Project.
+ * http://github.com/stevenlovegrove/Pangolin
+ *
+ * Copyright (c) 2014 Steven Lovegrove
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <pangolin/video/video_tee.h>
+
+#include <algorithm>
+#include <string.h>
+
+namespace pangolin
+{
+
+VideoTeeConsumer::VideoTeeConsumer(VideoTee* tee, size_t depth, VideoTeePolicy policy)
+    : link(tee->link), streams(tee->src->Streams()), size_bytes(tee->src->SizeBytes()),
+      depth(std::max(depth, (size_t)1)), policy(policy),
+      receiving(true), closed(false), dropped(0)
+{
+}
+
+VideoTeeConsumer::~VideoTeeConsumer()
+{
+    boostd::unique_lock<boostd::mutex> link_lock(link->mutex);
+    if(link->tee) {
+        link->tee->RemoveConsumer(this);
+    }
+}
+
+size_t VideoTeeConsumer::SizeBytes() const
+{
+    return size_bytes;
+}
+
+const std::vector<StreamInfo>& VideoTeeConsumer::Streams() const
+{
+    return streams;
+}
+
+void VideoTeeConsumer::Start()
+{
+    boostd::unique_lock<boostd::mutex> lock(queue_mutex);
+    receiving = true;
+}
+
+void VideoTeeConsumer::Stop()
+{
+    {
+        boostd::unique_lock<boostd::mutex> lock(queue_mutex);
+        receiving = false;
+        queue.clear();
+    }
+    NotifyTee();
+}
+
+bool VideoTeeConsumer::GrabNext( unsigned char* image, bool wait )
+{
+    VideoTeeFramePtr frame = Next(wait);
+    if(frame) {
+        memcpy(image, &frame->data[0], size_bytes);
+        return true;
+    }
+    return false;
+}
+
+bool VideoTeeConsumer::GrabNewest( unsigned char* image, bool wait )
+{
+    VideoTeeFramePtr frame = Newest(wait);
+    if(frame) {
+        memcpy(image, &frame->data[0], size_bytes);
+        return true;
+    }
+    return false;
+}
+
+const VideoFrameInfo& VideoTeeConsumer::FrameInfo() const
+{
+    return frame_info;
+}
+
+VideoTeeFramePtr VideoTeeConsumer::Next(bool wait)
+{
+    VideoTeeFramePtr frame;
+    {
+        boostd::unique_lock<boostd::mutex> lock(queue_mutex);
+        while(queue.empty() && wait && !closed) {
+            cond_pushed.wait(lock);
+        }
+        if(queue.empty()) {
+            return frame;
+        }
+        frame = queue.front();
+        queue.pop_front();
+        frame_info = frame->info;
+        frame_info.dropped += dropped;
+    }
+    NotifyTee();
+    return frame;
+}
+
+VideoTeeFramePtr VideoTeeConsumer::Newest(bool wait)
+{
+    VideoTeeFramePtr frame;
+    {
+        boostd::unique_lock<boostd::mutex> lock(queue_mutex);
+        while(queue.empty() && wait && !closed) {
+            cond_pushed.wait(lock);
+        }
+        if(queue.empty()) {
+            return frame;
+        }
+        frame = queue.back();
+        queue.clear();
+        frame_info = frame->info;
+        frame_info.dropped += dropped;
+    }
+    NotifyTee();
+    return frame;
+}
+
+int64_t VideoTeeConsumer::Dropped() const
+{
+    boostd::unique_lock<boostd::mutex> lock(queue_mutex);
+    return dropped;
+}
+
+bool VideoTeeConsumer::Full() const
+{
+    boostd::unique_lock<boostd::mutex> lock(queue_mutex);
+    return policy == VideoTeeBlock && receiving && queue.size() >= depth;
+}
+
+void VideoTeeConsumer::Push(const VideoTeeFramePtr& frame)
+{
+    {
+        boostd::unique_lock<boostd::mutex> lock(queue_mutex);
+        if(!receiving) {
+            return;
+        }
+
+        if(policy == VideoTeeNewestOnly) {
+            dropped += queue.size();
+            queue.clear();
+        }else if(policy == VideoTeeDropOldest) {
+            while(queue.size() >= depth) {
+                queue.pop_front();
+                ++dropped;
+            }
+        }
+        // VideoTeeBlock: tee has already waited for space
+
+        queue.push_back(frame);
+    }
+    cond_pushed.notify_all();
+}
+
+void VideoTeeConsumer::Close()
+{
+    {
+        boostd::unique_lock<boostd::mutex> lock(queue_mutex);
+        closed = true;
+    }
+    cond_pushed.notify_all();
+}
+
+void VideoTeeConsumer::NotifyTee()
+{
+    if(policy == VideoTeeBlock) {
+        // Hold link so that the tee can't be destroyed mid notification
+        boostd::unique_lock<boostd::mutex> link_lock(link->mutex);
+        if(link->tee) {
+            // Take tee lock so that notification can't slip in between tee
+            // testing for space and waiting.
+            boostd::unique_lock<boostd::mutex> lock(link->tee->consumers_mutex);
+            link->tee->cond_space.notify_all();
+        }
+    }
+}
+
+VideoTee::VideoTee(VideoInterface* src)
+    : src(src), link(new VideoTeeLink(this)), should_run(false), running(false)
+{
+    if(!src) {
+        throw VideoException("VideoTee: source video interface not specified");
+    }
+}
+
+VideoTee::~VideoTee()
+{
+    Stop();
+
+    {
+        boostd::unique_lock<boostd::mutex> lock(consumers_mutex);
+        for(size_t i=0; i < consumers.size(); ++i) {
+            consumers[i]->Close();
+        }
+    }
+
+    // Detach remaining consumers. Taking the link waits for any consumer
+    // part way through notifying or removing itself, and consumers being
+    // destroyed until now have removed themselves from the list.
+    {
+        boostd::unique_lock<boostd::mutex> link_lock(link->mutex);
+        link->tee = 0;
+    }
+    consumers.clear();
+
+    delete src;
+}
+
+VideoTeeConsumer* VideoTee::AddConsumer(size_t queue_depth, VideoTeePolicy policy)
+{
+    VideoTeeConsumer* consumer = new VideoTeeConsumer(this, queue_depth, policy);
+    boostd::unique_lock<boostd::mutex> lock(consumers_mutex);
+    consumers.push_back(consumer);
+    return consumer;
+}
+
+void VideoTee::RemoveConsumer(VideoTeeConsumer* consumer)
+{
+    boostd::unique_lock<boostd::mutex> lock(consumers_mutex);
+    consumers.erase(std::remove(consumers.begin(), consumers.end(), consumer), consumers.end());
+    cond_space.notify_all();
+}
+
+void VideoTee::Start()
+{
+    if(!running) {
+        {
+            boostd::unique_lock<boostd::mutex> lock(consumers_mutex);
+            for(size_t i=0; i < consumers.size(); ++i) {
+                boostd::unique_lock<boostd::mutex> qlock(consumers[i]->queue_mutex);
+                consumers[i]->closed = false;
+            }
+            should_run = true;
+        }
+        src->Start();
+        running = true;
+        capture_thread = boostd::thread(boostd::ref(*this));
+    }
+}
+
+void VideoTee::Stop()
+{
+    if(running) {
+        {
+            boostd::unique_lock<boostd::mutex> lock(consumers_mutex);
+            should_run = false;
+            cond_space.notify_all();
+        }
+        // Stop source first so that a capture thread waiting on it returns
+        src->Stop();
+        capture_thread.join();
+        running = false;
+    }
+}
+
+boostd::shared_ptr<VideoTeeFrame> VideoTee::FreeFrame()
+{
+    // A frame is free once only the pool references it
+    for(size_t i=0; i < pool.size(); ++i) {
+        if(pool[i].use_count() == 1) {
+            return pool[i];
+        }
+    }
+
+    boostd::shared_ptr<VideoTeeFrame> frame(new VideoTeeFrame());
+    frame->data.resize(src->SizeBytes());
+    pool.push_back(frame);
+    return frame;
+}
+
+void VideoTee::operator()()
+{
+    while(true) {
+        {
+            boostd::unique_lock<boostd::mutex> lock(consumers_mutex);
+            if(!should_run) break;
+        }
+
+        boostd::shared_ptr<VideoTeeFrame> frame = FreeFrame();
+
+        if(!src->GrabNext(&frame->data[0], true)) {
+            break;
+        }
+        UpdateFrameInfoFromSource(src_info, src);
+        frame->info = src_info;
+
+        boostd::unique_lock<boostd::mutex> lock(consumers_mutex);
+
+        // Wait until every blocking consumer has room
+        while(should_run) {
+            bool full = false;
+            for(size_t i=0; i < consumers.size() && !full; ++i) {
+                full = consumers[i]->Full();
+            }
+            if(!full) break;
+            cond_space.wait(lock);
+        }
+
+        if(!should_run) {
+            break;
+        }
+
+        const VideoTeeFramePtr shared_frame = frame;
+        frame.reset();
+        for(size_t i=0; i < consumers.size(); ++i) {
+            consumers[i]->Push(shared_frame);
+        }
+    }
+
+    // Source has ended or tee was stopped. Let consumers drain their queues
+    // rather than wait for frames which won't come.
+    boostd::unique_lock<boostd::mutex> lock(consumers_mutex);
+    for(size_t i=0; i < consumers.size(); ++i) {
+        consumers[i]->Close();
+    }
+}
+
+}
@@ -0,0 +1,34 @@
+#include "test.h"
+
+#include <iostream>
+
+int main( int argc, char* argv[] )
+{
+    // Optional arguments select tests by name
+    std::vector<pangolin::TestEntry>& tests = pangolin::Tests();
+
+    size_t run = 0;
+    size_t failed = 0;
+    for(size_t i=0; i < tests.size(); ++i) {
+        bool selected = (argc <= 1);
+        for(int a=1; a < argc; ++a) {
+            selected |= tests[i].name == argv[a];
+        }
+        if(selected) {
+            ++run;
+            try {
+                tests[i].func();
+                std::cout << "PASS " << tests[i].name << std::endl;
+            }catch(const std::exception& e) {
+                std::cout << "FAIL " << tests[i].name << ": " << e.what() << std::endl;
+                ++failed;
+            }
+        }
+    }
+
+    if(run == 0) {
+        std::cerr << "No tests selected." << std::endl;
+        return -1;
+    }
+    return failed ? 1 : 0;
+}
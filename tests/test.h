@@ -0,0 +1,71 @@
+#ifndef PANGOLIN_TEST_H
+#define PANGOLIN_TEST_H
+
+#include <pangolin/platform.h>
+
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace pangolin
+{
+
+typedef void (*TestFunction)();
+
+struct TestEntry
+{
+    std::string name;
+    TestFunction func;
+};
+
+inline std::vector<TestEntry>& Tests()
+{
+    static std::vector<TestEntry> tests;
+    return tests;
+}
+
+struct TestRegistrar
+{
+    TestRegistrar(const std::string& name, TestFunction func)
+    {
+        TestEntry e = {name, func};
+        Tests().push_back(e);
+    }
+};
+
+//! Thrown by PANGOLIN_CHECK to fail the running test
+inline void TestFailure(const char* file, int line, const std::string& what)
+{
+    std::ostringstream ss;
+    ss << file << ":" << line << ": " << what;
+    throw std::runtime_error(ss.str());
+}
+
+//! Temporary file in working directory, removed on destruction
+struct TestTempFile
+{
+    TestTempFile(const std::string& name) : filename("pangolin_test_" + name) {}
+    ~TestTempFile() { std::remove(filename.c_str()); }
+    std::string filename;
+};
+
+}
+
+#define PANGOLIN_TEST(name) \
+    static void name(); \
+    static pangolin::TestRegistrar name##_registrar(#name, name); \
+    static void name()
+
+#define PANGOLIN_CHECK(cond) \
+    do { if(!(cond)) pangolin::TestFailure(__FILE__, __LINE__, "check failed: " #cond); } while(0)
+
+#define PANGOLIN_CHECK_EQUAL(a, b) \
+    do { if(!((a) == (b))) { \
+        std::ostringstream pangolin_check_ss; \
+        pangolin_check_ss << "check failed: " #a " == " #b " (" << (a) << " vs " << (b) << ")"; \
+        pangolin::TestFailure(__FILE__, __LINE__, pangolin_check_ss.str()); \
+    } } while(0)
+
+#endif // PANGOLIN_TEST_H
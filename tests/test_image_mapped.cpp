@@ -0,0 +1,90 @@
+#include "test.h"
+
+#include <pangolin/image/image_io.h>
+#include <pangolin/image/image_mapped.h>
+
+#include <cstring>
+
+using namespace pangolin;
+
+// Image whose pixel values are their index, in fmt
+TypedImage IndexImage(size_t w, size_t h, const std::string& fmt)
+{
+    TypedImage img;
+    img.Alloc(w, h, VideoFormatFromString(fmt));
+    for(size_t y=0; y < h; ++y) {
+        for(size_t x=0; x < w; ++x) {
+            const size_t i = y*w + x;
+            unsigned char* p = img.RowPtr((int)y);
+            if(fmt == "GRAY8") p[x] = (unsigned char)i;
+            else if(fmt == "GRAY16LE") ((uint16_t*)p)[x] = (uint16_t)(i * 257);
+            else if(fmt == "GRAY32F") ((float*)p)[x] = i * 0.5f;
+        }
+    }
+    return img;
+}
+
+bool SamePixels(const Image<unsigned char>& a, const Image<unsigned char>& b, size_t row_bytes)
+{
+    if(a.w != b.w || a.h != b.h) return false;
+    for(size_t y=0; y < a.h; ++y) {
+        if(std::memcmp(a.ptr + y*a.pitch, b.ptr + y*b.pitch, row_bytes)) return false;
+    }
+    return true;
+}
+
+// Save as PGM / PFM, then check that it loads and maps back unchanged
+void CheckRoundTrip(const std::string& fmt, size_t w, size_t h, bool expect_mapped)
+{
+    TestTempFile file(fmt + (fmt == "GRAY32F" ? ".pfm" : ".pgm"));
+    TypedImage img = IndexImage(w, h, fmt);
+    const size_t row_bytes = w * img.fmt.bpp / 8;
+    SavePpm(img, img.fmt, file.filename);
+
+    TypedImage loaded = LoadImage(file.filename);
+    PANGOLIN_CHECK_EQUAL(loaded.fmt.format, fmt);
+    PANGOLIN_CHECK(SamePixels(img, loaded, row_bytes));
+    loaded.Dealloc();
+
+    MappedImage mapped(file.filename);
+    PANGOLIN_CHECK_EQUAL(mapped.IsMapped(), expect_mapped);
+    PANGOLIN_CHECK_EQUAL(mapped.fmt.format, fmt);
+    PANGOLIN_CHECK_EQUAL((size_t)mapped.ptr % (img.fmt.channel_bits[0] / 8), 0u);
+
+    // PFM is stored bottom line first, which the mapping exposes
+    TypedImage flipped;
+    flipped.Alloc(w, h, img.fmt);
+    for(size_t y=0; y < h; ++y) {
+        std::memcpy(flipped.RowPtr((int)y), mapped.RowPtr((int)(mapped.top_line_first ? y : h - 1 - y)), row_bytes);
+    }
+    PANGOLIN_CHECK(SamePixels(img, flipped, row_bytes));
+    flipped.Dealloc();
+    img.Dealloc();
+}
+
+PANGOLIN_TEST(image_mapped_round_trip)
+{
+    // Headers "P5\n4 3\n255\n" and "Pf\n4 3\n-1.0\n" leave pixels aligned
+    CheckRoundTrip("GRAY8", 4, 3, true);
+#ifndef _WIN_
+    CheckRoundTrip("GRAY32F", 4, 3, true);
+#endif
+
+    // "Pf\n10 3\n-1.0\n" doesn't, so the floats are copied to be aligned
+    CheckRoundTrip("GRAY32F", 10, 3, false);
+
+    // 16 bit PGM is big endian, so is swapped into a copy on little endian hosts
+    const uint16_t one = 1;
+    CheckRoundTrip("GRAY16LE", 5, 7, *(const unsigned char*)&one == 0);
+}
+
+PANGOLIN_TEST(image_ppm_load_errors_throw)
+{
+    bool threw = false;
+    try {
+        LoadPpm("pangolin_test_missing.pgm");
+    }catch(const std::runtime_error& e) {
+        threw = std::string(e.what()).find("pangolin_test_missing.pgm") != std::string::npos;
+    }
+    PANGOLIN_CHECK(threw);
+}
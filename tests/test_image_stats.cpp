@@ -0,0 +1,54 @@
+#include "test.h"
+
+#include <pangolin/image/image_stats.h>
+
+#include <cmath>
+#include <limits>
+
+using namespace pangolin;
+
+PANGOLIN_TEST(image_stats_non_finite)
+{
+    // Odd width so that pixels go through both vector and scalar paths
+    const size_t w = 11, h = 3;
+    const float inf = std::numeric_limits<float>::infinity();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    std::vector<float> data(w*h);
+    for(size_t i=0; i < data.size(); ++i) {
+        data[i] = (float)(i % 5);
+    }
+    data[0] = inf;
+    data[3] = -inf;
+    data[6] = nan;
+    data[w-1] = inf;
+    data[w+2] = -inf;
+    data[2*w+9] = nan;
+    Image<float> img(w, h, w*sizeof(float), &data[0]);
+
+    size_t count = 0;
+    double sum = 0;
+    for(size_t i=0; i < data.size(); ++i) {
+        if(data[i] - data[i] == 0) {
+            ++count;
+            sum += data[i];
+        }
+    }
+
+    const ImageStats stats = GetImageStats(img);
+    PANGOLIN_CHECK_EQUAL(stats.count, count);
+    PANGOLIN_CHECK_EQUAL(stats.min, 0.0);
+    PANGOLIN_CHECK_EQUAL(stats.max, 4.0);
+    PANGOLIN_CHECK(std::fabs(stats.mean - sum / count) < 1e-9);
+
+    ImageHistogram hist;
+    GetImageHistogram(hist, img, 0.0, 5.0, 5);
+    PANGOLIN_CHECK_EQUAL(hist.count, count);
+
+    // Infinite bounds must not produce invalid bins
+    GetImageHistogram(hist, img, -inf, inf, 4);
+    PANGOLIN_CHECK_EQUAL(hist.count, count);
+
+    const std::pair<double,double> range = GetImagePercentiles(img, 0.0, 1.0);
+    PANGOLIN_CHECK_EQUAL(range.first, 0.0);
+    PANGOLIN_CHECK_EQUAL(range.second, 4.0);
+}
@@ -0,0 +1,51 @@
+#include "test.h"
+
+#include <pangolin/image/image_io.h>
+#include <pangolin/image/image_writer.h>
+#include <pangolin/utils/file_utils.h>
+
+#include <algorithm>
+
+using namespace pangolin;
+
+PANGOLIN_TEST(image_writer_same_filename)
+{
+    TestTempFile file("same.png");
+    const VideoPixelFormat fmt = VideoFormatFromString("GRAY8");
+    const size_t w = 1024, h = 1024;
+    const size_t num_images = 16;
+
+    // Incompressible images, so that writes take long enough to overlap
+    std::vector<std::vector<unsigned char> > images(num_images, std::vector<unsigned char>(w*h));
+    for(size_t i=0; i < num_images; ++i) {
+        uint32_t x = 2463534242u + (uint32_t)i;
+        for(size_t p=0; p < w*h; ++p) {
+            x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+            images[i][p] = (unsigned char)x;
+        }
+    }
+
+    // Concurrent saves to one file must leave exactly one of the images
+    ImageWriter writer(num_images);
+    for(size_t i=0; i < num_images; ++i) {
+        TypedImage img;
+        img.Alloc(w, h, fmt);
+        std::copy(images[i].begin(), images[i].end(), img.ptr);
+        writer.Save(img, file.filename);
+    }
+    writer.Wait();
+
+    TypedImage saved = LoadImage(file.filename);
+    const bool valid = saved.w == w && saved.h == h && saved.pitch == w;
+    bool matched = false;
+    for(size_t i=0; valid && i < num_images; ++i) {
+        matched |= std::equal(images[i].begin(), images[i].end(), saved.ptr);
+    }
+    saved.Dealloc();
+    PANGOLIN_CHECK(valid);
+    PANGOLIN_CHECK(matched);
+
+    std::vector<std::string> temp_files;
+    FilesMatchingWildcard(file.filename + ".*.tmp", temp_files);
+    PANGOLIN_CHECK(temp_files.empty());
+}
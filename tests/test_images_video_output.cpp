@@ -0,0 +1,95 @@
+#include "test.h"
+
+#include <pangolin/video/drivers/images_video_output.h>
+#include <pangolin/image/image_io.h>
+
+#include <cstdio>
+
+using namespace pangolin;
+
+// Removes listed files on destruction
+struct TestTempFiles
+{
+    ~TestTempFiles() {
+        for(size_t i=0; i < filenames.size(); ++i) std::remove(filenames[i].c_str());
+    }
+    std::vector<std::string> filenames;
+};
+
+// True if pattern is rejected with VideoException
+bool PatternThrows(const std::string& pattern)
+{
+    try {
+        FormatFrameFilename(pattern, 0);
+    }catch(const VideoException&) {
+        return true;
+    }
+    return false;
+}
+
+PANGOLIN_TEST(images_frame_filename)
+{
+    PANGOLIN_CHECK_EQUAL(FormatFrameFilename("frame_%d.png", 42), "frame_42.png");
+    PANGOLIN_CHECK_EQUAL(FormatFrameFilename("frame_%06d.png", 42), "frame_000042.png");
+    PANGOLIN_CHECK_EQUAL(FormatFrameFilename("frame_%6d.png", 42), "frame_    42.png");
+    PANGOLIN_CHECK_EQUAL(FormatFrameFilename("frame_%03u.png", 1234), "frame_1234.png");
+    PANGOLIN_CHECK_EQUAL(FormatFrameFilename("%i", 7), "7");
+    PANGOLIN_CHECK_EQUAL(FormatFrameFilename("100%%/%02d.png", 3), "100%/03.png");
+
+    PANGOLIN_CHECK(PatternThrows("frame.png"));
+    PANGOLIN_CHECK(PatternThrows("frame_%%.png"));
+    PANGOLIN_CHECK(PatternThrows("frame_%d_%d.png"));
+    PANGOLIN_CHECK(PatternThrows("frame_%s.png"));
+    PANGOLIN_CHECK(PatternThrows("frame_%06.png"));
+    PANGOLIN_CHECK(PatternThrows("frame_%"));
+}
+
+PANGOLIN_TEST(images_output_round_trip)
+{
+    const size_t w = 16, h = 8;
+    const size_t num_frames = 3;
+    const VideoPixelFormat fmt = VideoFormatFromString("GRAY8");
+
+    // Two streams, packed one after the other
+    std::vector<StreamInfo> streams;
+    streams.push_back(StreamInfo(fmt, w, h, w, (unsigned char*)0));
+    streams.push_back(StreamInfo(fmt, w, h, w, (unsigned char*)0 + w*h));
+    std::vector<unsigned char> frame(2*w*h);
+
+    const char* names[] = {"left", "right"};
+    TestTempFiles files;
+    for(size_t f=0; f < num_frames; ++f) {
+        for(size_t s=0; s < 2; ++s) {
+            files.filenames.push_back(FormatFrameFilename(std::string("pangolin_test_images_") + names[s] + "_%03d.pgm", 10 + f));
+        }
+    }
+
+    {
+        ImagesVideoOutput output("pangolin_test_images_[left,right]_%03d.pgm", 10, 2);
+        output.SetStreams(streams, "", json::value());
+        for(size_t f=0; f < num_frames; ++f) {
+            for(size_t i=0; i < frame.size(); ++i) {
+                frame[i] = (unsigned char)(f + i);
+            }
+            output.WriteStreams(&frame[0], json::value());
+        }
+        output.Flush();
+        PANGOLIN_CHECK_EQUAL(output.NextFrame(), 10 + num_frames);
+    }
+
+    for(size_t f=0; f < num_frames; ++f) {
+        for(size_t s=0; s < 2; ++s) {
+            TypedImage img = LoadImage(files.filenames[f*2 + s]);
+            PANGOLIN_CHECK_EQUAL(img.w, w);
+            PANGOLIN_CHECK_EQUAL(img.h, h);
+            bool same = true;
+            for(size_t y=0; y < h; ++y) {
+                for(size_t x=0; x < w; ++x) {
+                    same = same && img.RowPtr((int)y)[x] == (unsigned char)(f + s*w*h + y*w + x);
+                }
+            }
+            img.Dealloc();
+            PANGOLIN_CHECK(same);
+        }
+    }
+}
@@ -0,0 +1,236 @@
+#include "test.h"
+
+#include <pangolin/log/packetstream.h>
+#include <pangolin/compat/thread.h>
+
+#include <cstring>
+
+using namespace pangolin;
+
+// Reader which exposes its file position, to check payload alignment
+class PositionedPacketStreamReader : public PacketStreamReader
+{
+public:
+    PositionedPacketStreamReader(const std::string& filename)
+        : PacketStreamReader(filename, false)
+    {
+    }
+
+    std::streamoff Position() { return reader.tellg(); }
+};
+
+// Repeatable payload for packet i
+std::vector<char> TestPayload(size_t i, size_t n)
+{
+    std::vector<char> data(n);
+    for(size_t b=0; b < n; ++b) {
+        data[b] = (char)(i * 31 + b);
+    }
+    return data;
+}
+
+std::vector<char> ReadPacket(PacketStreamReader& reader, PacketStreamSourceId src)
+{
+    std::vector<char> data(reader.PacketSizeBytes());
+    if(data.size()) reader.Read(&data[0], data.size());
+    reader.ReleaseSourcePacketLock(src);
+    return data;
+}
+
+PANGOLIN_TEST(packetstream_alignment)
+{
+    TestTempFile file("aligned.pango");
+    const size_t num_packets = 50;
+    const size_t fixed_bytes = 24;
+
+    // Variable size packets aligned to pages, interleaved with small ones
+    PacketStreamSourceId var_src, fixed_src;
+    {
+        PacketStreamWriter writer(file.filename);
+        var_src = writer.AddSource("test_var", "test://", json::value(), 0, "", 4096);
+        fixed_src = writer.AddSource("test_fixed", "test://", json::value(), fixed_bytes, "", 16);
+        for(size_t i=0; i < num_packets; ++i) {
+            const std::vector<char> var = TestPayload(i, 1 + i*97);
+            const std::vector<char> fixed = TestPayload(i, fixed_bytes);
+            writer.WriteSourcePacket(var_src, &var[0], var.size());
+            writer.WriteSourcePacket(fixed_src, &fixed[0], fixed.size());
+        }
+    }
+
+    PositionedPacketStreamReader reader(file.filename);
+    PANGOLIN_CHECK_EQUAL(reader.Sources()[var_src].data_alignment_bytes, 4096);
+    PANGOLIN_CHECK_EQUAL(reader.Sources()[fixed_src].data_alignment_bytes, 16);
+    for(size_t i=0; i < num_packets; ++i) {
+        PANGOLIN_CHECK(reader.ReadToSourcePacketAndLock(var_src));
+        PANGOLIN_CHECK_EQUAL(reader.Position() % 4096, 0);
+        PANGOLIN_CHECK(ReadPacket(reader, var_src) == TestPayload(i, 1 + i*97));
+
+        PANGOLIN_CHECK(reader.ReadToSourcePacketAndLock(fixed_src));
+        PANGOLIN_CHECK_EQUAL(reader.Position() % 16, 0);
+        PANGOLIN_CHECK(ReadPacket(reader, fixed_src) == TestPayload(i, fixed_bytes));
+    }
+    PANGOLIN_CHECK(!reader.ReadToSourcePacketAndLock(var_src));
+}
+
+// Writes numbered packets of varying size, tagged with producer
+struct PacketProducer
+{
+    PacketStreamWriter* writer;
+    PacketStreamSourceId src;
+    uint32_t producer;
+    uint32_t num_packets;
+
+    void operator()() const
+    {
+        for(uint32_t i=0; i < num_packets; ++i) {
+            std::vector<char> data = TestPayload(producer + i, 8 + (i % 13) * 100);
+            std::memcpy(&data[0], &producer, sizeof(uint32_t));
+            std::memcpy(&data[4], &i, sizeof(uint32_t));
+            writer->WriteSourcePacket(src, &data[0], data.size());
+        }
+    }
+};
+
+void CheckConcurrentProducers(int64_t reorder_window_us)
+{
+    TestTempFile file("producers.pango");
+    const uint32_t num_producers = 4;
+    const uint32_t num_packets = 500;
+
+    PacketStreamSourceId src;
+    {
+        PacketStreamWriter writer(file.filename);
+        writer.SetReorderWindow_us(reorder_window_us);
+        src = writer.AddSource("test", "test://", json::value(), 0, "", 8);
+
+        std::vector<boostd::thread> threads;
+        for(uint32_t p=0; p < num_producers; ++p) {
+            PacketProducer producer = {&writer, src, p, num_packets};
+            threads.push_back(boostd::thread(producer));
+        }
+        for(size_t t=0; t < threads.size(); ++t) {
+            threads[t].join();
+        }
+    }
+
+    // Every packet intact, and each producer's in the order written
+    PacketStreamReader reader(file.filename, false);
+    std::vector<uint32_t> next(num_producers, 0);
+    size_t packets = 0;
+    while(reader.ReadToSourcePacketAndLock(src)) {
+        const std::vector<char> data = ReadPacket(reader, src);
+        PANGOLIN_CHECK(data.size() >= 8);
+        uint32_t producer, i;
+        std::memcpy(&producer, &data[0], sizeof(uint32_t));
+        std::memcpy(&i, &data[4], sizeof(uint32_t));
+        PANGOLIN_CHECK(producer < num_producers);
+        PANGOLIN_CHECK_EQUAL(i, next[producer]);
+        std::vector<char> expected = TestPayload(producer + i, 8 + (i % 13) * 100);
+        std::memcpy(&expected[0], &data[0], 8);
+        PANGOLIN_CHECK(data == expected);
+        ++next[producer];
+        ++packets;
+    }
+    PANGOLIN_CHECK_EQUAL(packets, (size_t)num_producers * num_packets);
+}
+
+PANGOLIN_TEST(packetstream_concurrent_producers)
+{
+    CheckConcurrentProducers(0);
+    CheckConcurrentProducers(1000);
+}
+
+struct TestSample
+{
+    int64_t time_us;
+    float value[3];
+    uint8_t flags;
+};
+
+// Same size as TestSample, but laid out differently
+struct OtherSample
+{
+    int64_t time_us;
+    uint8_t flags;
+    float value[3];
+};
+
+namespace pangolin
+{
+template<> struct PacketTraits<TestSample> {
+    static const char* Name() { return "TestSample"; }
+    static void Describe(PacketFieldList<TestSample>& f) {
+        f.Field("time_us", &TestSample::time_us)
+         .Field("value", &TestSample::value)
+         .Field("flags", &TestSample::flags);
+    }
+};
+
+template<> struct PacketTraits<OtherSample> {
+    static const char* Name() { return "OtherSample"; }
+    static void Describe(PacketFieldList<OtherSample>& f) {
+        f.Field("time_us", &OtherSample::time_us)
+         .Field("flags", &OtherSample::flags)
+         .Field("value", &OtherSample::value);
+    }
+};
+}
+
+PANGOLIN_TEST(packetstream_typed_packets)
+{
+    TestTempFile file("typed.pango");
+    const int num_packets = 10;
+
+    PacketStreamSourceId typed_src, raw_src;
+    {
+        PacketStreamWriter writer(file.filename);
+        typed_src = writer.AddSource<TestSample>("test_typed", "test://");
+        raw_src = writer.AddSource("test_raw", "test://", json::value(), sizeof(TestSample));
+        for(int i=0; i < num_packets; ++i) {
+            TestSample s;
+            std::memset(&s, 0, sizeof(s));
+            s.time_us = i * 1000;
+            s.value[0] = i * 0.5f; s.value[1] = -i; s.value[2] = 1.0f / (i+1);
+            s.flags = (uint8_t)i;
+            writer.Write(typed_src, s);
+            writer.Write(raw_src, s);
+        }
+    }
+
+    PacketStreamReader reader(file.filename, false);
+    PANGOLIN_CHECK_EQUAL(reader.Sources()[typed_src].data_definitions, PacketDefinitions<TestSample>());
+    for(int i=0; i < num_packets; ++i) {
+        PANGOLIN_CHECK(reader.ReadToSourcePacketAndLock(typed_src));
+        const TestSample* s = reader.ReadAs<TestSample>();
+        reader.ReleaseSourcePacketLock(typed_src);
+        PANGOLIN_CHECK_EQUAL(s->time_us, i * 1000);
+        PANGOLIN_CHECK_EQUAL(s->value[0], i * 0.5f);
+        PANGOLIN_CHECK_EQUAL(s->value[1], (float)-i);
+        PANGOLIN_CHECK_EQUAL(s->value[2], 1.0f / (i+1));
+        PANGOLIN_CHECK_EQUAL((int)s->flags, i);
+    }
+
+    // Packets must be read as the type they were written as
+    PacketStreamReader other(file.filename, false);
+    PANGOLIN_CHECK(other.ReadToSourcePacketAndLock(typed_src));
+    bool threw = false;
+    try {
+        other.ReadAs<OtherSample>();
+    }catch(const std::runtime_error&) {
+        threw = true;
+    }
+    // A rejected packet is left unread
+    other.Skip(other.PacketSizeBytes());
+    other.ReleaseSourcePacketLock(typed_src);
+    PANGOLIN_CHECK(threw);
+
+    PANGOLIN_CHECK(other.ReadToSourcePacketAndLock(raw_src));
+    threw = false;
+    try {
+        other.ReadAs<TestSample>();
+    }catch(const std::runtime_error&) {
+        threw = true;
+    }
+    other.ReleaseSourcePacketLock(raw_src);
+    PANGOLIN_CHECK(threw);
+}
@@ -0,0 +1,106 @@
+#include "test.h"
+
+#include <pangolin/log/packetstream.h>
+#include <pangolin/video/video.h>
+#include <pangolin/video/video_output.h>
+#include <pangolin/compat/memory.h>
+#include <pangolin/compat/thread.h>
+
+#include <cstdlib>
+
+using namespace pangolin;
+
+// Path of PangoMerge tool under test, from the environment
+std::string PangoMergeExecutable()
+{
+    const char* exe = std::getenv("PANGOMERGE");
+    if(!exe) {
+        throw std::runtime_error("PANGOMERGE must name the PangoMerge executable.");
+    }
+    return exe;
+}
+
+const size_t num_frames = 20;
+
+// Record delta coded frames with keyframes at 0, 5, 10 and 15. Each frame
+// is filled with its number, which is also its "frame" property. Returns
+// the time just before writing frame mark.
+int64_t RecordDeltaLog(const std::string& filename, size_t mark)
+{
+    int64_t mark_us = 0;
+    VideoOutput video("pango:[codec=delta,keyframe=5]//" + filename);
+    std::vector<StreamInfo> streams(1, StreamInfo(VideoFormatFromString("GRAY8"), 16, 8, 16, 0));
+    video.SetStreams(streams);
+
+    std::vector<unsigned char> frame(16*8);
+    for(size_t i=0; i < num_frames; ++i) {
+        if(i == mark) mark_us = PlaybackTime_us();
+        std::fill(frame.begin(), frame.end(), (unsigned char)i);
+        json::value properties(json::object_type, false);
+        properties["frame"] = (int64_t)i;
+        video.WriteStreams(&frame[0], properties);
+        boostd::this_thread::sleep_for(boostd::chrono::milliseconds(10));
+    }
+    return mark_us;
+}
+
+void PangoMerge(const std::string& options, const std::string& out, const std::string& in)
+{
+    const std::string cmd = PangoMergeExecutable() + " " + options + " -o " + out + " " + in;
+    PANGOLIN_CHECK_EQUAL(std::system(cmd.c_str()), 0);
+}
+
+// Play back log, checking each frame has its own properties, including
+// once playback has ended. Returns numbers of frames played.
+std::vector<int> PlayDeltaLog(const std::string& filename)
+{
+    boostd::shared_ptr<VideoInterface> video(OpenVideo("pango://" + filename));
+    VideoPropertiesInterface* props = dynamic_cast<VideoPropertiesInterface*>(video.get());
+    PANGOLIN_CHECK(props);
+
+    std::vector<unsigned char> image(video->SizeBytes());
+    std::vector<int> frames;
+    while(video->GrabNext(&image[0], true)) {
+        PANGOLIN_CHECK_EQUAL(image[0], image.back());
+        PANGOLIN_CHECK_EQUAL(props->FrameProperties()["frame"].get<int64_t>(), (int64_t)image[0]);
+        frames.push_back(image[0]);
+    }
+    if(!frames.empty()) {
+        PANGOLIN_CHECK_EQUAL(props->FrameProperties()["frame"].get<int64_t>(), (int64_t)frames.back());
+    }
+    return frames;
+}
+
+PANGOLIN_TEST(pango_merge_delta_start)
+{
+    TestTempFile in("delta.pango");
+    TestTempFile out("delta_cut.pango");
+
+    // Encoded frames are written by the following call, so frames from
+    // 6 or 7 onwards are stamped after start, all up to 10 being deltas.
+    const int64_t start_us = RecordDeltaLog(in.filename, 8);
+    PangoMerge("-start " + Convert<std::string,int64_t>::Do(start_us), out.filename, in.filename);
+
+    // Playback must begin from the next keyframe
+    const std::vector<int> frames = PlayDeltaLog(out.filename);
+    PANGOLIN_CHECK_EQUAL(frames.size(), num_frames - 10);
+    for(size_t i=0; i < frames.size(); ++i) {
+        PANGOLIN_CHECK_EQUAL(frames[i], (int)(10 + i));
+    }
+}
+
+PANGOLIN_TEST(pango_merge_end_drops_meta)
+{
+    TestTempFile in("delta.pango");
+    TestTempFile out("delta_cut.pango");
+
+    // Properties of frames cut by -end mustn't follow the last frame kept
+    const int64_t end_us = RecordDeltaLog(in.filename, 12);
+    PangoMerge("-end " + Convert<std::string,int64_t>::Do(end_us), out.filename, in.filename);
+
+    const std::vector<int> frames = PlayDeltaLog(out.filename);
+    PANGOLIN_CHECK(!frames.empty() && frames.size() < num_frames);
+    for(size_t i=0; i < frames.size(); ++i) {
+        PANGOLIN_CHECK_EQUAL(frames[i], (int)i);
+    }
+}
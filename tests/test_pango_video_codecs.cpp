@@ -0,0 +1,149 @@
+#include "test.h"
+
+#include <pangolin/video/video.h>
+#include <pangolin/video/video_output.h>
+#include <pangolin/compat/memory.h>
+
+#include <cstdlib>
+#include <cstring>
+
+using namespace pangolin;
+
+typedef std::vector<unsigned char> Frame;
+
+// Write frames of a single w x h stream in fmt with codec, and read them back.
+// options are appended to the codec's output parameters, e.g. ",keyframe=5".
+std::vector<Frame> RoundTrip(const std::string& codec, const std::string& fmt, size_t w, size_t h, const std::vector<Frame>& frames, const std::string& options = "")
+{
+    TestTempFile file("codec_" + codec + ".pango");
+    const VideoPixelFormat pix = VideoFormatFromString(fmt);
+    const size_t pitch = w * pix.bpp / 8;
+    {
+        VideoOutput video("pango:[codec=" + codec + options + "]//" + file.filename);
+        std::vector<StreamInfo> streams(1, StreamInfo(pix, w, h, pitch, 0));
+        video.SetStreams(streams);
+        for(size_t i=0; i < frames.size(); ++i) {
+            video.WriteStreams(const_cast<unsigned char*>(&frames[i][0]));
+        }
+    }
+
+    boostd::shared_ptr<VideoInterface> video(OpenVideo("pango://" + file.filename));
+    PANGOLIN_CHECK_EQUAL(video->SizeBytes(), h * pitch);
+    std::vector<Frame> played;
+    Frame image(video->SizeBytes());
+    while(video->GrabNext(&image[0], true)) {
+        played.push_back(image);
+    }
+    return played;
+}
+
+void CheckLossless(const std::string& codec, const std::string& fmt, size_t w, size_t h, const std::vector<Frame>& frames, const std::string& options = "")
+{
+    const std::vector<Frame> played = RoundTrip(codec, fmt, w, h, frames, options);
+    PANGOLIN_CHECK_EQUAL(played.size(), frames.size());
+    for(size_t i=0; i < frames.size(); ++i) {
+        PANGOLIN_CHECK(played[i] == frames[i]);
+    }
+}
+
+// Depth-like frames: smooth surfaces with noise, invalid (zero) regions
+// and the occasional large discontinuity
+std::vector<Frame> DepthFrames(size_t w, size_t h, size_t n)
+{
+    std::vector<Frame> frames(n, Frame(w*h*sizeof(uint16_t)));
+    unsigned int seed = 1;
+    for(size_t f=0; f < n; ++f) {
+        uint16_t* d = (uint16_t*)&frames[f][0];
+        for(size_t y=0; y < h; ++y) {
+            for(size_t x=0; x < w; ++x) {
+                seed = seed * 1103515245u + 12345u;
+                const int noise = (int)((seed >> 16) % 7) - 3;
+                uint16_t v = (uint16_t)(1000 + 4*x + 2*y + 10*f + noise);
+                if(x < 5 || (y > h/2 && x > w/2)) v = 0;
+                if(x == w/3) v = 65535;
+                d[y*w + x] = v;
+            }
+        }
+    }
+    return frames;
+}
+
+PANGOLIN_TEST(pango_codec_depth)
+{
+    // Odd sizes exercise partial blocks and bands
+    CheckLossless("depth", "GRAY16LE", 64, 48, DepthFrames(64, 48, 4));
+    CheckLossless("depth", "GRAY16LE", 37, 70, DepthFrames(37, 70, 3));
+}
+
+// Smooth gradient frames of n channels, bytes_per_channel each
+std::vector<Frame> GradientFrames(size_t w, size_t h, size_t channels, size_t bytes_per_channel, size_t n)
+{
+    std::vector<Frame> frames(n, Frame(w*h*channels*bytes_per_channel));
+    for(size_t f=0; f < n; ++f) {
+        for(size_t y=0; y < h; ++y) {
+            for(size_t x=0; x < w; ++x) {
+                for(size_t c=0; c < channels; ++c) {
+                    const size_t i = (y*w + x)*channels + c;
+                    const unsigned int v = (unsigned int)(2*x + y + 40*c + 8*f);
+                    if(bytes_per_channel == 2) {
+                        ((uint16_t*)&frames[f][0])[i] = (uint16_t)(v * 97);
+                    }else{
+                        frames[f][i] = (unsigned char)v;
+                    }
+                }
+            }
+        }
+    }
+    return frames;
+}
+
+PANGOLIN_TEST(pango_codec_png)
+{
+#ifdef HAVE_PNG
+    CheckLossless("png", "GRAY8", 64, 48, GradientFrames(64, 48, 1, 1, 3));
+    CheckLossless("png", "RGB24", 33, 20, GradientFrames(33, 20, 3, 1, 3));
+    CheckLossless("png", "GRAY16LE", 64, 48, GradientFrames(64, 48, 1, 2, 3));
+#endif
+}
+
+PANGOLIN_TEST(pango_codec_jpeg)
+{
+#ifdef HAVE_JPEG
+    const size_t w = 64, h = 48;
+    const std::vector<Frame> frames = GradientFrames(w, h, 3, 1, 3);
+    const std::vector<Frame> played = RoundTrip("jpeg", "RGB24", w, h, frames);
+    PANGOLIN_CHECK_EQUAL(played.size(), frames.size());
+    for(size_t i=0; i < frames.size(); ++i) {
+        // Lossy, but close for smooth images at the default quality
+        double error = 0;
+        for(size_t p=0; p < frames[i].size(); ++p) {
+            error += std::abs((int)played[i][p] - (int)frames[i][p]);
+        }
+        PANGOLIN_CHECK(error / frames[i].size() < 2.0);
+    }
+#endif
+}
+
+// Slowly changing frames: a small square moves over a fixed background,
+// with a repeated frame and a frame which changes everywhere
+std::vector<Frame> MovingSquareFrames(size_t w, size_t h, size_t bytes_per_pixel, size_t n)
+{
+    std::vector<Frame> frames(n, GradientFrames(w, h, bytes_per_pixel, 1, 1)[0]);
+    for(size_t f=0; f < n; ++f) {
+        const size_t x0 = (3*f) % (w-4), y0 = f % (h-4);
+        for(size_t y=y0; y < y0+4; ++y) {
+            std::memset(&frames[f][(y*w + x0)*bytes_per_pixel], 255, 4*bytes_per_pixel);
+        }
+    }
+    frames[n/2] = frames[n/2 - 1];
+    for(size_t i=0; i < frames[n-2].size(); ++i) {
+        frames[n-2][i] ^= 0x5a;
+    }
+    return frames;
+}
+
+PANGOLIN_TEST(pango_codec_delta)
+{
+    CheckLossless("delta", "GRAY8", 64, 48, MovingSquareFrames(64, 48, 1, 12), ",keyframe=5");
+    CheckLossless("delta", "RGB24", 37, 21, MovingSquareFrames(37, 21, 3, 12), ",keyframe=0");
+}
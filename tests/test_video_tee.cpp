@@ -0,0 +1,46 @@
+#include "test.h"
+
+#include <pangolin/video/video_tee.h>
+#include <pangolin/compat/thread.h>
+
+using namespace pangolin;
+
+// Grabs from a consumer until it reports no more frames
+struct TeeConsumerGrabber
+{
+    VideoTeeConsumer* consumer;
+    size_t* frames;
+
+    void operator()()
+    {
+        std::vector<unsigned char> image(consumer->SizeBytes());
+        while(consumer->GrabNext(&image[0], true)) {
+            ++*frames;
+        }
+    }
+};
+
+PANGOLIN_TEST(video_tee_stop_closes_consumers)
+{
+    // Slow source, so that the consumer is waiting for a frame when stopped
+    VideoTee* tee = new VideoTee(OpenVideo("test:[size=64x48,fps=20]//"));
+    VideoTeeConsumer* consumer = tee->AddConsumer(2, VideoTeeBlock);
+
+    size_t frames = 0;
+    TeeConsumerGrabber grabber;
+    grabber.consumer = consumer;
+    grabber.frames = &frames;
+
+    tee->Start();
+    boostd::thread thread(grabber);
+    boostd::this_thread::sleep_for(boostd::chrono::milliseconds(200));
+    tee->Stop();
+    thread.join();
+    PANGOLIN_CHECK(frames > 0);
+
+    // Consumers may outlive the tee
+    delete tee;
+    std::vector<unsigned char> image(consumer->SizeBytes());
+    PANGOLIN_CHECK(!consumer->GrabNext(&image[0], true));
+    delete consumer;
+}
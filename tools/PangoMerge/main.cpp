@@ -0,0 +1,623 @@
+#include <pangolin/platform.h>
+#include <pangolin/log/packetstream.h>
+#include <pangolin/utils/threadedfilebuf.h>
+#include <pangolin/utils/timer.h>
+#include <pangolin/utils/type_convert.h>
+#include <pangolin/utils/picojson.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <queue>
+#include <set>
+#include <stdexcept>
+#include <time.h>
+
+using namespace pangolin;
+
+// Bytes copied per read when streaming packet payloads
+const size_t copy_chunk_bytes = 8 << 20;
+
+// Buffer for parsing tags and headers between payloads
+const size_t input_buffer_bytes = 1 << 20;
+
+// Buffer between merge and the output writer thread
+const unsigned int output_buffer_bytes = 256 << 20;
+
+struct MergeOptions
+{
+    MergeOptions()
+        : start_us(std::numeric_limits<int64_t>::min()),
+          end_us(std::numeric_limits<int64_t>::max())
+    {}
+
+    // Keep source if it matches any of these, or keep all if both empty
+    std::set<std::pair<size_t,size_t> > sources;
+    std::set<std::string> drivers;
+
+    // Keep packets with start_us <= time < end_us, after offset
+    int64_t start_us;
+    int64_t end_us;
+};
+
+// Message preceding a packet, which is copied with it
+struct LogMessage
+{
+    uint32_t tag;
+    size_t src;
+    json::value json;
+};
+
+// Pango video stream codecs which only decode from a preceding keyframe.
+// Their encoded data begins with a uint32 frame type, 0 for keyframes.
+bool InterFrameCodec(const std::string& codec)
+{
+    return codec == "delta";
+}
+
+// Pango video stream codecs whose frames decode independently
+bool IntraFrameCodec(const std::string& codec)
+{
+    return codec.empty() || codec == "raw" || codec == "depth" || codec == "png" || codec == "jpeg";
+}
+
+// Sequential reader over the messages of one input log, positioned at the
+// payload of its next packet to keep. Payloads are copied, never parsed,
+// other than to find the first keyframe of inter-frame video after a cut.
+class InputLog
+{
+public:
+    InputLog(const std::string& filename, size_t index, int64_t offset_us, const MergeOptions& options)
+        : filename(filename), index(index), offset_us(offset_us), options(options),
+          has_packet(false), packets(0), bytes(0), buffer(input_buffer_bytes)
+    {
+        in.rdbuf()->pubsetbuf(&buffer[0], buffer.size());
+        in.open(filename.c_str(), std::ios::in | std::ios::binary);
+        if(!in.good()) {
+            throw std::runtime_error("Unable to open file '" + filename + "'.");
+        }
+
+        std::vector<char> magic(PANGO_MAGIC.size());
+        in.read(&magic[0], magic.size());
+        if(!in.good() || std::string(magic.begin(), magic.end()) != PANGO_MAGIC) {
+            throw std::runtime_error("'" + filename + "' is not a pango log.");
+        }
+    }
+
+    //! Read up to the payload of the next packet to keep, queueing any
+    //! messages before it. Returns false at end of log.
+    bool Next()
+    {
+        has_packet = false;
+        uint32_t tag = 0;
+        while(ReadTag(tag)) {
+            switch(tag) {
+            case TAG_PANGO_HDR:
+            case TAG_PANGO_STATS:
+                ReadJson(true);
+                break;
+            case TAG_PANGO_SYNC:
+                break;
+            case TAG_ADD_SOURCE:
+            {
+                LogMessage msg;
+                msg.tag = tag;
+                msg.json = ReadJson(true);
+                msg.src = sources.size();
+                sources.push_back(msg.json);
+                keep.push_back(Keep(msg.src, msg.json["driver"].get<std::string>()));
+                keyframe_streams.push_back(InterFrameStreams(msg.json));
+                await_keyframe.push_back(keep.back() && options.start_us != std::numeric_limits<int64_t>::min() && !keyframe_streams.back().empty());
+                if(keep.back()) messages.push_back(msg);
+                break;
+            }
+            case TAG_SRC_JSON:
+            {
+                LogMessage msg;
+                msg.tag = tag;
+                msg.src = ReadSourceId();
+                msg.json = ReadJson(false);
+                if(keep[msg.src]) messages.push_back(msg);
+                break;
+            }
+            case TAG_SRC_PACKET:
+            {
+                in.read((char*)&time_us, sizeof(int64_t));
+                time_us += offset_us;
+                src = ReadSourceId();
+                const int64_t fixed_size = sources[src]["packet"]["size_bytes"].get<int64_t>();
+                size = fixed_size > 0 ? (size_t)fixed_size : ReadCompressedUnsignedInt();
+                SkipPadding(Alignment(src));
+
+                if(keep[src] && options.start_us <= time_us && time_us < options.end_us) {
+                    // Frames before the first keyframe after a cut can't be decoded
+                    if(await_keyframe[src]) {
+                        await_keyframe[src] = !IsKeyframe(src);
+                    }
+                    if(!await_keyframe[src]) {
+                        has_packet = true;
+                        return true;
+                    }
+                }
+                DropMeta(src);
+                in.seekg(size, std::ios::cur);
+                break;
+            }
+            default:
+                throw std::runtime_error("Unknown packet type in '" + filename + "'.");
+            }
+        }
+        return false;
+    }
+
+    size_t Alignment(size_t s) const
+    {
+        const json::value& packet = sources[s]["packet"];
+        return packet.contains("alignment_bytes") ? (size_t)std::max(packet["alignment_bytes"].get<int64_t>(), (int64_t)1) : 1;
+    }
+
+    //! Copy current packet payload to out
+    void CopyPayload(std::ostream& out, std::vector<char>& chunk)
+    {
+        size_t remaining = size;
+        while(remaining) {
+            const size_t n = std::min(remaining, chunk.size());
+            if(!in.read(&chunk[0], n)) {
+                throw std::runtime_error("Unexpected end of packet data in '" + filename + "'.");
+            }
+            out.write(&chunk[0], n);
+            remaining -= n;
+        }
+        ++packets;
+        bytes += size;
+    }
+
+    std::string filename;
+    size_t index;
+    int64_t offset_us;
+    const MergeOptions& options;
+
+    std::vector<json::value> sources;
+    std::vector<bool> keep;
+
+    // Per source, inter-frame coded pango video streams
+    std::vector<std::vector<size_t> > keyframe_streams;
+
+    // Per source, true whilst skipping to a keyframe after the start cut
+    std::vector<bool> await_keyframe;
+
+    // Messages to copy before current packet
+    std::vector<LogMessage> messages;
+
+    // Current packet
+    bool has_packet;
+    int64_t time_us;
+    size_t src;
+    size_t size;
+
+    size_t packets;
+    size_t bytes;
+
+protected:
+    bool Keep(size_t s, const std::string& driver) const
+    {
+        if(options.sources.empty() && options.drivers.empty()) return true;
+        return options.sources.count(std::make_pair(index, s)) || options.drivers.count(driver);
+    }
+
+    //! Forget meta queued for source s, whose packet is being skipped.
+    //! Any earlier meta of s went with an earlier packet.
+    void DropMeta(size_t s)
+    {
+        std::vector<LogMessage> remaining;
+        for(size_t i=0; i < messages.size(); ++i) {
+            if(messages[i].tag != TAG_SRC_JSON || messages[i].src != s) {
+                remaining.push_back(messages[i]);
+            }
+        }
+        messages.swap(remaining);
+    }
+
+    //! Indices of inter-frame coded streams of a pango video source.
+    //! Throws if a stream's codec is unknown, since we can't tell where
+    //! it may be cut.
+    std::vector<size_t> InterFrameStreams(const json::value& source) const
+    {
+        std::vector<size_t> streams;
+        const json::value& info = source["info"];
+        if(source["driver"].get<std::string>() != "raw_video" || !info.contains("streams")) {
+            return streams;
+        }
+        const json::value& json_streams = info["streams"];
+        for(size_t i=0; i < json_streams.size(); ++i) {
+            const std::string codec = json_streams[i].contains("codec") ? json_streams[i]["codec"].get<std::string>() : "";
+            if(InterFrameCodec(codec)) {
+                streams.push_back(i);
+            }else if(!IntraFrameCodec(codec) && options.start_us != std::numeric_limits<int64_t>::min()) {
+                throw std::runtime_error("Unable to cut '" + filename + "' by time: stream " +
+                    Convert<std::string,size_t>::Do(i) + " has unknown codec '" + codec + "'.");
+            }
+        }
+        return streams;
+    }
+
+    //! True if every inter-frame stream of the current packet, of source s,
+    //! is a keyframe. Leaves the stream at the start of the payload.
+    bool IsKeyframe(size_t s)
+    {
+        // Variable size frames: int64 info[4], uint32 stream_bytes[N], stream data
+        const size_t info_bytes = 4*sizeof(int64_t);
+        const size_t num_streams = sources[s]["info"]["streams"].size();
+        const size_t header_bytes = info_bytes + num_streams*sizeof(uint32_t);
+        if(size < header_bytes) {
+            throw std::runtime_error("Truncated video frame in '" + filename + "'.");
+        }
+
+        const std::streampos payload = in.tellg();
+        std::vector<uint32_t> stream_bytes(num_streams);
+        in.seekg(info_bytes, std::ios::cur);
+        in.read((char*)&stream_bytes[0], num_streams*sizeof(uint32_t));
+
+        bool keyframe = in.good();
+        const std::vector<size_t>& streams = keyframe_streams[s];
+        for(size_t i=0; keyframe && i < streams.size(); ++i) {
+            size_t offset = header_bytes;
+            for(size_t j=0; j < streams[i]; ++j) offset += stream_bytes[j];
+            uint32_t type = 1;
+            if(stream_bytes[streams[i]] >= sizeof(uint32_t) && offset + sizeof(uint32_t) <= size) {
+                in.seekg(payload + (std::streamoff)offset);
+                in.read((char*)&type, sizeof(uint32_t));
+            }
+            keyframe = in.good() && type == 0;
+        }
+
+        if(!in.good()) {
+            throw std::runtime_error("Unexpected end of packet data in '" + filename + "'.");
+        }
+        in.seekg(payload);
+        return keyframe;
+    }
+
+    bool ReadTag(uint32_t& tag)
+    {
+        tag = 0;
+        in.read((char*)&tag, TAG_LENGTH);
+        return in.gcount() == (std::streamsize)TAG_LENGTH && tag != TAG_END;
+    }
+
+    json::value ReadJson(bool newline)
+    {
+        json::value json;
+        const std::string err = json::parse(json, in);
+        if(!err.empty()) {
+            throw std::runtime_error("Unable to parse '" + filename + "': " + err);
+        }
+        if(newline) in.get();
+        return json;
+    }
+
+    size_t ReadCompressedUnsignedInt()
+    {
+        size_t n = 0;
+        size_t shift = 0;
+        size_t v = in.get();
+        while( v & 0x80 ) {
+            n |= (v & 0x7F) << shift;
+            shift += 7;
+            v = in.get();
+        }
+        return n | (v << shift);
+    }
+
+    size_t ReadSourceId()
+    {
+        const size_t s = ReadCompressedUnsignedInt();
+        if(s >= sources.size()) {
+            throw std::runtime_error("Invalid source id in '" + filename + "'.");
+        }
+        return s;
+    }
+
+    void SkipPadding(size_t alignment)
+    {
+        if(alignment > 1) {
+            const std::streamoff pos = in.tellg();
+            in.ignore((alignment - (size_t)pos % alignment) % alignment);
+        }
+    }
+
+    std::ifstream in;
+    std::vector<char> buffer;
+};
+
+// Orders inputs by time of their next packet, then by input index
+struct InputLater
+{
+    bool operator()(const InputLog* a, const InputLog* b) const
+    {
+        return a->time_us > b->time_us || (a->time_us == b->time_us && a->index > b->index);
+    }
+};
+
+class OutputLog
+{
+public:
+    OutputLog(const std::string& filename, const std::vector<std::string>& inputs)
+        : buffer(filename, output_buffer_bytes), out(&buffer), bytes(0)
+    {
+        out.write(PANGO_MAGIC.c_str(), PANGO_MAGIC.size());
+
+        time_t time_now = time(0);
+        char date[80];
+        strftime(date, sizeof(date), "%Y-%m-%d %X", localtime(&time_now));
+
+        json::value header;
+        header["pangolin_version"] = PANGOLIN_VERSION_STRING;
+        header["time_us"] = (int64_t)0;
+        header["date_created"] = std::string(date);
+        header["endian"] = "little_endian";
+        json::value& merged = header["merged_from"];
+        for(size_t i=0; i < inputs.size(); ++i) {
+            merged.push_back(inputs[i]);
+        }
+        WriteTag(TAG_PANGO_HDR);
+        header.serialize(std::ostream_iterator<char>(out), true);
+    }
+
+    ~OutputLog()
+    {
+        json::value stats;
+        stats["num_sources"] = alignment.size();
+        stats["bytes_written"] = bytes;
+        WriteTag(TAG_PANGO_STATS);
+        stats.serialize(std::ostream_iterator<char>(out), true);
+    }
+
+    //! Write messages queued before log's current packet, or only the
+    //! sources amongst them.
+    void WriteMessages(InputLog& log, bool sources_only = false)
+    {
+        std::vector<LogMessage> remaining;
+        for(size_t i=0; i < log.messages.size(); ++i) {
+            LogMessage& msg = log.messages[i];
+            if(sources_only && msg.tag != TAG_ADD_SOURCE) {
+                remaining.push_back(msg);
+            }else if(msg.tag == TAG_ADD_SOURCE) {
+                // Ids follow order of appearance in output
+                remap[std::make_pair(log.index, msg.src)] = alignment.size();
+                msg.json["id"] = (int64_t)alignment.size();
+                alignment.push_back(log.Alignment(msg.src));
+                WriteTag(TAG_ADD_SOURCE);
+                msg.json.serialize(std::ostream_iterator<char>(out), true);
+            }else{
+                WriteTag(TAG_SRC_JSON);
+                WriteCompressedUnsignedInt(remap[std::make_pair(log.index, msg.src)]);
+                msg.json.serialize(std::ostream_iterator<char>(out), false);
+            }
+        }
+        log.messages.swap(remaining);
+    }
+
+    void WritePacket(InputLog& log, std::vector<char>& chunk)
+    {
+        WriteMessages(log);
+
+        const size_t id = remap[std::make_pair(log.index, log.src)];
+        WriteTag(TAG_SRC_PACKET);
+        out.write((const char*)&log.time_us, sizeof(int64_t));
+        WriteCompressedUnsignedInt(id);
+        if(log.sources[log.src]["packet"]["size_bytes"].get<int64_t>() == 0) {
+            WriteCompressedUnsignedInt(log.size);
+        }
+        WritePadding(alignment[id]);
+        log.CopyPayload(out, chunk);
+        if(out.bad()) {
+            throw std::runtime_error("Error writing data.");
+        }
+        bytes += log.size;
+    }
+
+protected:
+    void WriteTag(uint32_t tag)
+    {
+        out.write((const char*)&tag, TAG_LENGTH);
+    }
+
+    void WriteCompressedUnsignedInt(size_t n)
+    {
+        while(n >= 0x80) {
+            out.put( 0x80 | (n & 0x7F) );
+            n >>= 7;
+        }
+        out.put( (unsigned char)n );
+    }
+
+    void WritePadding(size_t alignment_bytes)
+    {
+        if(alignment_bytes > 1) {
+            const size_t pos = (size_t)out.tellp();
+            const size_t pad = (alignment_bytes - pos % alignment_bytes) % alignment_bytes;
+            for(size_t i=0; i < pad; ++i) out.put(0);
+        }
+    }
+
+    threadedfilebuf buffer;
+    std::ostream out;
+    std::map<std::pair<size_t,size_t>, size_t> remap;
+    std::vector<size_t> alignment;
+    size_t bytes;
+};
+
+void ListSources(const std::vector<std::string>& inputs)
+{
+    MergeOptions options;
+    for(size_t i=0; i < inputs.size(); ++i) {
+        InputLog log(inputs[i], i, 0, options);
+        log.Next();
+        std::cout << i << ": " << inputs[i] << std::endl;
+        for(size_t s=0; s < log.sources.size(); ++s) {
+            std::cout << "\t" << i << ":" << s << " " << log.sources[s]["driver"].get<std::string>()
+                      << " " << log.sources[s]["uri"].get<std::string>() << std::endl;
+        }
+        if(log.has_packet) {
+            std::cout << "\tfirst packet at " << log.time_us << "us" << std::endl;
+        }
+    }
+}
+
+int PangoMerge(const std::string& output, const std::vector<std::string>& inputs, const std::vector<int64_t>& offsets_us, const MergeOptions& options)
+{
+    std::vector<InputLog*> logs;
+    for(size_t i=0; i < inputs.size(); ++i) {
+        logs.push_back(new InputLog(inputs[i], i, offsets_us[i], options));
+    }
+
+    const basetime start = TimeNow();
+    size_t packets = 0;
+    size_t bytes = 0;
+
+    try {
+        OutputLog out(output, inputs);
+        std::vector<char> chunk(copy_chunk_bytes);
+
+        // Write sources from the start of every log before anything else,
+        // so that readers find them all on open.
+        std::priority_queue<InputLog*, std::vector<InputLog*>, InputLater> heap;
+        for(size_t i=0; i < logs.size(); ++i) {
+            if(logs[i]->Next()) {
+                heap.push(logs[i]);
+            }
+            out.WriteMessages(*logs[i], true);
+        }
+
+        // k-way merge by packet time
+        while(!heap.empty()) {
+            InputLog* log = heap.top();
+            heap.pop();
+            out.WritePacket(*log, chunk);
+            if(log->Next()) {
+                heap.push(log);
+            }
+        }
+
+        for(size_t i=0; i < logs.size(); ++i) {
+            out.WriteMessages(*logs[i]);
+            packets += logs[i]->packets;
+            bytes += logs[i]->bytes;
+        }
+    }catch(...) {
+        for(size_t i=0; i < logs.size(); ++i) delete logs[i];
+        throw;
+    }
+
+    const double seconds = TimeDiff_s(start, TimeNow());
+    for(size_t i=0; i < logs.size(); ++i) {
+        std::cout << logs[i]->filename << ": " << logs[i]->packets << " packets" << std::endl;
+        delete logs[i];
+    }
+    std::cout << "Wrote " << packets << " packets, " << bytes / (1024*1024) << " MiB to " << output
+              << " in " << seconds << "s (" << (seconds > 0 ? bytes / seconds / (1024*1024) : 0) << " MiB/s)" << std::endl;
+    return 0;
+}
+
+bool ParsePair(const std::string& s, size_t& a, int64_t& b)
+{
+    const size_t colon = s.find(':');
+    if(colon == std::string::npos) return false;
+    a = std::strtoul(s.substr(0, colon).c_str(), 0, 10);
+    b = std::strtoll(s.substr(colon+1).c_str(), 0, 10);
+    return true;
+}
+
+void PrintUsage()
+{
+    std::cout << "Usage  : PangoMerge [options] -o output.pango input.pango [input.pango ...]" << std::endl << std::endl;
+    std::cout << "Merges pango logs into one, ordered by packet timestamp." << std::endl << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "\t-o FILE      : output log" << std::endl;
+    std::cout << "\t-list        : list sources of each input and exit" << std::endl;
+    std::cout << "\t-s I:S       : keep source S of input I (repeatable)" << std::endl;
+    std::cout << "\t-d DRIVER    : keep sources with driver DRIVER (repeatable)" << std::endl;
+    std::cout << "\t-offset I:US : add US microseconds to timestamps of input I" << std::endl;
+    std::cout << "\t-start US    : drop packets before time US, and inter-frame coded" << std::endl;
+    std::cout << "\t              video up to its next keyframe" << std::endl;
+    std::cout << "\t-end US      : drop packets at or after time US" << std::endl << std::endl;
+    std::cout << "All sources are kept if neither -s nor -d is given." << std::endl << std::endl;
+    std::cout << "e.g." << std::endl;
+    std::cout << "\tPangoMerge -o all.pango left.pango right.pango imu.pango" << std::endl;
+    std::cout << "\tPangoMerge -d raw_video -offset 1:-1500 -o video.pango a.pango b.pango" << std::endl;
+}
+
+int main( int argc, char* argv[] )
+{
+    MergeOptions options;
+    std::string output;
+    bool list = false;
+    std::vector<std::string> inputs;
+    std::vector<std::pair<size_t,int64_t> > offsets;
+
+    for(int i=1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        size_t a;
+        int64_t b;
+        if(arg == "-o" && i+1 < argc) {
+            output = argv[++i];
+        }else if(arg == "-s" && i+1 < argc && ParsePair(argv[i+1], a, b)) {
+            options.sources.insert(std::make_pair(a, (size_t)b));
+            ++i;
+        }else if(arg == "-d" && i+1 < argc) {
+            options.drivers.insert(argv[++i]);
+        }else if(arg == "-offset" && i+1 < argc && ParsePair(argv[i+1], a, b)) {
+            offsets.push_back(std::make_pair(a, b));
+            ++i;
+        }else if(arg == "-start" && i+1 < argc) {
+            options.start_us = std::strtoll(argv[++i], 0, 10);
+        }else if(arg == "-end" && i+1 < argc) {
+            options.end_us = std::strtoll(argv[++i], 0, 10);
+        }else if(arg == "-list") {
+            list = true;
+        }else if(arg == "-h" || arg == "--help") {
+            PrintUsage();
+            return 0;
+        }else if(!arg.empty() && arg[0] == '-') {
+            PrintUsage();
+            return -1;
+        }else{
+            inputs.push_back(arg);
+        }
+    }
+
+    if(inputs.empty() || (!list && output.empty())) {
+        PrintUsage();
+        return -1;
+    }
+
+    std::vector<int64_t> offsets_us(inputs.size(), 0);
+    for(size_t i=0; i < offsets.size(); ++i) {
+        if(offsets[i].first >= inputs.size()) {
+            std::cerr << "No input " << offsets[i].first << " to offset." << std::endl;
+            return -1;
+        }
+        offsets_us[offsets[i].first] = offsets[i].second;
+    }
+
+    if(std::find(inputs.begin(), inputs.end(), output) != inputs.end()) {
+        std::cerr << "Output must not be one of the inputs." << std::endl;
+        return -1;
+    }
+
+    try{
+        if(list) {
+            ListSources(inputs);
+            return 0;
+        }
+        return PangoMerge(output, inputs, offsets_us, options);
+    }catch(const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
+}
@@ -0,0 +1,247 @@
+#include <pangolin/platform.h>
+#include <pangolin/video/video.h>
+#include <pangolin/video/video_output.h>
+#include <pangolin/utils/timer.h>
+#include <pangolin/utils/picojson.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+#ifdef _UNIX_
+#include <time.h>
+#endif
+
+// CPU time consumed by calling thread, in microseconds
+int64_t ThreadCpuTime_us()
+{
+#if defined(_UNIX_) && defined(CLOCK_THREAD_CPUTIME_ID)
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#else
+    return (int64_t)( (1E6 * std::clock()) / CLOCKS_PER_SEC );
+#endif
+}
+
+// CPU time consumed by all threads of process, in microseconds
+int64_t ProcessCpuTime_us()
+{
+    return (int64_t)( (1E6 * std::clock()) / CLOCKS_PER_SEC );
+}
+
+struct Stage
+{
+    Stage() : cpu_us(0) {}
+
+    void Add(int64_t wall, int64_t cpu) {
+        wall_us.push_back(wall);
+        cpu_us += cpu;
+    }
+
+    std::vector<int64_t> wall_us;
+    int64_t cpu_us;
+};
+
+// Nearest-rank percentile of sorted samples
+int64_t Percentile(const std::vector<int64_t>& sorted, double p)
+{
+    if(sorted.empty()) return 0;
+    const size_t i = std::min(sorted.size() - 1, (size_t)(p / 100.0 * sorted.size()));
+    return sorted[i];
+}
+
+pangolin::json::value Summary(std::vector<int64_t> samples_us)
+{
+    std::sort(samples_us.begin(), samples_us.end());
+
+    pangolin::json::value json(pangolin::json::object_type, false);
+    json["p50_us"] = Percentile(samples_us, 50);
+    json["p90_us"] = Percentile(samples_us, 90);
+    json["p99_us"] = Percentile(samples_us, 99);
+    json["max_us"] = samples_us.empty() ? (int64_t)0 : samples_us.back();
+    return json;
+}
+
+pangolin::json::value Summary(const Stage& stage, size_t frames)
+{
+    pangolin::json::value json = Summary(stage.wall_us);
+    json["cpu_us"] = stage.cpu_us;
+    json["cpu_us_per_frame"] = frames ? (double)stage.cpu_us / frames : 0.0;
+    return json;
+}
+
+void PrintSummary(const std::string& name, const pangolin::json::value& s)
+{
+    std::cout << std::setw(10) << name << ": "
+              << "p50 " << s["p50_us"].get<int64_t>() << "us, "
+              << "p90 " << s["p90_us"].get<int64_t>() << "us, "
+              << "p99 " << s["p99_us"].get<int64_t>() << "us, "
+              << "max " << s["max_us"].get<int64_t>() << "us";
+    if(s.contains("cpu_us_per_frame")) {
+        std::cout << ", cpu " << s["cpu_us_per_frame"].get<double>() << "us/frame";
+    }
+    std::cout << std::endl;
+}
+
+int VideoBench(const std::string& input_uri, const std::string& output_uri, size_t max_frames, double max_seconds, bool newest, bool print_json)
+{
+    pangolin::VideoInput video(input_uri);
+    pangolin::VideoOutput output;
+
+    if(!output_uri.empty()) {
+        output.Open(output_uri);
+        output.SetStreams(video.Streams(), input_uri);
+    }
+
+    std::vector<unsigned char> buffer(video.SizeBytes());
+
+    Stage grab, write;
+    std::vector<int64_t> latency_us;
+    size_t frames = 0;
+    size_t failed = 0;
+
+    video.Start();
+
+    const int64_t cpu_start = ProcessCpuTime_us();
+    const pangolin::basetime start = pangolin::TimeNow();
+    int64_t elapsed_us = 0;
+
+    while(frames < max_frames && elapsed_us < max_seconds * 1E6) {
+        int64_t t0 = pangolin::Time_us(pangolin::TimeNow());
+        int64_t c0 = ThreadCpuTime_us();
+
+        const bool got = newest ? video.GrabNewest(&buffer[0], true) : video.GrabNext(&buffer[0], true);
+
+        int64_t t1 = pangolin::Time_us(pangolin::TimeNow());
+        int64_t c1 = ThreadCpuTime_us();
+        elapsed_us = pangolin::TimeDiff_us(start, pangolin::TimeNow());
+
+        if(!got) {
+            // Finite sources signal their end by failing repeatedly
+            if(++failed > 100) break;
+            continue;
+        }
+        failed = 0;
+        grab.Add(t1 - t0, c1 - c0);
+
+        if(output.IsOpen()) {
+            output.WriteStreams(&buffer[0], pangolin::json::value(), video.FrameInfo());
+            const int64_t t2 = pangolin::Time_us(pangolin::TimeNow());
+            write.Add(t2 - t1, ThreadCpuTime_us() - c1);
+            t1 = t2;
+        }
+
+        // Time from requesting frame to it having passed through pipeline.
+        // FrameInfo().host_time_us isn't used, since it is the recorded time
+        // for log playback, and unset by some drivers.
+        latency_us.push_back(t1 - t0);
+        ++frames;
+    }
+
+    video.Stop();
+    output.Close();
+
+    // Includes background threads, such as those of asynchronous writers
+    const int64_t cpu_total_us = ProcessCpuTime_us() - cpu_start;
+    elapsed_us = pangolin::TimeDiff_us(start, pangolin::TimeNow());
+    const double seconds = elapsed_us / 1E6;
+
+    pangolin::json::value json(pangolin::json::object_type, false);
+    json["input"] = input_uri;
+    json["output"] = output_uri;
+    json["frame_bytes"] = video.SizeBytes();
+    json["frames"] = frames;
+    json["seconds"] = seconds;
+    json["fps"] = seconds > 0 ? frames / seconds : 0.0;
+    json["mb_per_s"] = seconds > 0 ? frames * (double)video.SizeBytes() / seconds / 1E6 : 0.0;
+    json["dropped"] = video.FrameInfo().dropped;
+    json["latency"] = Summary(latency_us);
+    json["stages"]["grab"] = Summary(grab, frames);
+    if(!output_uri.empty()) {
+        json["stages"]["write"] = Summary(write, frames);
+    }
+    json["cpu_total_us"] = cpu_total_us;
+    json["cpu_utilisation"] = elapsed_us > 0 ? (double)cpu_total_us / elapsed_us : 0.0;
+
+    if(print_json) {
+        std::cout << json.serialize(true) << std::endl;
+    }else{
+        std::cout << "Input      : " << input_uri << std::endl;
+        if(!output_uri.empty()) {
+            std::cout << "Output     : " << output_uri << std::endl;
+        }
+        std::cout << "Frames     : " << frames << " in " << seconds << "s" << std::endl;
+        std::cout << "Throughput : " << json["fps"].get<double>() << " fps, " << json["mb_per_s"].get<double>() << " MB/s" << std::endl;
+        std::cout << "Dropped    : " << json["dropped"].get<int64_t>() << std::endl;
+        std::cout << "CPU        : " << cpu_total_us / 1E6 << "s (" << 100.0 * json["cpu_utilisation"].get<double>() << "% of one core)" << std::endl;
+        PrintSummary("latency", json["latency"]);
+        PrintSummary("grab", json["stages"]["grab"]);
+        if(json["stages"].contains("write")) {
+            PrintSummary("write", json["stages"]["write"]);
+        }
+    }
+
+    return 0;
+}
+
+void PrintUsage()
+{
+    std::cout << "Usage  : VideoBench [options] input-uri [output-uri]" << std::endl << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "\t-n N    : stop after N frames (default 1000)" << std::endl;
+    std::cout << "\t-t T    : stop after T seconds" << std::endl;
+    std::cout << "\t-newest : use GrabNewest instead of GrabNext" << std::endl;
+    std::cout << "\t-json   : print results as JSON" << std::endl << std::endl;
+    std::cout << "e.g." << std::endl;
+    std::cout << "\tVideoBench -n 500 test:[size=1280x1024,pattern=gradient]//" << std::endl;
+    std::cout << "\tVideoBench -t 10 -json v4l:///dev/video0 pango://bench.pango" << std::endl;
+}
+
+int main( int argc, char* argv[] )
+{
+    size_t max_frames = 0;
+    double max_seconds = 0.0;
+    bool newest = false;
+    bool print_json = false;
+    std::vector<std::string> uris;
+
+    for(int i=1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if(arg == "-n" && i+1 < argc) {
+            max_frames = std::strtoul(argv[++i], 0, 10);
+        }else if(arg == "-t" && i+1 < argc) {
+            max_seconds = std::atof(argv[++i]);
+        }else if(arg == "-newest") {
+            newest = true;
+        }else if(arg == "-json") {
+            print_json = true;
+        }else if(arg == "-h" || arg == "--help") {
+            PrintUsage();
+            return 0;
+        }else{
+            uris.push_back(arg);
+        }
+    }
+
+    if(uris.empty() || uris.size() > 2) {
+        PrintUsage();
+        return -1;
+    }
+
+    if(max_frames == 0 && max_seconds == 0.0) {
+        max_frames = 1000;
+    }
+    if(max_frames == 0) max_frames = std::numeric_limits<size_t>::max();
+    if(max_seconds == 0.0) max_seconds = std::numeric_limits<double>::max();
+
+    try{
+        return VideoBench(uris[0], uris.size() > 1 ? uris[1] : "", max_frames, max_seconds, newest, print_json);
+    }catch(const pangolin::VideoException& e) {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
+}
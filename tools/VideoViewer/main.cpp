@@ -3,37 +3,31 @@
 #include <pangolin/gl/gltexturecache.h>
 #include <pangolin/gl/glpixformat.h>
 #include <pangolin/handler/handler_image.h>
+#include <pangolin/utils/file_utils.h>
+
+#include <cstring>
+#include <sstream>
 
 template<typename T>
-std::pair<float,float> GetOffsetScale(const pangolin::Image<T>& img, float type_max, float format_max)
+std::pair<float,float> GetOffsetScale(const pangolin::Image<T>& img, const pangolin::ImageRoi& roi, float type_max, float format_max)
 {
-    std::pair<float,float> mm(std::numeric_limits<float>::max(), -std::numeric_limits<float>::max());
-
-    for(size_t y=0; y < img.h; ++y) {
-        T* pix = (T*)((char*)img.ptr + y*img.pitch);
-        for(size_t x=0; x < img.w; ++x) {
-            const T val = *(pix++);
-            if(val != 0) {
-                if(val < mm.first) mm.first = val;
-                if(val > mm.second) mm.second = val;
-            }
-        }
+    // Range of valid (non zero) pixels within roi
+    const pangolin::ImageStats stats = pangolin::GetImageStats(img, roi, true);
+    if(!stats.count || stats.max <= stats.min) {
+        return std::pair<float,float>(0.0f, 1.0f);
     }
 
     const float type_scale = format_max / type_max;
-    const float offset = -type_scale* mm.first;
-    const float scale = type_max / (mm.second - mm.first);
+    const float offset = -type_scale* (float)stats.min;
+    const float scale = type_max / (float)(stats.max - stats.min);
     return std::pair<float,float>(offset, scale);
 }
 
-template<typename T>
-pangolin::Image<T> ImageRoi( pangolin::Image<T> img, const pangolin::XYRangei& roi )
+pangolin::ImageRoi ImageRoi( const pangolin::XYRangei& roi )
 {
-    const int xmin = std::min(roi.x.min,roi.x.max);
-    const int ymin = std::min(roi.y.min,roi.y.max);
-    return pangolin::Image<T>(
-        roi.x.AbsSize(), roi.y.AbsSize(),
-        img.pitch, img.RowPtr(ymin) + xmin
+    return pangolin::ImageRoi(
+        std::min(roi.x.min,roi.x.max), std::min(roi.y.min,roi.y.max),
+        roi.x.AbsSize(), roi.y.AbsSize()
     );
 }
 
@@ -93,24 +87,35 @@ void VideoViewer(const std::string& input_uri, const std::string& output_uri)
     }
 
     std::vector<pangolin::Image<unsigned char> > images;
+    bool auto_scale = false;
 
 #ifdef CALLEE_HAS_CPP11
     const int FRAME_SKIP = 30;
     const char show_hide_keys[]  = {'1','2','3','4','5','6','7','8','9'};
     const char screenshot_keys[] = {'!','"','#','$','%','^','&','*','('};
+    size_t still_count = 0;
 
     // Show/hide streams
     for(size_t v=0; v < container.NumChildren() && v < 9; v++) {
         pangolin::RegisterKeyPressCallback(show_hide_keys[v], [v,&container](){
             container[v].ToggleShow();
         } );
-        pangolin::RegisterKeyPressCallback(screenshot_keys[v], [v,&images,&video](){
+        pangolin::RegisterKeyPressCallback(screenshot_keys[v], [v,&images,&video,&still_count](){
             if(v < images.size() && images[v].ptr) {
-                try{
-                    pangolin::SaveImage(images[v],video.Streams()[v].PixFormat(), "still.png");
-                }catch(std::exception e){
-                    pango_print_error("Unable to save frame: %s\n", e.what());
-                }
+                // Copy frame so that it can be written in the background
+                pangolin::TypedImage still;
+                still.Alloc(images[v].w, images[v].h, video.Streams()[v].PixFormat(), images[v].pitch);
+                std::memcpy(still.ptr, images[v].ptr, images[v].SizeBytes());
+
+                // Number stills, skipping those from earlier sessions
+                std::string filename;
+                do {
+                    std::ostringstream ss;
+                    ss << "still_" << still_count++ << ".png";
+                    filename = ss.str();
+                }while(pangolin::FileExists(filename));
+                pangolin::DefaultImageWriter().Save(still, filename);
+                pango_print_info("Saving %s\n", filename.c_str());
             }
         } );
     }
@@ -120,8 +125,9 @@ void VideoViewer(const std::string& input_uri, const std::string& output_uri)
             video.Record();
             pango_print_info("Started Recording.\n");
         }else{
+            const pangolin::AsyncVideoOutputStats stats = video.RecordStats();
             video.Stop();
-            pango_print_info("Finished recording.\n");
+            pango_print_info("Finished recording (%d frames queued at most, %d dropped).\n", (int)stats.max_queued, (int)stats.dropped);
         }
         fflush(stdout);
     });
@@ -158,8 +164,7 @@ void VideoViewer(const std::string& input_uri, const std::string& output_uri)
         }
     });
 
-    pangolin::RegisterKeyPressCallback('a', [&](){
-        // Adapt scale
+    std::function<void()> adapt_scale = [&](){
         for(unsigned int i=0; i<images.size(); ++i) {
             pangolin::Image<unsigned char>& img = images[i];
             pangolin::ImageViewHandler& ivh = handlers[i];
@@ -173,15 +178,21 @@ void VideoViewer(const std::string& input_uri, const std::string& output_uri)
             if(container[i].HasFocus()) {
                 std::pair<float,float> os(0.0f, 1.0f);
                 if(glfmt[i].gltype == GL_UNSIGNED_BYTE) {
-                    os = GetOffsetScale(ImageRoi(img.Reinterpret<unsigned char>(),iroi), 255.0f, 1.0f);
+                    os = GetOffsetScale(img.Reinterpret<unsigned char>(), ImageRoi(iroi), 255.0f, 1.0f);
                 }else if(glfmt[i].gltype == GL_UNSIGNED_SHORT) {
-                    os = GetOffsetScale(ImageRoi(img.Reinterpret<unsigned short>(),iroi), 65535.0f, 1.0f);
+                    os = GetOffsetScale(img.Reinterpret<unsigned short>(), ImageRoi(iroi), 65535.0f, 1.0f);
                 }else if(glfmt[i].gltype == GL_FLOAT) {
-                    os = GetOffsetScale(ImageRoi(img.Reinterpret<float>(),iroi), 1.0f, 1.0f);
+                    os = GetOffsetScale(img.Reinterpret<float>(), ImageRoi(iroi), 1.0f, 1.0f);
                 }
                 gloffsetscale[i] = os;
             }
         }
+    };
+
+    // Adapt scale once, or continuously every frame
+    pangolin::RegisterKeyPressCallback('a', adapt_scale);
+    pangolin::RegisterKeyPressCallback('A', [&](){
+        auto_scale = !auto_scale;
     });
 #endif
 
@@ -195,6 +206,9 @@ void VideoViewer(const std::string& input_uri, const std::string& output_uri)
         if (frame == 0 || frame < end_frame) {
             if (video.Grab(&buffer[0], images) ){
                 ++frame;
+#ifdef CALLEE_HAS_CPP11
+                if(auto_scale) adapt_scale();
+#endif
             }
         }
 